@@ -5,13 +5,18 @@
 #pragma once
 
 #include <vector>
-#include <queue>
 #include <mutex>
+#include <atomic>
 #include <thread>
 #include <future>
 #include <memory>
 #include <functional>
+#include <condition_variable>
 #include <type_traits>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 
 #if PLATFORM_WINDOWS
 #include <Windows.h>
@@ -19,9 +24,105 @@
 #include <pthread.h>
 #endif
 
+#include <Common/Utility.h>
 #include <Common/String.h>
 #include <Common/Debug.h>
 
+namespace Common::Internal {
+    // move-only void() callable stored inline, used as element of task queues to avoid a std::function allocation per task,
+    // callables larger than capacity are moved to heap and only their pointer is stored inline
+    class InplaceTask {
+    public:
+        static constexpr size_t capacity = 48;
+
+        InplaceTask() = default;
+
+        template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceTask>>>
+        explicit InplaceTask(F&& func)
+        {
+            using Func = std::decay_t<F>;
+            if constexpr (sizeof(Func) <= capacity && alignof(Func) <= alignof(std::max_align_t)) {
+                Emplace<Func>(std::forward<F>(func));
+            } else {
+                Emplace<HeapFunc<Func>>(HeapFunc<Func> { std::make_unique<Func>(std::forward<F>(func)) });
+            }
+        }
+
+        InplaceTask(InplaceTask&& other) noexcept
+        {
+            MoveFrom(other);
+        }
+
+        ~InplaceTask()
+        {
+            Reset();
+        }
+
+        InplaceTask& operator=(InplaceTask&& other) noexcept
+        {
+            if (this != &other) {
+                Reset();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        void operator()()
+        {
+            invoker(storage);
+        }
+
+    private:
+        template <typename Func>
+        struct HeapFunc {
+            std::unique_ptr<Func> func;
+
+            void operator()()
+            {
+                (*func)();
+            }
+        };
+
+        template <typename Func, typename F>
+        void Emplace(F&& func)
+        {
+            new (storage) Func(std::forward<F>(func));
+            invoker = [](void* object) -> void { (*static_cast<Func*>(object))(); };
+            mover = [](void* dst, void* src) -> void {
+                if (dst != nullptr) {
+                    new (dst) Func(std::move(*static_cast<Func*>(src)));
+                }
+                static_cast<Func*>(src)->~Func();
+            };
+        }
+
+        void MoveFrom(InplaceTask& other)
+        {
+            if (other.mover == nullptr) {
+                return;
+            }
+            other.mover(storage, other.storage);
+            invoker = other.invoker;
+            mover = other.mover;
+            other.invoker = nullptr;
+            other.mover = nullptr;
+        }
+
+        void Reset()
+        {
+            if (mover != nullptr) {
+                mover(nullptr, storage);
+                invoker = nullptr;
+                mover = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) std::byte storage[capacity];
+        void(*invoker)(void*) = nullptr;
+        void(*mover)(void*, void*) = nullptr;
+    };
+}
+
 namespace Common {
     class NamedThread {
     public:
@@ -30,8 +131,9 @@ namespace Common {
         template <typename F, typename... Args>
         explicit NamedThread(const std::string& name, F&& task, Args&&... args)
         {
-            thread = std::thread([this, task = std::forward<F>(task), name](Args&&... args) -> void {
-                SetThreadName(name);
+            // the thread names itself, this may already be moved from when it starts running
+            thread = std::thread([task = std::forward<F>(task), name](Args&&... args) -> void {
+                SetCurrentThreadName(name);
                 task(args...);
             }, std::forward<Args>(args)...);
         }
@@ -52,40 +154,107 @@ namespace Common {
         }
 
     private:
-        void SetThreadName(const std::string& name)
+        static void SetCurrentThreadName(const std::string& name)
         {
 #if PLATFORM_WINDOWS
-            SetThreadDescription(thread.native_handle(), Common::StringUtils::ToWideString(name).c_str());
+            SetThreadDescription(GetCurrentThread(), Common::StringUtils::ToWideString(name).c_str());
 #elif PLATFORM_MACOS
             pthread_setname_np(name.c_str());
 #else
-            pthread_setname_np(thread.native_handle(), name.c_str());
+            pthread_setname_np(pthread_self(), name.c_str());
 #endif
         }
 
         std::thread thread;
     };
 
+    // bounded lock-free multi-producer multi-consumer queue, cells are allocated once, so push and pop never allocate
+    template <typename T>
+    class MPMCQueue {
+    public:
+        // capacity is rounded up to power of two
+        explicit MPMCQueue(size_t inCapacity);
+        ~MPMCQueue();
+        NonCopyable(MPMCQueue)
+
+        // returns false if queue is full
+        template <typename... Args>
+        bool TryEmplace(Args&&... args);
+        // returns false if queue is empty
+        bool TryPop(T& outValue);
+        // only a hint under concurrent access
+        bool Empty() const;
+        size_t Capacity() const;
+
+    private:
+        static constexpr size_t cacheLineSize = 64;
+
+        struct alignas(cacheLineSize) Cell {
+            std::atomic<size_t> sequence;
+            alignas(T) std::byte storage[sizeof(T)];
+        };
+
+        size_t mask;
+        std::unique_ptr<Cell[]> cells;
+        alignas(cacheLineSize) std::atomic<size_t> enqueuePos;
+        alignas(cacheLineSize) std::atomic<size_t> dequeuePos;
+    };
+
+    // bounded lock-free single-producer single-consumer ring, head and tail live on separate cache lines and each side caches
+    // the index of the other, so push and pop touch the shared line only when the cached index runs out
+    template <typename T>
+    class SPSCQueue {
+    public:
+        // capacity is rounded up to power of two
+        explicit SPSCQueue(size_t inCapacity);
+        ~SPSCQueue();
+        NonCopyable(SPSCQueue)
+
+        // producer only, wait-free, returns false if queue is full
+        template <typename... Args>
+        bool TryEmplace(Args&&... args);
+        // consumer only, returns false if queue is empty
+        bool TryPop(T& outValue);
+        // consumer only, returns nullptr if queue is empty, the element stays valid until Pop()
+        T* Front();
+        // consumer only, queue must not be empty
+        void Pop();
+        // only a hint under concurrent access
+        bool Empty() const;
+        size_t Capacity() const;
+
+    private:
+        static constexpr size_t cacheLineSize = 64;
+
+        struct Slot {
+            alignas(T) std::byte storage[sizeof(T)];
+        };
+
+        size_t mask;
+        std::unique_ptr<Slot[]> slots;
+        alignas(cacheLineSize) std::atomic<size_t> tail;
+        size_t cachedHead;
+        alignas(cacheLineSize) std::atomic<size_t> head;
+        size_t cachedTail;
+    };
+
     class ThreadPool {
     public:
-        ThreadPool(const std::string& name, uint8_t threadNum) : stop(false)
+        static constexpr size_t defaultQueueCapacity = 1024;
+
+        ThreadPool(const std::string& name, uint8_t threadNum, size_t queueCapacity = defaultQueueCapacity)
+            : stop(false)
+            , sleepingNum(0)
+            , tasks(queueCapacity)
         {
             threads.reserve(threadNum);
             for (auto i = 0; i < threadNum; i++) {
                 std::string fullName = name + "-" + std::to_string(i);
                 threads.emplace_back(NamedThread(fullName, [this]() -> void {
-                    while (true) {
-                        std::function<void()> task;
-                        {
-                            std::unique_lock<std::mutex> lock(mutex);
-                            condition.wait(lock, [this]() -> bool { return stop || !tasks.empty(); });
-                            if (stop && tasks.empty()) {
-                                return;
-                            }
-                            task = std::move(tasks.front());
-                            tasks.pop();
-                        }
+                    Internal::InplaceTask task;
+                    while (WaitTask(task)) {
                         task();
+                        task = Internal::InplaceTask();
                     }
                 }));
             }
@@ -95,7 +264,7 @@ namespace Common {
         {
             {
                 std::unique_lock<std::mutex> lock(mutex);
-                stop = true;
+                stop.store(true);
             }
             condition.notify_all();
             for (auto& thread : threads) {
@@ -106,59 +275,97 @@ namespace Common {
         template <typename F, typename... Args>
         auto EmplaceTask(F&& task, Args&&... args)
         {
+            Assert(!stop.load());
             using RetType = std::invoke_result_t<F, Args...>;
-            auto packagedTask = std::make_shared<std::packaged_task<RetType()>>(std::bind(std::forward<F>(task), std::forward<Args>(args)...));
-            auto result = packagedTask->get_future();
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-                Assert(!stop);
-                tasks.emplace([packagedTask]() -> void { (*packagedTask)(); });
+            std::packaged_task<RetType()> packagedTask(std::bind(std::forward<F>(task), std::forward<Args>(args)...));
+            auto result = packagedTask.get_future();
+
+            Internal::InplaceTask inplaceTask([packagedTask = std::move(packagedTask)]() mutable -> void { packagedTask(); });
+            // queue is bounded, producers back off until workers make room
+            while (!tasks.TryEmplace(std::move(inplaceTask))) {
+                std::this_thread::yield();
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleepingNum.load() > 0) {
+                // lock pairs with the sleeping check of workers, so the notification can not slip in before they wait
+                { std::unique_lock<std::mutex> lock(mutex); }
+                condition.notify_one();
             }
-            condition.notify_one();
             return result;
         }
 
     private:
-        bool stop;
+        static constexpr uint32_t spinCount = 64;
+        static constexpr uint32_t yieldCount = 16;
+
+        // spin, then yield, then park on condition, returns false when pool stopped and all tasks are finished
+        bool WaitTask(Internal::InplaceTask& outTask)
+        {
+            for (uint32_t i = 0; i < spinCount + yieldCount; i++) {
+                if (tasks.TryPop(outTask)) {
+                    return true;
+                }
+                if (i >= spinCount) {
+                    std::this_thread::yield();
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                sleepingNum.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const bool popped = tasks.TryPop(outTask);
+                if (!popped && !stop.load()) {
+                    condition.wait(lock, [this]() -> bool { return stop.load() || !tasks.Empty(); });
+                }
+                sleepingNum.fetch_sub(1);
+
+                if (popped || tasks.TryPop(outTask)) {
+                    return true;
+                }
+                if (stop.load() && tasks.Empty()) {
+                    return false;
+                }
+            }
+        }
+
+        std::atomic<bool> stop;
+        std::atomic<uint32_t> sleepingNum;
         std::mutex mutex;
         std::condition_variable condition;
         std::vector<NamedThread> threads;
-        std::queue<std::function<void()>> tasks;
+        MPMCQueue<Internal::InplaceTask> tasks;
     };
 
+    // worker thread backed by a locked queue, any thread can emplace tasks, the worker takes all queued tasks at once
     class WorkerThread {
     public:
-        explicit WorkerThread(const std::string& name) : stop(false), flush(false)
+        explicit WorkerThread(const std::string& name)
+            : stop(false)
+            , submittedNum(0)
+            , executedNum(0)
         {
             thread = NamedThread(name, [this]() -> void {
+                std::vector<std::function<void()>> tasksToExecute;
                 while (true) {
-                    bool needNotifyMainThread = false;
-                    std::vector<std::function<void()>> tasksToExecute;
                     {
                         std::unique_lock<std::mutex> lock(mutex);
-                        taskCondition.wait(lock, [this]() -> bool { return stop || flush || !tasks.empty(); });
+                        taskCondition.wait(lock, [this]() -> bool { return stop || !tasks.empty(); });
                         if (stop && tasks.empty()) {
                             return;
                         }
-                        if (flush) {
-                            tasksToExecute.reserve(tasks.size());
-                            while (!tasks.empty()) {
-                                tasksToExecute.emplace_back(std::move(tasks.front()));
-                                tasks.pop();
-                            }
-                            flush = false;
-                            needNotifyMainThread = true;
-                        } else {
-                            tasksToExecute.emplace_back(std::move(tasks.front()));
-                            tasks.pop();
-                        }
+                        // swap keeps the capacity of both vectors, so steady state batches do not allocate
+                        tasksToExecute.swap(tasks);
                     }
                     for (auto& task : tasksToExecute) {
                         task();
                     }
-                    if (needNotifyMainThread) {
-                        flushCondition.notify_one();
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        executedNum += tasksToExecute.size();
                     }
+                    tasksToExecute.clear();
+                    flushCondition.notify_all();
                 }
             });
         }
@@ -173,17 +380,12 @@ namespace Common {
             thread.Join();
         }
 
+        // blocks until all tasks emplaced before this call are executed
         void Flush()
         {
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-                flush = true;
-            }
-            taskCondition.notify_one();
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-                flushCondition.wait(lock);
-            }
+            std::unique_lock<std::mutex> lock(mutex);
+            const uint64_t target = submittedNum;
+            flushCondition.wait(lock, [this, target]() -> bool { return executedNum >= target; });
         }
 
         template <typename F, typename... Args>
@@ -195,7 +397,8 @@ namespace Common {
             {
                 std::unique_lock<std::mutex> lock(mutex);
                 Assert(!stop);
-                tasks.emplace([packagedTask]() -> void { (*packagedTask)(); });
+                tasks.emplace_back([packagedTask]() -> void { (*packagedTask)(); });
+                submittedNum++;
             }
             taskCondition.notify_one();
             return result;
@@ -203,11 +406,425 @@ namespace Common {
 
     private:
         bool stop;
-        bool flush;
+        uint64_t submittedNum;
+        uint64_t executedNum;
         std::mutex mutex;
         std::condition_variable taskCondition;
         std::condition_variable flushCondition;
         NamedThread thread;
-        std::queue<std::function<void()>> tasks;
+        std::vector<std::function<void()>> tasks;
     };
+
+    // worker thread backed by a SPSCQueue, used for handing work from one thread (e.g. main thread) to another (e.g. rendering thread).
+    // Submit() and fence apis must only be called from a single producer thread, which is the thread constructing it, submitting from
+    // any other thread terminates in every build config, the producer never takes a lock unless the worker is parked, and only backs
+    // off when the ring is full. EmplaceTask() can be called from any thread, tasks from other threads go through a locked queue
+    class SPSCWorkerThread {
+    public:
+        static constexpr size_t defaultQueueCapacity = 4096;
+
+        explicit SPSCWorkerThread(const std::string& name, size_t queueCapacity = defaultQueueCapacity)
+            : producerThreadId(std::this_thread::get_id())
+            , stop(false)
+            , workerSleeping(false)
+            , fenceWaiterNum(0)
+            , submittedNum(0)
+            , executedNum(0)
+            , foreignSubmittedNum(0)
+            , foreignExecutedNum(0)
+            , tasks(queueCapacity)
+        {
+            thread = NamedThread(name, [this]() -> void {
+                uint64_t executed = 0;
+                while (WaitTask()) {
+                    // executed number is published once per batch instead of once per task
+                    for (uint32_t i = 0; i < batchSize; i++) {
+                        Internal::InplaceTask* task = tasks.Front();
+                        if (task == nullptr) {
+                            break;
+                        }
+                        (*task)();
+                        tasks.Pop();
+                        executed++;
+                    }
+                    PublishExecuted(executed);
+                    ExecuteForeignTasks();
+                }
+            });
+        }
+
+        ~SPSCWorkerThread()
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                stop.store(true);
+            }
+            taskCondition.notify_all();
+            thread.Join();
+        }
+
+        // fire and forget, returns the fence of this task, cheaper than EmplaceTask since no future state is allocated
+        template <typename F>
+        uint64_t Submit(F&& task);
+
+        // any thread, returned future is the only way to wait for a single task emplaced from a thread other than the producer
+        template <typename F, typename... Args>
+        auto EmplaceTask(F&& task, Args&&... args);
+
+        // returns the fence of the last submitted task, e.g. record it at the end of a frame and wait for it frames later
+        uint64_t GetFence() const
+        {
+            return submittedNum;
+        }
+
+        bool IsFencePassed(uint64_t fence) const
+        {
+            return executedNum.load(std::memory_order_acquire) >= fence;
+        }
+
+        // blocks until the worker executed all tasks up to fence
+        void WaitFence(uint64_t fence)
+        {
+            for (uint32_t i = 0; i < spinCount + yieldCount; i++) {
+                if (IsFencePassed(fence)) {
+                    return;
+                }
+                if (i >= spinCount) {
+                    std::this_thread::yield();
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            fenceWaiterNum.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            fenceCondition.wait(lock, [this, fence]() -> bool { return executedNum.load() >= fence; });
+            fenceWaiterNum.fetch_sub(1);
+        }
+
+        // blocks until all submitted tasks are executed, including tasks emplaced from other threads before the call
+        void Flush()
+        {
+            WaitFence(GetFence());
+
+            const uint64_t foreignFence = foreignSubmittedNum.load();
+            if (foreignExecutedNum.load(std::memory_order_acquire) >= foreignFence) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            fenceWaiterNum.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            fenceCondition.wait(lock, [this, foreignFence]() -> bool { return foreignExecutedNum.load() >= foreignFence; });
+            fenceWaiterNum.fetch_sub(1);
+        }
+
+    private:
+        static constexpr uint32_t spinCount = 64;
+        static constexpr uint32_t yieldCount = 16;
+        static constexpr uint32_t batchSize = 64;
+        static constexpr size_t cacheLineSize = 64;
+
+        // spin, then yield, then park on condition, returns false when worker stopped and all tasks are finished
+        bool WaitTask()
+        {
+            for (uint32_t i = 0; i < spinCount + yieldCount; i++) {
+                if (HasTask()) {
+                    return true;
+                }
+                if (i >= spinCount) {
+                    std::this_thread::yield();
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            workerSleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            taskCondition.wait(lock, [this]() -> bool { return stop.load() || HasTask(); });
+            workerSleeping.store(false);
+            return HasTask();
+        }
+
+        bool HasTask() const
+        {
+            return !tasks.Empty() || foreignExecutedNum.load(std::memory_order_relaxed) < foreignSubmittedNum.load(std::memory_order_relaxed);
+        }
+
+        void ExecuteForeignTasks()
+        {
+            if (foreignExecutedNum.load(std::memory_order_relaxed) == foreignSubmittedNum.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            std::vector<Internal::InplaceTask> executingTasks;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                executingTasks.swap(foreignTasks);
+            }
+            for (auto& task : executingTasks) {
+                task();
+            }
+            foreignExecutedNum.fetch_add(executingTasks.size());
+            if (fenceWaiterNum.load() > 0) {
+                { std::unique_lock<std::mutex> lock(mutex); }
+                fenceCondition.notify_all();
+            }
+        }
+
+        void PushForeign(Internal::InplaceTask&& task)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                Assert(!stop.load(std::memory_order_relaxed));
+                foreignTasks.emplace_back(std::move(task));
+                foreignSubmittedNum.fetch_add(1);
+            }
+            taskCondition.notify_one();
+        }
+
+        void PublishExecuted(uint64_t executed)
+        {
+            executedNum.store(executed);
+            if (fenceWaiterNum.load() > 0) {
+                // lock pairs with the predicate check of waiters, so the notification can not slip in before they wait
+                { std::unique_lock<std::mutex> lock(mutex); }
+                fenceCondition.notify_all();
+            }
+        }
+
+        void Push(Internal::InplaceTask&& task)
+        {
+            if (std::this_thread::get_id() != producerThreadId) {
+                // a second producer races on the ring and corrupts it silently, so never go on
+                AssertWithReason(false, "SPSCWorkerThread is submitted from a thread other than its producer");
+                std::abort();
+            }
+            Assert(!stop.load(std::memory_order_relaxed));
+            // ring is bounded, producer backs off until worker makes room
+            while (!tasks.TryEmplace(std::move(task))) {
+                std::this_thread::yield();
+            }
+            submittedNum++;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (workerSleeping.load(std::memory_order_relaxed)) {
+                { std::unique_lock<std::mutex> lock(mutex); }
+                taskCondition.notify_one();
+            }
+        }
+
+        const std::thread::id producerThreadId;
+        std::atomic<bool> stop;
+        std::atomic<bool> workerSleeping;
+        std::atomic<uint32_t> fenceWaiterNum;
+        // written by producer only
+        uint64_t submittedNum;
+        alignas(cacheLineSize) std::atomic<uint64_t> executedNum;
+        // guarded by mutex, only tasks emplaced from threads other than the producer
+        std::vector<Internal::InplaceTask> foreignTasks;
+        std::atomic<uint64_t> foreignSubmittedNum;
+        std::atomic<uint64_t> foreignExecutedNum;
+        std::mutex mutex;
+        std::condition_variable taskCondition;
+        std::condition_variable fenceCondition;
+        SPSCQueue<Internal::InplaceTask> tasks;
+        NamedThread thread;
+    };
+}
+
+namespace Common {
+    template <typename T>
+    MPMCQueue<T>::MPMCQueue(size_t inCapacity)
+        : enqueuePos(0)
+        , dequeuePos(0)
+    {
+        size_t capacity = 2;
+        while (capacity < inCapacity) {
+            capacity <<= 1;
+        }
+        mask = capacity - 1;
+        cells = std::make_unique<Cell[]>(capacity);
+        for (size_t i = 0; i < capacity; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    MPMCQueue<T>::~MPMCQueue()
+    {
+        T value;
+        while (TryPop(value)) {}
+    }
+
+    template <typename T>
+    template <typename... Args>
+    bool MPMCQueue<T>::TryEmplace(Args&&... args)
+    {
+        // each cell carries a sequence number, which tells whether it is ready for the producer or the consumer of a position
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->storage) T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool MPMCQueue<T>::TryPop(T& outValue)
+    {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* value = std::launder(reinterpret_cast<T*>(cell->storage));
+        outValue = std::move(*value);
+        value->~T();
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool MPMCQueue<T>::Empty() const
+    {
+        return dequeuePos.load() >= enqueuePos.load();
+    }
+
+    template <typename T>
+    size_t MPMCQueue<T>::Capacity() const
+    {
+        return mask + 1;
+    }
+}
+
+namespace Common {
+    template <typename T>
+    SPSCQueue<T>::SPSCQueue(size_t inCapacity)
+        : tail(0)
+        , cachedHead(0)
+        , head(0)
+        , cachedTail(0)
+    {
+        size_t capacity = 2;
+        while (capacity < inCapacity) {
+            capacity <<= 1;
+        }
+        mask = capacity - 1;
+        slots = std::make_unique<Slot[]>(capacity);
+    }
+
+    template <typename T>
+    SPSCQueue<T>::~SPSCQueue()
+    {
+        while (Front() != nullptr) {
+            Pop();
+        }
+    }
+
+    template <typename T>
+    template <typename... Args>
+    bool SPSCQueue<T>::TryEmplace(Args&&... args)
+    {
+        const size_t pos = tail.load(std::memory_order_relaxed);
+        if (pos - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (pos - cachedHead > mask) {
+                return false;
+            }
+        }
+        new (slots[pos & mask].storage) T(std::forward<Args>(args)...);
+        tail.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool SPSCQueue<T>::TryPop(T& outValue)
+    {
+        T* value = Front();
+        if (value == nullptr) {
+            return false;
+        }
+        outValue = std::move(*value);
+        Pop();
+        return true;
+    }
+
+    template <typename T>
+    T* SPSCQueue<T>::Front()
+    {
+        const size_t pos = head.load(std::memory_order_relaxed);
+        if (pos == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (pos == cachedTail) {
+                return nullptr;
+            }
+        }
+        return std::launder(reinterpret_cast<T*>(slots[pos & mask].storage));
+    }
+
+    template <typename T>
+    void SPSCQueue<T>::Pop()
+    {
+        const size_t pos = head.load(std::memory_order_relaxed);
+        Assert(pos != cachedTail);
+        std::launder(reinterpret_cast<T*>(slots[pos & mask].storage))->~T();
+        head.store(pos + 1, std::memory_order_release);
+    }
+
+    template <typename T>
+    bool SPSCQueue<T>::Empty() const
+    {
+        return head.load() >= tail.load();
+    }
+
+    template <typename T>
+    size_t SPSCQueue<T>::Capacity() const
+    {
+        return mask + 1;
+    }
+
+    template <typename F>
+    uint64_t SPSCWorkerThread::Submit(F&& task)
+    {
+        Push(Internal::InplaceTask(std::forward<F>(task)));
+        return submittedNum;
+    }
+
+    template <typename F, typename... Args>
+    auto SPSCWorkerThread::EmplaceTask(F&& task, Args&&... args)
+    {
+        using RetType = std::invoke_result_t<F, Args...>;
+        std::packaged_task<RetType()> packagedTask(std::bind(std::forward<F>(task), std::forward<Args>(args)...));
+        auto result = packagedTask.get_future();
+        Internal::InplaceTask inplaceTask([packagedTask = std::move(packagedTask)]() mutable -> void { packagedTask(); });
+        if (std::this_thread::get_id() == producerThreadId) {
+            Push(std::move(inplaceTask));
+        } else {
+            PushForeign(std::move(inplaceTask));
+        }
+        return result;
+    }
 }
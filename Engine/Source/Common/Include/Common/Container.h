@@ -4,9 +4,116 @@
 
 #pragma once
 
+#include <new>
+#include <memory>
 #include <vector>
 #include <unordered_set>
 #include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <bit>
+#include <limits>
+
+#include <Common/Debug.h>
+
+namespace Common::Internal {
+    // both inputs must be sorted and free of duplicates, out must have room for min(lhsNum, rhsNum) elements,
+    // returns number of elements written
+    size_t IntersectSortedUnique(const uint32_t* lhs, size_t lhsNum, const uint32_t* rhs, size_t rhsNum, uint32_t* out);
+    size_t IntersectSortedUnique(const int32_t* lhs, size_t lhsNum, const int32_t* rhs, size_t rhsNum, int32_t* out);
+
+    // vector with storage for N elements inside the object, a growable one moves to heap once it exceeds N elements,
+    // a non growable one asserts instead
+    template <typename T, size_t N, bool Growable>
+    class InlineVector {
+    public:
+        static_assert(N > 0);
+
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        static constexpr size_t inlineCapacity = N;
+
+        InlineVector();
+        explicit InlineVector(size_t count);
+        InlineVector(size_t count, const T& value);
+        template <std::input_iterator InputIt> InlineVector(InputIt first, InputIt last);
+        InlineVector(std::initializer_list<T> list);
+        InlineVector(const InlineVector& other);
+        InlineVector(InlineVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+        ~InlineVector();
+        InlineVector& operator=(const InlineVector& other);
+        InlineVector& operator=(InlineVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+        InlineVector& operator=(std::initializer_list<T> list);
+
+        iterator begin();
+        const_iterator begin() const;
+        const_iterator cbegin() const;
+        iterator end();
+        const_iterator end() const;
+        const_iterator cend() const;
+
+        T& operator[](size_t index);
+        const T& operator[](size_t index) const;
+        T& at(size_t index);
+        const T& at(size_t index) const;
+        T& front();
+        const T& front() const;
+        T& back();
+        const T& back() const;
+        T* data();
+        const T* data() const;
+
+        bool empty() const;
+        size_t size() const;
+        size_t capacity() const;
+        // true while elements live in the inline storage
+        bool IsInline() const;
+        void reserve(size_t count);
+        void resize(size_t count);
+        void resize(size_t count, const T& value);
+        void clear();
+        void assign(size_t count, const T& value);
+        void assign(std::initializer_list<T> list);
+
+        void push_back(const T& value);
+        void push_back(T&& value);
+        template <typename... Args> T& emplace_back(Args&&... args);
+        void pop_back();
+        iterator insert(const_iterator pos, const T& value);
+        iterator insert(const_iterator pos, T&& value);
+        template <typename... Args> iterator emplace(const_iterator pos, Args&&... args);
+        iterator erase(const_iterator pos);
+        iterator erase(const_iterator first, const_iterator last);
+
+        bool operator==(const InlineVector& rhs) const;
+
+    private:
+        T* InlineData();
+        void Grow(size_t minCapacity);
+        void MoveFrom(InlineVector& other);
+        void Release();
+
+        T* dataPtr;
+        size_t sizeNum;
+        size_t capacityNum;
+        alignas(T) std::byte storage[sizeof(T) * N];
+    };
+}
 
 namespace Common {
     class VectorUtils {
@@ -27,6 +134,7 @@ namespace Common {
             return index;
         }
 
+        // lhs and rhs must be sorted
         template <typename T>
         static inline std::vector<T> GetIntersection(const std::vector<T>& lhs, const std::vector<T>& rhs)
         {
@@ -34,23 +142,1045 @@ namespace Common {
             std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(result));
             return result;
         }
+
+        // lhs and rhs must be sorted
+        template <typename T>
+        static inline std::vector<T> GetUnion(const std::vector<T>& lhs, const std::vector<T>& rhs)
+        {
+            std::vector<T> result;
+            result.reserve(lhs.size() + rhs.size());
+            std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(result));
+            return result;
+        }
+
+        // lhs and rhs must be sorted, returns elements of lhs which are not in rhs
+        template <typename T>
+        static inline std::vector<T> GetDifference(const std::vector<T>& lhs, const std::vector<T>& rhs)
+        {
+            std::vector<T> result;
+            result.reserve(lhs.size());
+            std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(result));
+            return result;
+        }
+
+        // lhs and rhs must be sorted and free of duplicates, 32 bit integers are compared four against four with simd
+        template <typename T>
+        static inline std::vector<T> GetUniqueIntersection(const std::vector<T>& lhs, const std::vector<T>& rhs)
+        {
+            if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>) {
+                std::vector<T> result(std::min(lhs.size(), rhs.size()));
+                result.resize(Internal::IntersectSortedUnique(lhs.data(), lhs.size(), rhs.data(), rhs.size(), result.data()));
+                return result;
+            } else {
+                return GetIntersection(lhs, rhs);
+            }
+        }
+
+        // lhs and rhs must be sorted
+        template <typename T>
+        static inline bool Intersects(const std::vector<T>& lhs, const std::vector<T>& rhs)
+        {
+            auto iterLhs = lhs.begin();
+            auto iterRhs = rhs.begin();
+            while (iterLhs != lhs.end() && iterRhs != rhs.end()) {
+                if (*iterLhs < *iterRhs) {
+                    iterLhs = std::lower_bound(iterLhs, lhs.end(), *iterRhs);
+                } else if (*iterRhs < *iterLhs) {
+                    iterRhs = std::lower_bound(iterRhs, rhs.end(), *iterLhs);
+                } else {
+                    return true;
+                }
+            }
+            return false;
+        }
     };
 
+    // works on any set type with find() and contains(), e.g. std::unordered_set and Common::FlatHashSet, every
+    // operation walks the smaller set and probes the larger one
     class SetUtils {
     public:
-        template <typename T>
-        static inline std::unordered_set<T> GetIntersection(const std::unordered_set<T>& lhs, const std::unordered_set<T>& rhs)
+        template <typename Set>
+        static inline Set GetIntersection(const Set& lhs, const Set& rhs)
+        {
+            const auto& smaller = lhs.size() <= rhs.size() ? lhs : rhs;
+            const auto& larger = lhs.size() <= rhs.size() ? rhs : lhs;
+
+            Set result;
+            result.reserve(smaller.size());
+            for (const auto& element : smaller) {
+                if (larger.contains(element)) {
+                    result.emplace(element);
+                }
+            }
+            return result;
+        }
+
+        template <typename Set>
+        static inline Set GetUnion(const Set& lhs, const Set& rhs)
+        {
+            const auto& smaller = lhs.size() <= rhs.size() ? lhs : rhs;
+            const auto& larger = lhs.size() <= rhs.size() ? rhs : lhs;
+
+            Set result = larger;
+            result.reserve(larger.size() + smaller.size());
+            for (const auto& element : smaller) {
+                result.emplace(element);
+            }
+            return result;
+        }
+
+        // returns elements of lhs which are not in rhs
+        template <typename Set>
+        static inline Set GetDifference(const Set& lhs, const Set& rhs)
         {
-            std::unordered_set<T> result;
+            Set result;
             result.reserve(lhs.size());
-            for (const auto& elementLhs : lhs) {
-                for (const auto& elementRhs : rhs) {
-                    if (elementLhs == elementRhs) {
-                        result.emplace(elementLhs);
-                    }
+            for (const auto& element : lhs) {
+                if (!rhs.contains(element)) {
+                    result.emplace(element);
                 }
             }
             return result;
         }
+
+        template <typename Set>
+        static inline bool Intersects(const Set& lhs, const Set& rhs)
+        {
+            const auto& smaller = lhs.size() <= rhs.size() ? lhs : rhs;
+            const auto& larger = lhs.size() <= rhs.size() ? rhs : lhs;
+            return std::any_of(smaller.begin(), smaller.end(), [&larger](const auto& element) -> bool { return larger.contains(element); });
+        }
+
+        // returns true if every element of lhs is in rhs
+        template <typename Set>
+        static inline bool IsSubset(const Set& lhs, const Set& rhs)
+        {
+            if (lhs.size() > rhs.size()) {
+                return false;
+            }
+            return std::all_of(lhs.begin(), lhs.end(), [&rhs](const auto& element) -> bool { return rhs.contains(element); });
+        }
     };
+
+    // set operations over dense id spaces stored as bit words, bit i of word w stands for id w * 64 + i, missing words
+    // of the shorter operand count as zero, loops are plain word loops so compilers vectorize them
+    class BitSetUtils {
+    public:
+        static constexpr size_t wordBits = 64;
+
+        static inline size_t GetWordNum(size_t bitNum)
+        {
+            return (bitNum + wordBits - 1) / wordBits;
+        }
+
+        static inline void AndWith(std::span<uint64_t> dst, std::span<const uint64_t> src)
+        {
+            const size_t common = std::min(dst.size(), src.size());
+            for (size_t i = 0; i < common; i++) {
+                dst[i] &= src[i];
+            }
+            std::fill(dst.begin() + static_cast<ptrdiff_t>(common), dst.end(), 0);
+        }
+
+        // dst must be at least as long as src
+        static inline void OrWith(std::span<uint64_t> dst, std::span<const uint64_t> src)
+        {
+            Assert(dst.size() >= src.size());
+            for (size_t i = 0; i < src.size(); i++) {
+                dst[i] |= src[i];
+            }
+        }
+
+        static inline void AndNotWith(std::span<uint64_t> dst, std::span<const uint64_t> src)
+        {
+            const size_t common = std::min(dst.size(), src.size());
+            for (size_t i = 0; i < common; i++) {
+                dst[i] &= ~src[i];
+            }
+        }
+
+        static inline bool Intersects(std::span<const uint64_t> lhs, std::span<const uint64_t> rhs)
+        {
+            const size_t common = std::min(lhs.size(), rhs.size());
+            for (size_t i = 0; i < common; i++) {
+                if ((lhs[i] & rhs[i]) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // returns true if every bit set in lhs is also set in rhs
+        static inline bool IsSubset(std::span<const uint64_t> lhs, std::span<const uint64_t> rhs)
+        {
+            for (size_t i = 0; i < lhs.size(); i++) {
+                const uint64_t rhsWord = i < rhs.size() ? rhs[i] : 0;
+                if ((lhs[i] & ~rhsWord) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static inline size_t Count(std::span<const uint64_t> words)
+        {
+            size_t result = 0;
+            for (const auto word : words) {
+                result += static_cast<size_t>(std::popcount(word));
+            }
+            return result;
+        }
+
+        // func(size_t index) is called for every set bit in ascending order
+        template <typename F>
+        static inline void ForEachSetBit(std::span<const uint64_t> words, F&& func)
+        {
+            for (size_t i = 0; i < words.size(); i++) {
+                for (uint64_t word = words[i]; word != 0; word &= word - 1) {
+                    func(i * wordBits + static_cast<size_t>(std::countr_zero(word)));
+                }
+            }
+        }
+    };
+}
+
+namespace Common {
+    // vector which keeps up to N elements inline and falls back to heap beyond that, for short lists on hot paths
+    template <typename T, size_t N>
+    class SmallVector : public Internal::InlineVector<T, N, true> {
+    public:
+        using Base = Internal::InlineVector<T, N, true>;
+        using Base::Base;
+    };
+
+    // vector which never allocates, pushing more than N elements is an error
+    template <typename T, size_t N>
+    class FixedVector : public Internal::InlineVector<T, N, false> {
+    public:
+        using Base = Internal::InlineVector<T, N, false>;
+        using Base::Base;
+    };
+
+    template <typename Signature, size_t Size = 48>
+    class InlineFunction;
+
+    // copyable callable wrapper like std::function, but the callable is always stored inline, so a callable larger
+    // than Size is rejected at compile time instead of being allocated on heap
+    template <typename R, typename... Args, size_t Size>
+    class InlineFunction<R(Args...), Size> {
+    public:
+        static constexpr size_t inlineCapacity = Size;
+
+        InlineFunction();
+        InlineFunction(std::nullptr_t); // NOLINT
+        template <typename F> requires (!std::is_same_v<std::decay_t<F>, InlineFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+        InlineFunction(F&& func); // NOLINT
+        InlineFunction(const InlineFunction& other);
+        InlineFunction(InlineFunction&& other) noexcept;
+        ~InlineFunction();
+        InlineFunction& operator=(const InlineFunction& other);
+        InlineFunction& operator=(InlineFunction&& other) noexcept;
+        InlineFunction& operator=(std::nullptr_t);
+
+        R operator()(Args... args) const;
+        explicit operator bool() const;
+
+    private:
+        enum class ManageOp {
+            copy,
+            move,
+            destroy
+        };
+
+        using Invoker = R(*)(void*, Args&&...);
+        using Manager = void(*)(ManageOp, void*, void*);
+
+        void CopyFrom(const InlineFunction& other);
+        void MoveFrom(InlineFunction& other);
+        void Reset();
+
+        alignas(std::max_align_t) mutable std::byte storage[Size];
+        Invoker invoker;
+        Manager manager;
+    };
+
+    // bit per index container for dense id spaces, set operations run a word at a time through BitSetUtils and
+    // iteration only visits set bits
+    class DynamicBitset {
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = size_t;
+            using difference_type = ptrdiff_t;
+            using pointer = const size_t*;
+            using reference = size_t;
+
+            size_t operator*() const;
+            Iterator& operator++();
+            Iterator operator++(int);
+            bool operator==(const Iterator& rhs) const;
+
+        private:
+            friend class DynamicBitset;
+
+            Iterator(const uint64_t* inWords, size_t inWordNum, size_t inWordIndex);
+            void SkipEmptyWords();
+
+            const uint64_t* words;
+            size_t wordNum;
+            size_t wordIndex;
+            uint64_t current;
+        };
+
+        DynamicBitset();
+        explicit DynamicBitset(size_t inBitNum, bool value = false);
+        DynamicBitset(const DynamicBitset& other);
+        DynamicBitset(DynamicBitset&& other) noexcept;
+        ~DynamicBitset();
+        DynamicBitset& operator=(const DynamicBitset& other);
+        DynamicBitset& operator=(DynamicBitset&& other) noexcept;
+
+        size_t Size() const;
+        void Resize(size_t inBitNum, bool value = false);
+        bool Test(size_t index) const;
+        void Set(size_t index);
+        void Reset(size_t index);
+        void SetAll();
+        void ResetAll();
+        size_t Count() const;
+        bool Any() const;
+        bool None() const;
+        bool Intersects(const DynamicBitset& rhs) const;
+        bool IsSubsetOf(const DynamicBitset& rhs) const;
+        std::span<const uint64_t> GetWords() const;
+
+        // operands of different sizes behave as if the shorter one is padded with zero bits, size of this never changes
+        DynamicBitset& operator&=(const DynamicBitset& rhs);
+        DynamicBitset& operator|=(const DynamicBitset& rhs);
+        DynamicBitset& operator-=(const DynamicBitset& rhs);
+        DynamicBitset operator&(const DynamicBitset& rhs) const;
+        DynamicBitset operator|(const DynamicBitset& rhs) const;
+        DynamicBitset operator-(const DynamicBitset& rhs) const;
+        bool operator==(const DynamicBitset& rhs) const;
+
+        // iterates indices of set bits in ascending order
+        Iterator begin() const;
+        Iterator end() const;
+
+    private:
+        void ClearUnusedBits();
+
+        size_t bitNum;
+        std::vector<uint64_t> words;
+    };
+
+    // set of unsigned indices with O(1) insert, erase and contains, elements are packed in a dense array so iteration
+    // touches no holes, erase swaps the last element into the hole, so the dense order is not stable
+    template <typename Index>
+    class SparseSet {
+    public:
+        static_assert(std::is_unsigned_v<Index>);
+
+        using Iterator = typename std::vector<Index>::const_iterator;
+
+        SparseSet();
+        explicit SparseSet(size_t indexCapacity);
+
+        // returns false if index already exists
+        bool Insert(Index index);
+        // returns false if index does not exist
+        bool Erase(Index index);
+        bool Contains(Index index) const;
+        // position of index in the dense array, index must exist
+        size_t GetDenseIndex(Index index) const;
+        size_t Size() const;
+        bool Empty() const;
+        void Clear();
+        void Reserve(size_t indexCapacity);
+        const Index* Data() const;
+
+        Iterator begin() const;
+        Iterator end() const;
+
+    private:
+        static constexpr Index invalid = std::numeric_limits<Index>::max();
+
+        std::vector<Index> sparse;
+        std::vector<Index> dense;
+    };
+}
+
+namespace Common::Internal {
+    template <typename T, size_t N, bool Growable>
+    InlineVector<T, N, Growable>::InlineVector()
+        : dataPtr(InlineData())
+        , sizeNum(0)
+        , capacityNum(N)
+    {
+    }
+
+    template <typename T, size_t N, bool Growable>
+    InlineVector<T, N, Growable>::InlineVector(size_t count)
+        : InlineVector()
+    {
+        resize(count);
+    }
+
+    template <typename T, size_t N, bool Growable>
+    InlineVector<T, N, Growable>::InlineVector(size_t count, const T& value)
+        : InlineVector()
+    {
+        resize(count, value);
+    }
+
+    template <typename T, size_t N, bool Growable>
+    template <std::input_iterator InputIt>
+    InlineVector<T, N, Growable>::InlineVector(InputIt first, InputIt last)
+        : InlineVector()
+    {
+        if constexpr (std::forward_iterator<InputIt>) {
+            reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    template <typename T, size_t N, bool Growable>
+    InlineVector<T, N, Growable>::InlineVector(std::initializer_list<T> list)
+        : InlineVector(list.begin(), list.end())
+    {
+    }
+
+    template <typename T, size_t N, bool Growable>
+    InlineVector<T, N, Growable>::InlineVector(const InlineVector& other)
+        : InlineVector(other.begin(), other.end())
+    {
+    }
+
+    template <typename T, size_t N, bool Growable>
+    InlineVector<T, N, Growable>::InlineVector(InlineVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : InlineVector()
+    {
+        MoveFrom(other);
+    }
+
+    template <typename T, size_t N, bool Growable>
+    InlineVector<T, N, Growable>::~InlineVector()
+    {
+        Release();
+    }
+
+    template <typename T, size_t N, bool Growable>
+    InlineVector<T, N, Growable>& InlineVector<T, N, Growable>::operator=(const InlineVector& other)
+    {
+        if (this != &other) {
+            clear();
+            reserve(other.sizeNum);
+            for (const auto& element : other) {
+                emplace_back(element);
+            }
+        }
+        return *this;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    InlineVector<T, N, Growable>& InlineVector<T, N, Growable>::operator=(InlineVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other) {
+            Release();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    InlineVector<T, N, Growable>& InlineVector<T, N, Growable>::operator=(std::initializer_list<T> list)
+    {
+        assign(list);
+        return *this;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    typename InlineVector<T, N, Growable>::iterator InlineVector<T, N, Growable>::begin()
+    {
+        return dataPtr;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    typename InlineVector<T, N, Growable>::const_iterator InlineVector<T, N, Growable>::begin() const
+    {
+        return dataPtr;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    typename InlineVector<T, N, Growable>::const_iterator InlineVector<T, N, Growable>::cbegin() const
+    {
+        return dataPtr;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    typename InlineVector<T, N, Growable>::iterator InlineVector<T, N, Growable>::end()
+    {
+        return dataPtr + sizeNum;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    typename InlineVector<T, N, Growable>::const_iterator InlineVector<T, N, Growable>::end() const
+    {
+        return dataPtr + sizeNum;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    typename InlineVector<T, N, Growable>::const_iterator InlineVector<T, N, Growable>::cend() const
+    {
+        return dataPtr + sizeNum;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    T& InlineVector<T, N, Growable>::operator[](size_t index)
+    {
+        return dataPtr[index];
+    }
+
+    template <typename T, size_t N, bool Growable>
+    const T& InlineVector<T, N, Growable>::operator[](size_t index) const
+    {
+        return dataPtr[index];
+    }
+
+    template <typename T, size_t N, bool Growable>
+    T& InlineVector<T, N, Growable>::at(size_t index)
+    {
+        Assert(index < sizeNum);
+        return dataPtr[index];
+    }
+
+    template <typename T, size_t N, bool Growable>
+    const T& InlineVector<T, N, Growable>::at(size_t index) const
+    {
+        Assert(index < sizeNum);
+        return dataPtr[index];
+    }
+
+    template <typename T, size_t N, bool Growable>
+    T& InlineVector<T, N, Growable>::front()
+    {
+        return dataPtr[0];
+    }
+
+    template <typename T, size_t N, bool Growable>
+    const T& InlineVector<T, N, Growable>::front() const
+    {
+        return dataPtr[0];
+    }
+
+    template <typename T, size_t N, bool Growable>
+    T& InlineVector<T, N, Growable>::back()
+    {
+        return dataPtr[sizeNum - 1];
+    }
+
+    template <typename T, size_t N, bool Growable>
+    const T& InlineVector<T, N, Growable>::back() const
+    {
+        return dataPtr[sizeNum - 1];
+    }
+
+    template <typename T, size_t N, bool Growable>
+    T* InlineVector<T, N, Growable>::data()
+    {
+        return dataPtr;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    const T* InlineVector<T, N, Growable>::data() const
+    {
+        return dataPtr;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    bool InlineVector<T, N, Growable>::empty() const
+    {
+        return sizeNum == 0;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    size_t InlineVector<T, N, Growable>::size() const
+    {
+        return sizeNum;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    size_t InlineVector<T, N, Growable>::capacity() const
+    {
+        return capacityNum;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    bool InlineVector<T, N, Growable>::IsInline() const
+    {
+        return dataPtr == reinterpret_cast<const T*>(storage);
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::reserve(size_t count)
+    {
+        if (count > capacityNum) {
+            Grow(count);
+        }
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::resize(size_t count)
+    {
+        if (count < sizeNum) {
+            erase(begin() + count, end());
+            return;
+        }
+        reserve(count);
+        while (sizeNum < count) {
+            emplace_back();
+        }
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::resize(size_t count, const T& value)
+    {
+        if (count < sizeNum) {
+            erase(begin() + count, end());
+            return;
+        }
+        reserve(count);
+        while (sizeNum < count) {
+            emplace_back(value);
+        }
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::clear()
+    {
+        std::destroy(begin(), end());
+        sizeNum = 0;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::assign(size_t count, const T& value)
+    {
+        clear();
+        resize(count, value);
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::assign(std::initializer_list<T> list)
+    {
+        clear();
+        reserve(list.size());
+        for (const auto& element : list) {
+            emplace_back(element);
+        }
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template <typename T, size_t N, bool Growable>
+    template <typename... Args>
+    T& InlineVector<T, N, Growable>::emplace_back(Args&&... args)
+    {
+        if (sizeNum == capacityNum) {
+            // args may refer to an element of this vector, so build the new element before the old storage goes away
+            T value(std::forward<Args>(args)...);
+            Grow(sizeNum + 1);
+            new (dataPtr + sizeNum) T(std::move(value));
+        } else {
+            new (dataPtr + sizeNum) T(std::forward<Args>(args)...);
+        }
+        return dataPtr[sizeNum++];
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::pop_back()
+    {
+        Assert(sizeNum > 0);
+        dataPtr[--sizeNum].~T();
+    }
+
+    template <typename T, size_t N, bool Growable>
+    typename InlineVector<T, N, Growable>::iterator InlineVector<T, N, Growable>::insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    template <typename T, size_t N, bool Growable>
+    typename InlineVector<T, N, Growable>::iterator InlineVector<T, N, Growable>::insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    template <typename T, size_t N, bool Growable>
+    template <typename... Args>
+    typename InlineVector<T, N, Growable>::iterator InlineVector<T, N, Growable>::emplace(const_iterator pos, Args&&... args)
+    {
+        const auto index = static_cast<size_t>(pos - begin());
+        Assert(index <= sizeNum);
+        if (index == sizeNum) {
+            emplace_back(std::forward<Args>(args)...);
+            return begin() + index;
+        }
+
+        T value(std::forward<Args>(args)...);
+        emplace_back(std::move(back()));
+        std::move_backward(begin() + index, end() - 2, end() - 1);
+        dataPtr[index] = std::move(value);
+        return begin() + index;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    typename InlineVector<T, N, Growable>::iterator InlineVector<T, N, Growable>::erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    template <typename T, size_t N, bool Growable>
+    typename InlineVector<T, N, Growable>::iterator InlineVector<T, N, Growable>::erase(const_iterator first, const_iterator last)
+    {
+        auto* mutFirst = begin() + (first - begin());
+        auto* mutLast = begin() + (last - begin());
+        if (mutFirst == mutLast) {
+            return mutFirst;
+        }
+        auto* newEnd = std::move(mutLast, end(), mutFirst);
+        std::destroy(newEnd, end());
+        sizeNum = static_cast<size_t>(newEnd - begin());
+        return mutFirst;
+    }
+
+    template <typename T, size_t N, bool Growable>
+    bool InlineVector<T, N, Growable>::operator==(const InlineVector& rhs) const
+    {
+        return std::equal(begin(), end(), rhs.begin(), rhs.end());
+    }
+
+    template <typename T, size_t N, bool Growable>
+    T* InlineVector<T, N, Growable>::InlineData()
+    {
+        return reinterpret_cast<T*>(storage);
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::Grow(size_t minCapacity)
+    {
+        if constexpr (!Growable) {
+            // callers write right after growing, so going on would write past inline storage, terminate in every build config
+            if (minCapacity > N) {
+                AssertWithReason(false, "fixed vector capacity exceeded");
+                std::abort();
+            }
+        } else {
+            const size_t newCapacity = std::max<size_t>(minCapacity, capacityNum * 2);
+            auto* newData = static_cast<T*>(::operator new(newCapacity * sizeof(T), std::align_val_t(alignof(T))));
+            std::uninitialized_move(begin(), end(), newData);
+            std::destroy(begin(), end());
+            if (!IsInline()) {
+                ::operator delete(dataPtr, std::align_val_t(alignof(T)));
+            }
+            dataPtr = newData;
+            capacityNum = newCapacity;
+        }
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::MoveFrom(InlineVector& other)
+    {
+        if (!other.IsInline()) {
+            dataPtr = other.dataPtr;
+            sizeNum = other.sizeNum;
+            capacityNum = other.capacityNum;
+            other.dataPtr = other.InlineData();
+            other.sizeNum = 0;
+            other.capacityNum = N;
+            return;
+        }
+
+        dataPtr = InlineData();
+        capacityNum = N;
+        std::uninitialized_move(other.begin(), other.end(), dataPtr);
+        sizeNum = other.sizeNum;
+        other.clear();
+    }
+
+    template <typename T, size_t N, bool Growable>
+    void InlineVector<T, N, Growable>::Release()
+    {
+        clear();
+        if (!IsInline()) {
+            ::operator delete(dataPtr, std::align_val_t(alignof(T)));
+        }
+        dataPtr = InlineData();
+        capacityNum = N;
+    }
+}
+
+namespace Common {
+    template <typename R, typename... Args, size_t Size>
+    InlineFunction<R(Args...), Size>::InlineFunction()
+        : invoker(nullptr)
+        , manager(nullptr)
+    {
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    InlineFunction<R(Args...), Size>::InlineFunction(std::nullptr_t)
+        : InlineFunction()
+    {
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    template <typename F> requires (!std::is_same_v<std::decay_t<F>, InlineFunction<R(Args...), Size>> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    InlineFunction<R(Args...), Size>::InlineFunction(F&& func)
+    {
+        using Func = std::decay_t<F>;
+        static_assert(sizeof(Func) <= Size && alignof(Func) <= alignof(std::max_align_t), "callable is too large to store inline");
+        static_assert(std::is_copy_constructible_v<Func>, "callable must be copy constructible");
+
+        new (storage) Func(std::forward<F>(func));
+        invoker = [](void* object, Args&&... args) -> R {
+            return std::invoke_r<R>(*static_cast<Func*>(object), std::forward<Args>(args)...);
+        };
+        manager = [](ManageOp op, void* dst, void* src) -> void {
+            if (op == ManageOp::copy) {
+                new (dst) Func(*static_cast<const Func*>(src));
+            } else if (op == ManageOp::move) {
+                new (dst) Func(std::move(*static_cast<Func*>(src)));
+                static_cast<Func*>(src)->~Func();
+            } else {
+                static_cast<Func*>(src)->~Func();
+            }
+        };
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    InlineFunction<R(Args...), Size>::InlineFunction(const InlineFunction& other)
+        : InlineFunction()
+    {
+        CopyFrom(other);
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    InlineFunction<R(Args...), Size>::InlineFunction(InlineFunction&& other) noexcept
+        : InlineFunction()
+    {
+        MoveFrom(other);
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    InlineFunction<R(Args...), Size>::~InlineFunction()
+    {
+        Reset();
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    InlineFunction<R(Args...), Size>& InlineFunction<R(Args...), Size>::operator=(const InlineFunction& other)
+    {
+        if (this != &other) {
+            Reset();
+            CopyFrom(other);
+        }
+        return *this;
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    InlineFunction<R(Args...), Size>& InlineFunction<R(Args...), Size>::operator=(InlineFunction&& other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    InlineFunction<R(Args...), Size>& InlineFunction<R(Args...), Size>::operator=(std::nullptr_t)
+    {
+        Reset();
+        return *this;
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    R InlineFunction<R(Args...), Size>::operator()(Args... args) const
+    {
+        Assert(invoker != nullptr);
+        return invoker(storage, std::forward<Args>(args)...);
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    InlineFunction<R(Args...), Size>::operator bool() const
+    {
+        return invoker != nullptr;
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    void InlineFunction<R(Args...), Size>::CopyFrom(const InlineFunction& other)
+    {
+        if (other.manager == nullptr) {
+            return;
+        }
+        other.manager(ManageOp::copy, storage, other.storage);
+        invoker = other.invoker;
+        manager = other.manager;
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    void InlineFunction<R(Args...), Size>::MoveFrom(InlineFunction& other)
+    {
+        if (other.manager == nullptr) {
+            return;
+        }
+        other.manager(ManageOp::move, storage, other.storage);
+        invoker = other.invoker;
+        manager = other.manager;
+        other.invoker = nullptr;
+        other.manager = nullptr;
+    }
+
+    template <typename R, typename... Args, size_t Size>
+    void InlineFunction<R(Args...), Size>::Reset()
+    {
+        if (manager != nullptr) {
+            manager(ManageOp::destroy, nullptr, storage);
+        }
+        invoker = nullptr;
+        manager = nullptr;
+    }
+}
+
+namespace Common {
+    inline bool DynamicBitset::Test(size_t index) const
+    {
+        Assert(index < bitNum);
+        return (words[index / BitSetUtils::wordBits] >> (index % BitSetUtils::wordBits) & 1) != 0;
+    }
+
+    inline void DynamicBitset::Set(size_t index)
+    {
+        Assert(index < bitNum);
+        words[index / BitSetUtils::wordBits] |= uint64_t(1) << (index % BitSetUtils::wordBits);
+    }
+
+    inline void DynamicBitset::Reset(size_t index)
+    {
+        Assert(index < bitNum);
+        words[index / BitSetUtils::wordBits] &= ~(uint64_t(1) << (index % BitSetUtils::wordBits));
+    }
+
+    template <typename Index>
+    SparseSet<Index>::SparseSet() = default;
+
+    template <typename Index>
+    SparseSet<Index>::SparseSet(size_t indexCapacity)
+    {
+        Reserve(indexCapacity);
+    }
+
+    template <typename Index>
+    bool SparseSet<Index>::Insert(Index index)
+    {
+        Assert(index != invalid);
+        if (index >= sparse.size()) {
+            sparse.resize(std::max(static_cast<size_t>(index) + 1, sparse.size() * 2), invalid);
+        } else if (sparse[index] != invalid) {
+            return false;
+        }
+        sparse[index] = static_cast<Index>(dense.size());
+        dense.emplace_back(index);
+        return true;
+    }
+
+    template <typename Index>
+    bool SparseSet<Index>::Erase(Index index)
+    {
+        if (!Contains(index)) {
+            return false;
+        }
+        const Index denseIndex = sparse[index];
+        const Index last = dense.back();
+        dense[denseIndex] = last;
+        sparse[last] = denseIndex;
+        dense.pop_back();
+        sparse[index] = invalid;
+        return true;
+    }
+
+    template <typename Index>
+    bool SparseSet<Index>::Contains(Index index) const
+    {
+        return index < sparse.size() && sparse[index] != invalid;
+    }
+
+    template <typename Index>
+    size_t SparseSet<Index>::GetDenseIndex(Index index) const
+    {
+        Assert(Contains(index));
+        return sparse[index];
+    }
+
+    template <typename Index>
+    size_t SparseSet<Index>::Size() const
+    {
+        return dense.size();
+    }
+
+    template <typename Index>
+    bool SparseSet<Index>::Empty() const
+    {
+        return dense.empty();
+    }
+
+    template <typename Index>
+    void SparseSet<Index>::Clear()
+    {
+        // only slots of present elements are dirty, so clearing costs O(Size()) instead of O(capacity)
+        for (const auto index : dense) {
+            sparse[index] = invalid;
+        }
+        dense.clear();
+    }
+
+    template <typename Index>
+    void SparseSet<Index>::Reserve(size_t indexCapacity)
+    {
+        if (indexCapacity > sparse.size()) {
+            sparse.resize(indexCapacity, invalid);
+        }
+        dense.reserve(indexCapacity);
+    }
+
+    template <typename Index>
+    const Index* SparseSet<Index>::Data() const
+    {
+        return dense.data();
+    }
+
+    template <typename Index>
+    typename SparseSet<Index>::Iterator SparseSet<Index>::begin() const
+    {
+        return dense.begin();
+    }
+
+    template <typename Index>
+    typename SparseSet<Index>::Iterator SparseSet<Index>::end() const
+    {
+        return dense.end();
+    }
 }
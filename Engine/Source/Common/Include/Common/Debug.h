@@ -21,7 +21,7 @@
 namespace Common {
     class Debug {
     public:
-        static void AssertImpl(bool expression, const std::string& name, const std::string& file, uint32_t line, const std::string& reason = "")
+        static void AssertImpl(bool expression, const char* name, const char* file, uint32_t line, const std::string& reason = "")
         {
             if (expression) {
                 return;
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string_view>
 
 #include <city.h>
 
@@ -87,5 +88,15 @@ namespace Common {
         {
             return Internal::StrCrc32Internal<sizeof(str) - 2>(str) ^ 0xffffffff;
         }
+
+        // same result as compile time version, for strings only known at runtime
+        static constexpr uint32_t RuntimeStrCrc32(std::string_view str)
+        {
+            uint32_t result = 0xffffffff;
+            for (const char c : str) {
+                result = (result >> 8) ^ Internal::crcTable[(result ^ c) & 0x000000ff];
+            }
+            return result ^ 0xffffffff;
+        }
     };
 }
@@ -0,0 +1,1002 @@
+//
+// Created by johnk on 2024/3/16.
+//
+
+#pragma once
+
+#include <bit>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COMMON_HASH_GROUP_SSE2 1
+#include <emmintrin.h>
+#else
+#define COMMON_HASH_GROUP_SSE2 0
+#endif
+
+#include <Common/Debug.h>
+
+namespace Common::Internal {
+    // every slot has one control byte, full slots store the low 7 bits of the hash, so a probe can filter a whole group
+    // of slots with one compare before touching any key
+    using HashCtrl = int8_t;
+
+    static constexpr HashCtrl hashCtrlEmpty = -128;
+    static constexpr HashCtrl hashCtrlDeleted = -2;
+    static constexpr HashCtrl hashCtrlSentinel = -1;
+    static constexpr size_t hashGroupWidth = 16;
+
+    class HashGroup {
+    public:
+        explicit HashGroup(const HashCtrl* inCtrl);
+
+        // bit i of the results is set if slot i of the group matches
+        uint32_t Match(HashCtrl h2) const;
+        uint32_t MatchEmpty() const;
+        uint32_t MatchEmptyOrDeleted() const;
+
+    private:
+#if COMMON_HASH_GROUP_SSE2
+        __m128i ctrl;
+#else
+        const HashCtrl* ctrl;
+#endif
+    };
+
+    // std::hash of integers is identity on most standard libraries, mix it so that both the group index and the 7 bits
+    // stored in control bytes get well distributed
+    size_t MixHash(size_t hash);
+
+    template <typename T>
+    concept HashTransparent = requires { typename T::is_transparent; };
+
+    // find() and friends take any key like type when both hasher and comparator are transparent, or key_type otherwise
+    template <bool Transparent>
+    struct HashKeyArg {
+        template <typename K, typename Key>
+        using Type = Key;
+    };
+
+    template <>
+    struct HashKeyArg<true> {
+        template <typename K, typename Key>
+        using Type = K;
+    };
+
+    template <typename K>
+    struct FlatSetPolicy {
+        using KeyType = K;
+        using ValueType = K;
+        // elements of a set are keys, so they can not be modified through any iterator
+        static constexpr bool constValue = true;
+
+        static const K& GetKey(const ValueType& value);
+        static void Relocate(ValueType* dst, ValueType* src);
+    };
+
+    template <typename K, typename V>
+    struct FlatMapPolicy {
+        using KeyType = K;
+        using ValueType = std::pair<const K, V>;
+        static constexpr bool constValue = false;
+
+        static const K& GetKey(const ValueType& value);
+        static void Relocate(ValueType* dst, ValueType* src);
+    };
+
+    // open addressing table with swiss table layout, slots are stored in one flat array and probed by groups of
+    // hashGroupWidth control bytes, unlike std::unordered_map, element addresses are not stable across insertion
+    template <typename Policy, typename Hash, typename KeyEqual>
+    class FlatHashTable {
+    public:
+        using key_type = typename Policy::KeyType;
+        using value_type = typename Policy::ValueType;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        template <bool Const>
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename Policy::ValueType;
+            using difference_type = ptrdiff_t;
+            using pointer = std::conditional_t<Const || Policy::constValue, const value_type*, value_type*>;
+            using reference = std::conditional_t<Const || Policy::constValue, const value_type&, value_type&>;
+
+            Iterator();
+            template <bool OtherConst> requires (Const && !OtherConst) Iterator(const Iterator<OtherConst>& other); // NOLINT
+
+            reference operator*() const;
+            pointer operator->() const;
+            Iterator& operator++();
+            Iterator operator++(int);
+            bool operator==(const Iterator& rhs) const;
+
+        private:
+            friend class FlatHashTable;
+            template <bool> friend class Iterator;
+
+            Iterator(const HashCtrl* inCtrl, value_type* inSlot);
+            void SkipFree();
+
+            const HashCtrl* ctrl;
+            value_type* slot;
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        template <typename K>
+        using KeyArg = typename HashKeyArg<HashTransparent<Hash> && HashTransparent<KeyEqual>>::template Type<K, key_type>;
+
+        FlatHashTable();
+        explicit FlatHashTable(size_t inCapacity, const Hash& inHash = Hash(), const KeyEqual& inEqual = KeyEqual());
+        FlatHashTable(std::initializer_list<value_type> inList);
+        FlatHashTable(const FlatHashTable& other);
+        FlatHashTable(FlatHashTable&& other) noexcept;
+        ~FlatHashTable();
+        FlatHashTable& operator=(const FlatHashTable& other);
+        FlatHashTable& operator=(FlatHashTable&& other) noexcept;
+
+        iterator begin();
+        const_iterator begin() const;
+        const_iterator cbegin() const;
+        iterator end();
+        const_iterator end() const;
+        const_iterator cend() const;
+
+        bool empty() const;
+        size_t size() const;
+        size_t capacity() const;
+        void clear();
+        void reserve(size_t count);
+        void swap(FlatHashTable& other) noexcept;
+
+        std::pair<iterator, bool> insert(const value_type& value);
+        std::pair<iterator, bool> insert(value_type&& value);
+        template <typename InputIt> void insert(InputIt first, InputIt last);
+        void insert(std::initializer_list<value_type> inList);
+        template <typename... Args> std::pair<iterator, bool> emplace(Args&&... args);
+
+        template <typename K = key_type> iterator find(const KeyArg<K>& key);
+        template <typename K = key_type> const_iterator find(const KeyArg<K>& key) const;
+        template <typename K = key_type> bool contains(const KeyArg<K>& key) const;
+        template <typename K = key_type> size_t count(const KeyArg<K>& key) const;
+        template <typename K = key_type> size_t erase(const KeyArg<K>& key);
+        iterator erase(const_iterator iter);
+        iterator erase(iterator iter);
+
+        bool operator==(const FlatHashTable& rhs) const;
+
+    protected:
+        template <typename K> size_t HashOf(const K& key) const;
+        template <typename K> size_t FindIndex(const K& key, size_t hashValue) const;
+        // returns the slot a new element with hashValue goes to, grows the table first if needed
+        size_t PrepareInsert(size_t hashValue);
+        // marks a slot returned by PrepareInsert as full once the element is constructed in it
+        void CommitInsert(size_t index, size_t hashValue);
+        template <typename K, typename... Args> std::pair<iterator, bool> EmplaceUnique(const K& key, Args&&... args);
+        iterator IteratorAt(size_t index);
+        const_iterator IteratorAt(size_t index) const;
+
+    private:
+        static size_t MaxLoad(size_t inCapacity);
+        static size_t CapacityFor(size_t count);
+        static size_t CtrlBytes(size_t inCapacity);
+        static size_t AllocationAlignment();
+
+        size_t FindFreeSlot(size_t hashValue) const;
+        void EraseAt(size_t index);
+        void Grow();
+        void Resize(size_t newCapacity);
+        void DestroyAll();
+        void Deallocate();
+
+        HashCtrl* ctrl;
+        value_type* slots;
+        size_t capacityNum;
+        size_t sizeNum;
+        size_t growthLeft;
+        [[no_unique_address]] Hash hash;
+        [[no_unique_address]] KeyEqual equal;
+    };
+}
+
+namespace Common {
+    // hasher for string keys which accepts std::string_view and c strings in find() without building a std::string,
+    // pair it with std::equal_to<>
+    struct StringHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view value) const;
+    };
+
+    template <typename K, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class FlatHashSet : public Internal::FlatHashTable<Internal::FlatSetPolicy<K>, Hash, KeyEqual> {
+    public:
+        using Base = Internal::FlatHashTable<Internal::FlatSetPolicy<K>, Hash, KeyEqual>;
+        using Base::Base;
+    };
+
+    template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class FlatHashMap : public Internal::FlatHashTable<Internal::FlatMapPolicy<K, V>, Hash, KeyEqual> {
+    public:
+        using Base = Internal::FlatHashTable<Internal::FlatMapPolicy<K, V>, Hash, KeyEqual>;
+        using mapped_type = V;
+        using typename Base::key_type;
+        using typename Base::value_type;
+        using typename Base::iterator;
+        using typename Base::const_iterator;
+        template <typename T> using KeyArg = typename Base::template KeyArg<T>;
+        using Base::Base;
+
+        template <typename... Args> std::pair<iterator, bool> try_emplace(const K& key, Args&&... args);
+        template <typename... Args> std::pair<iterator, bool> try_emplace(K&& key, Args&&... args);
+        template <typename M> std::pair<iterator, bool> insert_or_assign(const K& key, M&& value);
+        template <typename M> std::pair<iterator, bool> insert_or_assign(K&& key, M&& value);
+        V& operator[](const K& key);
+        V& operator[](K&& key);
+        template <typename T = K> V& at(const KeyArg<T>& key);
+        template <typename T = K> const V& at(const KeyArg<T>& key) const;
+    };
+}
+
+namespace Common::Internal {
+#if COMMON_HASH_GROUP_SSE2
+    inline HashGroup::HashGroup(const HashCtrl* inCtrl)
+        : ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(inCtrl)))
+    {
+    }
+
+    inline uint32_t HashGroup::Match(HashCtrl h2) const
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+    }
+
+    inline uint32_t HashGroup::MatchEmpty() const
+    {
+        return Match(hashCtrlEmpty);
+    }
+
+    inline uint32_t HashGroup::MatchEmptyOrDeleted() const
+    {
+        // empty and deleted are the only control values less than sentinel
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(hashCtrlSentinel), ctrl)));
+    }
+#else
+    inline HashGroup::HashGroup(const HashCtrl* inCtrl)
+        : ctrl(inCtrl)
+    {
+    }
+
+    inline uint32_t HashGroup::Match(HashCtrl h2) const
+    {
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < hashGroupWidth; i++) {
+            result |= static_cast<uint32_t>(ctrl[i] == h2) << i;
+        }
+        return result;
+    }
+
+    inline uint32_t HashGroup::MatchEmpty() const
+    {
+        return Match(hashCtrlEmpty);
+    }
+
+    inline uint32_t HashGroup::MatchEmptyOrDeleted() const
+    {
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < hashGroupWidth; i++) {
+            result |= static_cast<uint32_t>(ctrl[i] < hashCtrlSentinel) << i;
+        }
+        return result;
+    }
+#endif
+
+    inline size_t MixHash(size_t hash)
+    {
+        uint64_t value = static_cast<uint64_t>(hash);
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdull;
+        value ^= value >> 33;
+        return static_cast<size_t>(value);
+    }
+
+    template <typename K>
+    const K& FlatSetPolicy<K>::GetKey(const ValueType& value)
+    {
+        return value;
+    }
+
+    template <typename K>
+    void FlatSetPolicy<K>::Relocate(ValueType* dst, ValueType* src)
+    {
+        new (dst) ValueType(std::move(*src));
+        src->~ValueType();
+    }
+
+    template <typename K, typename V>
+    const K& FlatMapPolicy<K, V>::GetKey(const ValueType& value)
+    {
+        return value.first;
+    }
+
+    template <typename K, typename V>
+    void FlatMapPolicy<K, V>::Relocate(ValueType* dst, ValueType* src)
+    {
+        // source is destroyed right after, so moving its key out is not observable
+        new (dst) ValueType(std::move(const_cast<K&>(src->first)), std::move(src->second));
+        src->~ValueType();
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <bool Const>
+    FlatHashTable<Policy, Hash, KeyEqual>::Iterator<Const>::Iterator()
+        : ctrl(nullptr)
+        , slot(nullptr)
+    {
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <bool Const>
+    template <bool OtherConst> requires (Const && !OtherConst)
+    FlatHashTable<Policy, Hash, KeyEqual>::Iterator<Const>::Iterator(const Iterator<OtherConst>& other)
+        : ctrl(other.ctrl)
+        , slot(other.slot)
+    {
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <bool Const>
+    FlatHashTable<Policy, Hash, KeyEqual>::Iterator<Const>::Iterator(const HashCtrl* inCtrl, value_type* inSlot)
+        : ctrl(inCtrl)
+        , slot(inSlot)
+    {
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <bool Const>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::template Iterator<Const>::reference FlatHashTable<Policy, Hash, KeyEqual>::Iterator<Const>::operator*() const
+    {
+        return *slot;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <bool Const>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::template Iterator<Const>::pointer FlatHashTable<Policy, Hash, KeyEqual>::Iterator<Const>::operator->() const
+    {
+        return slot;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <bool Const>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::template Iterator<Const>& FlatHashTable<Policy, Hash, KeyEqual>::Iterator<Const>::operator++()
+    {
+        ctrl++;
+        slot++;
+        SkipFree();
+        return *this;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <bool Const>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::template Iterator<Const> FlatHashTable<Policy, Hash, KeyEqual>::Iterator<Const>::operator++(int)
+    {
+        Iterator result = *this;
+        ++(*this);
+        return result;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <bool Const>
+    bool FlatHashTable<Policy, Hash, KeyEqual>::Iterator<Const>::operator==(const Iterator& rhs) const
+    {
+        return slot == rhs.slot;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <bool Const>
+    void FlatHashTable<Policy, Hash, KeyEqual>::Iterator<Const>::SkipFree()
+    {
+        // the sentinel behind the last control byte stops the scan, so no bound check is needed
+        while (*ctrl < hashCtrlSentinel) {
+            ctrl++;
+            slot++;
+        }
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    FlatHashTable<Policy, Hash, KeyEqual>::FlatHashTable()
+        : ctrl(nullptr)
+        , slots(nullptr)
+        , capacityNum(0)
+        , sizeNum(0)
+        , growthLeft(0)
+    {
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    FlatHashTable<Policy, Hash, KeyEqual>::FlatHashTable(size_t inCapacity, const Hash& inHash, const KeyEqual& inEqual)
+        : ctrl(nullptr)
+        , slots(nullptr)
+        , capacityNum(0)
+        , sizeNum(0)
+        , growthLeft(0)
+        , hash(inHash)
+        , equal(inEqual)
+    {
+        reserve(inCapacity);
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    FlatHashTable<Policy, Hash, KeyEqual>::FlatHashTable(std::initializer_list<value_type> inList)
+        : FlatHashTable()
+    {
+        insert(inList);
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    FlatHashTable<Policy, Hash, KeyEqual>::FlatHashTable(const FlatHashTable& other)
+        : ctrl(nullptr)
+        , slots(nullptr)
+        , capacityNum(0)
+        , sizeNum(0)
+        , growthLeft(0)
+        , hash(other.hash)
+        , equal(other.equal)
+    {
+        reserve(other.sizeNum);
+        for (const auto& value : other) {
+            const size_t hashValue = HashOf(Policy::GetKey(value));
+            const size_t index = FindFreeSlot(hashValue);
+            new (slots + index) value_type(value);
+            CommitInsert(index, hashValue);
+        }
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    FlatHashTable<Policy, Hash, KeyEqual>::FlatHashTable(FlatHashTable&& other) noexcept
+        : ctrl(other.ctrl)
+        , slots(other.slots)
+        , capacityNum(other.capacityNum)
+        , sizeNum(other.sizeNum)
+        , growthLeft(other.growthLeft)
+        , hash(std::move(other.hash))
+        , equal(std::move(other.equal))
+    {
+        other.ctrl = nullptr;
+        other.slots = nullptr;
+        other.capacityNum = 0;
+        other.sizeNum = 0;
+        other.growthLeft = 0;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    FlatHashTable<Policy, Hash, KeyEqual>::~FlatHashTable()
+    {
+        DestroyAll();
+        Deallocate();
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    FlatHashTable<Policy, Hash, KeyEqual>& FlatHashTable<Policy, Hash, KeyEqual>::operator=(const FlatHashTable& other)
+    {
+        if (this != &other) {
+            FlatHashTable copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    FlatHashTable<Policy, Hash, KeyEqual>& FlatHashTable<Policy, Hash, KeyEqual>::operator=(FlatHashTable&& other) noexcept
+    {
+        if (this != &other) {
+            FlatHashTable moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::iterator FlatHashTable<Policy, Hash, KeyEqual>::begin()
+    {
+        if (sizeNum == 0) {
+            return end();
+        }
+        iterator result(ctrl, slots);
+        result.SkipFree();
+        return result;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::const_iterator FlatHashTable<Policy, Hash, KeyEqual>::begin() const
+    {
+        return const_cast<FlatHashTable*>(this)->begin();
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::const_iterator FlatHashTable<Policy, Hash, KeyEqual>::cbegin() const
+    {
+        return begin();
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::iterator FlatHashTable<Policy, Hash, KeyEqual>::end()
+    {
+        return iterator(ctrl + capacityNum, slots + capacityNum);
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::const_iterator FlatHashTable<Policy, Hash, KeyEqual>::end() const
+    {
+        return const_cast<FlatHashTable*>(this)->end();
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::const_iterator FlatHashTable<Policy, Hash, KeyEqual>::cend() const
+    {
+        return end();
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    bool FlatHashTable<Policy, Hash, KeyEqual>::empty() const
+    {
+        return sizeNum == 0;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::size() const
+    {
+        return sizeNum;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::capacity() const
+    {
+        return capacityNum;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    void FlatHashTable<Policy, Hash, KeyEqual>::clear()
+    {
+        if (capacityNum == 0) {
+            return;
+        }
+        DestroyAll();
+        std::fill(ctrl, ctrl + capacityNum, hashCtrlEmpty);
+        sizeNum = 0;
+        growthLeft = MaxLoad(capacityNum);
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    void FlatHashTable<Policy, Hash, KeyEqual>::reserve(size_t count)
+    {
+        if (count > MaxLoad(capacityNum)) {
+            Resize(CapacityFor(count));
+        }
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    void FlatHashTable<Policy, Hash, KeyEqual>::swap(FlatHashTable& other) noexcept
+    {
+        std::swap(ctrl, other.ctrl);
+        std::swap(slots, other.slots);
+        std::swap(capacityNum, other.capacityNum);
+        std::swap(sizeNum, other.sizeNum);
+        std::swap(growthLeft, other.growthLeft);
+        std::swap(hash, other.hash);
+        std::swap(equal, other.equal);
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    std::pair<typename FlatHashTable<Policy, Hash, KeyEqual>::iterator, bool> FlatHashTable<Policy, Hash, KeyEqual>::insert(const value_type& value)
+    {
+        return EmplaceUnique(Policy::GetKey(value), value);
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    std::pair<typename FlatHashTable<Policy, Hash, KeyEqual>::iterator, bool> FlatHashTable<Policy, Hash, KeyEqual>::insert(value_type&& value)
+    {
+        return EmplaceUnique(Policy::GetKey(value), std::move(value));
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <typename InputIt>
+    void FlatHashTable<Policy, Hash, KeyEqual>::insert(InputIt first, InputIt last)
+    {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+            reserve(sizeNum + static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    void FlatHashTable<Policy, Hash, KeyEqual>::insert(std::initializer_list<value_type> inList)
+    {
+        insert(inList.begin(), inList.end());
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <typename... Args>
+    std::pair<typename FlatHashTable<Policy, Hash, KeyEqual>::iterator, bool> FlatHashTable<Policy, Hash, KeyEqual>::emplace(Args&&... args)
+    {
+        // key is only known after construction, build the element aside and move it in if the key is new
+        value_type value(std::forward<Args>(args)...);
+        return EmplaceUnique(Policy::GetKey(value), std::move(value));
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <typename K>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::iterator FlatHashTable<Policy, Hash, KeyEqual>::find(const KeyArg<K>& key)
+    {
+        return IteratorAt(FindIndex(key, HashOf(key)));
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <typename K>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::const_iterator FlatHashTable<Policy, Hash, KeyEqual>::find(const KeyArg<K>& key) const
+    {
+        return IteratorAt(FindIndex(key, HashOf(key)));
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <typename K>
+    bool FlatHashTable<Policy, Hash, KeyEqual>::contains(const KeyArg<K>& key) const
+    {
+        return FindIndex(key, HashOf(key)) != capacityNum;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <typename K>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::count(const KeyArg<K>& key) const
+    {
+        return contains<K>(key) ? 1 : 0;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <typename K>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::erase(const KeyArg<K>& key)
+    {
+        const size_t index = FindIndex(key, HashOf(key));
+        if (index == capacityNum) {
+            return 0;
+        }
+        EraseAt(index);
+        return 1;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::iterator FlatHashTable<Policy, Hash, KeyEqual>::erase(const_iterator iter)
+    {
+        const auto index = static_cast<size_t>(iter.slot - slots);
+        iterator next(iter.ctrl, iter.slot);
+        ++next;
+        EraseAt(index);
+        return next;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::iterator FlatHashTable<Policy, Hash, KeyEqual>::erase(iterator iter)
+    {
+        return erase(const_iterator(iter));
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    bool FlatHashTable<Policy, Hash, KeyEqual>::operator==(const FlatHashTable& rhs) const
+    {
+        if (sizeNum != rhs.sizeNum) {
+            return false;
+        }
+        for (const auto& value : *this) {
+            auto iter = rhs.find(Policy::GetKey(value));
+            if (iter == rhs.end() || !(*iter == value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <typename K>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::HashOf(const K& key) const
+    {
+        return MixHash(hash(key));
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <typename K>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::FindIndex(const K& key, size_t hashValue) const
+    {
+        if (capacityNum == 0) {
+            return capacityNum;
+        }
+
+        // triangular probing over groups visits every group once when the group count is power of two
+        const auto h2 = static_cast<HashCtrl>(hashValue & 0x7f);
+        const size_t groupMask = capacityNum / hashGroupWidth - 1;
+        size_t group = (hashValue >> 7) & groupMask;
+        for (size_t step = 1; ; step++) {
+            const size_t base = group * hashGroupWidth;
+            const HashGroup hashGroup(ctrl + base);
+            for (uint32_t mask = hashGroup.Match(h2); mask != 0; mask &= mask - 1) {
+                const size_t index = base + std::countr_zero(mask);
+                if (equal(Policy::GetKey(slots[index]), key)) {
+                    return index;
+                }
+            }
+            if (hashGroup.MatchEmpty() != 0) {
+                return capacityNum;
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::PrepareInsert(size_t hashValue)
+    {
+        size_t index = capacityNum == 0 ? 0 : FindFreeSlot(hashValue);
+        // reusing a tombstone does not consume growth
+        if (capacityNum == 0 || (growthLeft == 0 && ctrl[index] != hashCtrlDeleted)) {
+            Grow();
+            index = FindFreeSlot(hashValue);
+        }
+        return index;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    void FlatHashTable<Policy, Hash, KeyEqual>::CommitInsert(size_t index, size_t hashValue)
+    {
+        if (ctrl[index] == hashCtrlEmpty) {
+            growthLeft--;
+        }
+        ctrl[index] = static_cast<HashCtrl>(hashValue & 0x7f);
+        sizeNum++;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    template <typename K, typename... Args>
+    std::pair<typename FlatHashTable<Policy, Hash, KeyEqual>::iterator, bool> FlatHashTable<Policy, Hash, KeyEqual>::EmplaceUnique(const K& key, Args&&... args)
+    {
+        const size_t hashValue = HashOf(key);
+        if (const size_t index = FindIndex(key, hashValue); index != capacityNum) {
+            return { IteratorAt(index), false };
+        }
+
+        const size_t index = PrepareInsert(hashValue);
+        new (slots + index) value_type(std::forward<Args>(args)...);
+        CommitInsert(index, hashValue);
+        return { IteratorAt(index), true };
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::iterator FlatHashTable<Policy, Hash, KeyEqual>::IteratorAt(size_t index)
+    {
+        return iterator(ctrl + index, slots + index);
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    typename FlatHashTable<Policy, Hash, KeyEqual>::const_iterator FlatHashTable<Policy, Hash, KeyEqual>::IteratorAt(size_t index) const
+    {
+        return const_iterator(ctrl + index, slots + index);
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::MaxLoad(size_t inCapacity)
+    {
+        return inCapacity - inCapacity / 8;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::CapacityFor(size_t count)
+    {
+        size_t result = hashGroupWidth;
+        while (MaxLoad(result) < count) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::CtrlBytes(size_t inCapacity)
+    {
+        // one more byte for the sentinel, slots start at the next aligned address
+        const size_t alignment = alignof(value_type);
+        return (inCapacity + 1 + alignment - 1) / alignment * alignment;
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::AllocationAlignment()
+    {
+        return std::max(alignof(value_type), hashGroupWidth);
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    size_t FlatHashTable<Policy, Hash, KeyEqual>::FindFreeSlot(size_t hashValue) const
+    {
+        const size_t groupMask = capacityNum / hashGroupWidth - 1;
+        size_t group = (hashValue >> 7) & groupMask;
+        for (size_t step = 1; ; step++) {
+            const size_t base = group * hashGroupWidth;
+            if (const uint32_t mask = HashGroup(ctrl + base).MatchEmptyOrDeleted(); mask != 0) {
+                return base + std::countr_zero(mask);
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    void FlatHashTable<Policy, Hash, KeyEqual>::EraseAt(size_t index)
+    {
+        slots[index].~value_type();
+        sizeNum--;
+
+        // probes stop at the first group with an empty slot, if this group already has one no probe passes through it,
+        // so the slot can become empty again instead of leaving a tombstone
+        if (HashGroup(ctrl + index / hashGroupWidth * hashGroupWidth).MatchEmpty() != 0) {
+            ctrl[index] = hashCtrlEmpty;
+            growthLeft++;
+        } else {
+            ctrl[index] = hashCtrlDeleted;
+        }
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    void FlatHashTable<Policy, Hash, KeyEqual>::Grow()
+    {
+        // a table mostly filled by tombstones is rehashed in place instead of doubled
+        if (capacityNum != 0 && sizeNum < MaxLoad(capacityNum) / 2) {
+            Resize(capacityNum);
+        } else {
+            Resize(capacityNum == 0 ? hashGroupWidth : capacityNum * 2);
+        }
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    void FlatHashTable<Policy, Hash, KeyEqual>::Resize(size_t newCapacity)
+    {
+        Assert(newCapacity % hashGroupWidth == 0 && std::has_single_bit(newCapacity));
+
+        HashCtrl* oldCtrl = ctrl;
+        value_type* oldSlots = slots;
+        const size_t oldCapacity = capacityNum;
+
+        const size_t ctrlBytes = CtrlBytes(newCapacity);
+        auto* memory = static_cast<std::byte*>(::operator new(ctrlBytes + newCapacity * sizeof(value_type), std::align_val_t(AllocationAlignment())));
+        ctrl = reinterpret_cast<HashCtrl*>(memory);
+        slots = reinterpret_cast<value_type*>(memory + ctrlBytes);
+        capacityNum = newCapacity;
+        growthLeft = MaxLoad(newCapacity) - sizeNum;
+        std::fill(ctrl, ctrl + newCapacity, hashCtrlEmpty);
+        ctrl[newCapacity] = hashCtrlSentinel;
+
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldCtrl[i] < 0) {
+                continue;
+            }
+            const size_t hashValue = HashOf(Policy::GetKey(oldSlots[i]));
+            const size_t index = FindFreeSlot(hashValue);
+            Policy::Relocate(slots + index, oldSlots + i);
+            ctrl[index] = static_cast<HashCtrl>(hashValue & 0x7f);
+        }
+
+        if (oldCtrl != nullptr) {
+            ::operator delete(oldCtrl, std::align_val_t(AllocationAlignment()));
+        }
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    void FlatHashTable<Policy, Hash, KeyEqual>::DestroyAll()
+    {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_t i = 0; i < capacityNum; i++) {
+                if (ctrl[i] >= 0) {
+                    slots[i].~value_type();
+                }
+            }
+        }
+    }
+
+    template <typename Policy, typename Hash, typename KeyEqual>
+    void FlatHashTable<Policy, Hash, KeyEqual>::Deallocate()
+    {
+        if (ctrl != nullptr) {
+            ::operator delete(ctrl, std::align_val_t(AllocationAlignment()));
+        }
+        ctrl = nullptr;
+        slots = nullptr;
+        capacityNum = 0;
+        sizeNum = 0;
+        growthLeft = 0;
+    }
+}
+
+namespace Common {
+    inline size_t StringHash::operator()(std::string_view value) const
+    {
+        return std::hash<std::string_view> {}(value);
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename... Args>
+    std::pair<typename FlatHashMap<K, V, Hash, KeyEqual>::iterator, bool> FlatHashMap<K, V, Hash, KeyEqual>::try_emplace(const K& key, Args&&... args)
+    {
+        return Base::EmplaceUnique(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename... Args>
+    std::pair<typename FlatHashMap<K, V, Hash, KeyEqual>::iterator, bool> FlatHashMap<K, V, Hash, KeyEqual>::try_emplace(K&& key, Args&&... args)
+    {
+        // key is only moved from when the element gets constructed, which happens after the lookup
+        return Base::EmplaceUnique(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename M>
+    std::pair<typename FlatHashMap<K, V, Hash, KeyEqual>::iterator, bool> FlatHashMap<K, V, Hash, KeyEqual>::insert_or_assign(const K& key, M&& value)
+    {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename M>
+    std::pair<typename FlatHashMap<K, V, Hash, KeyEqual>::iterator, bool> FlatHashMap<K, V, Hash, KeyEqual>::insert_or_assign(K&& key, M&& value)
+    {
+        auto result = try_emplace(std::move(key), std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    V& FlatHashMap<K, V, Hash, KeyEqual>::operator[](const K& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    V& FlatHashMap<K, V, Hash, KeyEqual>::operator[](K&& key)
+    {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename T>
+    V& FlatHashMap<K, V, Hash, KeyEqual>::at(const KeyArg<T>& key)
+    {
+        auto iter = Base::template find<T>(key);
+        AssertWithReason(iter != Base::end(), "key not found");
+        return iter->second;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename T>
+    const V& FlatHashMap<K, V, Hash, KeyEqual>::at(const KeyArg<T>& key) const
+    {
+        auto iter = Base::template find<T>(key);
+        AssertWithReason(iter != Base::end(), "key not found");
+        return iter->second;
+    }
+}
@@ -0,0 +1,161 @@
+//
+// Created by johnk on 2024/3/2.
+//
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+
+#include <Common/Utility.h>
+#include <Common/Concurrent.h>
+
+namespace Common {
+    class JobSystem;
+
+    // counts unfinished jobs, jobs scheduled with a counter as dependency run only after it drops to zero
+    class JobCounter {
+    public:
+        JobCounter();
+        ~JobCounter();
+        NonCopyable(JobCounter)
+
+        bool Finished() const;
+
+    private:
+        friend class JobSystem;
+
+        void Increment();
+        void Decrement();
+
+        std::atomic<uint32_t> value;
+        mutable std::mutex mutex;
+        std::vector<std::function<void()>> continuations;
+    };
+
+    struct JobSystemDesc {
+        // 0 means std::thread::hardware_concurrency()
+        uint32_t threadNum = 0;
+        // empty means no pinning, otherwise worker i is pinned to coreAffinities[i % coreAffinities.size()]
+        std::vector<uint32_t> coreAffinities;
+    };
+
+    // the process wide instance is Core::JobSystem::Get(), Common is linked into every module so it can not own a singleton
+    class JobSystem {
+    public:
+        explicit JobSystem(const JobSystemDesc& inDesc);
+        ~JobSystem();
+        NonCopyable(JobSystem)
+
+        // counter is incremented now and decremented once job finished, job starts only after dependency finished
+        void Schedule(std::function<void()> job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+        // blocks until counter finished, the calling thread executes other jobs in the meantime, so it is safe to call in a job
+        void Wait(const JobCounter& counter);
+        size_t GetThreadNum() const;
+        // returns worker id in [0, GetThreadNum()) on workers of this job system, GetThreadNum() on any other thread
+        size_t GetCurrentWorkerSlot() const;
+
+        // same usage as ThreadPool::EmplaceTask
+        template <typename F, typename... Args>
+        auto EmplaceTask(F&& task, Args&&... args);
+
+        // splits [0, count) into chunks of grainSize elements and blocks until all chunks finished
+        template <typename F>
+        void ParallelFor(size_t count, size_t grainSize, F&& func);
+
+        // map(begin, end) produces a chunk result, chunk results are reduced in chunk order, so the result does not depend on scheduling
+        template <typename T, typename M, typename R>
+        T ParallelReduce(size_t count, size_t grainSize, T identity, M&& map, R&& reduce);
+
+    private:
+        struct Job {
+            std::function<void()> func;
+            JobCounter* counter = nullptr;
+        };
+
+        struct alignas(64) WorkerQueue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        void Push(Job&& job);
+        bool TryTake(size_t slot, Job& outJob);
+        bool TrySteal(size_t thief, Job& outJob);
+        void Execute(Job& job);
+        void WorkerLoop(size_t slot);
+
+        std::atomic<bool> stop;
+        std::atomic<size_t> pendingNum;
+        std::atomic<uint32_t> sleepingNum;
+        std::mutex mutex;
+        std::condition_variable condition;
+        // one queue per worker, the last one is shared by threads outside the job system
+        std::unique_ptr<WorkerQueue[]> queues;
+        size_t threadNum;
+        std::vector<uint32_t> coreAffinities;
+        std::vector<NamedThread> threads;
+    };
+}
+
+namespace Common {
+    template <typename F, typename... Args>
+    auto JobSystem::EmplaceTask(F&& task, Args&&... args)
+    {
+        using RetType = std::invoke_result_t<F, Args...>;
+        auto packagedTask = std::make_shared<std::packaged_task<RetType()>>(std::bind(std::forward<F>(task), std::forward<Args>(args)...));
+        auto result = packagedTask->get_future();
+        Schedule([packagedTask]() -> void { (*packagedTask)(); });
+        return result;
+    }
+
+    template <typename F>
+    void JobSystem::ParallelFor(size_t count, size_t grainSize, F&& func)
+    {
+        if (count == 0) {
+            return;
+        }
+
+        grainSize = std::max<size_t>(grainSize, 1);
+        const size_t chunkNum = (count + grainSize - 1) / grainSize;
+        if (chunkNum == 1) {
+            func(0, count);
+            return;
+        }
+
+        // the calling thread takes the first chunk itself instead of idling in Wait()
+        JobCounter counter;
+        for (size_t i = 1; i < chunkNum; i++) {
+            Schedule([&func, i, count, grainSize]() -> void {
+                func(i * grainSize, std::min<size_t>(count, (i + 1) * grainSize));
+            }, &counter);
+        }
+        func(0, grainSize);
+        Wait(counter);
+    }
+
+    template <typename T, typename M, typename R>
+    T JobSystem::ParallelReduce(size_t count, size_t grainSize, T identity, M&& map, R&& reduce)
+    {
+        grainSize = std::max<size_t>(grainSize, 1);
+        const size_t chunkNum = (count + grainSize - 1) / grainSize;
+        std::vector<T> chunkResults(chunkNum, identity);
+        ParallelFor(count, grainSize, [&](size_t begin, size_t end) -> void {
+            chunkResults[begin / grainSize] = map(begin, end);
+        });
+
+        T result = std::move(identity);
+        for (auto& chunkResult : chunkResults) {
+            result = reduce(std::move(result), std::move(chunkResult));
+        }
+        return result;
+    }
+}
@@ -6,27 +6,33 @@
 
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 
 #include <Common/Utility.h>
 
 namespace Common {
-    template <typename T>
+    template <typename T, typename D = std::default_delete<T>>
     class UniqueRef {
     public:
         NonCopyable(UniqueRef)
         UniqueRef(T* pointer) : ref(pointer) {} // NOLINT
-        UniqueRef(std::unique_ptr<T>&& inRef) : ref(std::move(inRef)) {} // NOLINT
+        UniqueRef(std::unique_ptr<T, D>&& inRef) : ref(std::move(inRef)) {} // NOLINT
         UniqueRef(UniqueRef&& other) noexcept : ref(std::move(other.ref)) {} // NOLINT
         UniqueRef() = default;
         ~UniqueRef() = default;
 
         UniqueRef& operator=(T* pointer)
         {
-            ref = std::unique_ptr<T>(pointer);
+            ref = std::unique_ptr<T, D>(pointer);
             return *this;
         }
 
-        UniqueRef& operator=(std::unique_ptr<T>&& inRef)
+        UniqueRef& operator=(std::unique_ptr<T, D>&& inRef)
         {
             ref = std::move(inRef);
             return *this;
@@ -69,7 +75,7 @@ namespace Common {
         }
 
     private:
-        std::unique_ptr<T> ref;
+        std::unique_ptr<T, D> ref;
     };
 
     template <typename T>
@@ -234,4 +240,758 @@ namespace Common {
     {
         return Common::SharedRef<T>(new T(std::forward<Args>(args)...));
     }
+
+    struct AtomicRefCountPolicy {
+        using Counter = std::atomic<uint32_t>;
+        template <typename P> using Pointer = std::atomic<P*>;
+        using Mutex = std::mutex;
+    };
+
+    // for objects never shared across threads, ref count operations become plain increments
+    struct NonAtomicRefCountPolicy {
+        struct NullMutex {
+            void lock() {}
+            void unlock() {}
+        };
+
+        using Counter = uint32_t;
+        template <typename P> using Pointer = P*;
+        using Mutex = NullMutex;
+    };
+
+    namespace Internal {
+        inline bool IncrementIfNotZero(std::atomic<uint32_t>& counter)
+        {
+            uint32_t value = counter.load();
+            while (value != 0) {
+                if (counter.compare_exchange_weak(value, value + 1)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        inline bool IncrementIfNotZero(uint32_t& counter)
+        {
+            if (counter == 0) {
+                return false;
+            }
+            counter++;
+            return true;
+        }
+
+        template <typename P>
+        bool CompareExchange(std::atomic<P*>& target, P*& expected, P* desired)
+        {
+            return target.compare_exchange_strong(expected, desired);
+        }
+
+        template <typename P>
+        bool CompareExchange(P*& target, P*& expected, P* desired)
+        {
+            if (target != expected) {
+                expected = target;
+                return false;
+            }
+            target = desired;
+            return true;
+        }
+    }
+
+    // intrusive ref counted base, object and strong count share one allocation, the weak control block is only allocated
+    // once the first IntrusiveWeakRef of the object is created
+    template <typename Policy = AtomicRefCountPolicy>
+    class RefCounted {
+    public:
+        class WeakControl {
+        public:
+            explicit WeakControl(const RefCounted* inObject) : refCount(1), object(inObject) {}
+
+            void AddRef()
+            {
+                ++refCount;
+            }
+
+            void Release()
+            {
+                if (--refCount == 0) {
+                    delete this;
+                }
+            }
+
+            // adds a strong ref only if object is still alive
+            bool TryAddStrongRef()
+            {
+                std::unique_lock<typename Policy::Mutex> lock(mutex);
+                return object != nullptr && Internal::IncrementIfNotZero(object->strongCount);
+            }
+
+            bool Expired()
+            {
+                std::unique_lock<typename Policy::Mutex> lock(mutex);
+                return object == nullptr || object->GetRefCount() == 0;
+            }
+
+        private:
+            friend class RefCounted;
+
+            typename Policy::Counter refCount;
+            typename Policy::Mutex mutex;
+            const RefCounted* object;
+        };
+
+        RefCounted() : strongCount(0), weakControl(nullptr) {}
+        RefCounted(const RefCounted&) : strongCount(0), weakControl(nullptr) {}
+        RefCounted& operator=(const RefCounted&) { return *this; } // NOLINT
+        virtual ~RefCounted() = default;
+
+        void AddRef() const
+        {
+            ++strongCount;
+        }
+
+        void Release() const
+        {
+            if (--strongCount != 0) {
+                return;
+            }
+            if (WeakControl* control = weakControl; control != nullptr) {
+                // weak refs lock the control block before touching strong count, so nobody can revive the object after this
+                {
+                    std::unique_lock<typename Policy::Mutex> lock(control->mutex);
+                    control->object = nullptr;
+                }
+                control->Release();
+            }
+            delete this;
+        }
+
+        uint32_t GetRefCount() const
+        {
+            return strongCount;
+        }
+
+        // must be called while holding a strong ref
+        WeakControl* GetWeakControl() const
+        {
+            WeakControl* control = weakControl;
+            if (control != nullptr) {
+                return control;
+            }
+            auto* newControl = new WeakControl(this);
+            if (Internal::CompareExchange<WeakControl>(weakControl, control, newControl)) {
+                return newControl;
+            }
+            delete newControl;
+            return control;
+        }
+
+    private:
+        mutable typename Policy::Counter strongCount;
+        mutable typename Policy::template Pointer<WeakControl> weakControl;
+    };
+
+    template <typename T>
+    class IntrusiveWeakRef;
+
+    // same usage as SharedRef, T must derive from RefCounted
+    template <typename T>
+    class IntrusiveRef {
+    public:
+        template <typename T2> IntrusiveRef(const IntrusiveRef<T2>& other) : IntrusiveRef(other.Get()) {} // NOLINT
+        template <typename T2> IntrusiveRef(IntrusiveRef<T2>&& other) noexcept : pointer(other.Detach()) {} // NOLINT
+        IntrusiveRef(T* inPointer) : pointer(inPointer) { AddRef(); } // NOLINT
+        IntrusiveRef(const IntrusiveRef& other) : IntrusiveRef(other.pointer) {} // NOLINT
+        IntrusiveRef(IntrusiveRef&& other) noexcept : pointer(other.Detach()) {} // NOLINT
+        IntrusiveRef() : pointer(nullptr) {}
+        ~IntrusiveRef() { ReleaseRef(); }
+
+        IntrusiveRef& operator=(T* inPointer)
+        {
+            Reset(inPointer);
+            return *this;
+        }
+
+        IntrusiveRef& operator=(const IntrusiveRef& other)
+        {
+            Reset(other.pointer);
+            return *this;
+        }
+
+        IntrusiveRef& operator=(IntrusiveRef&& other) noexcept
+        {
+            if (this != &other) {
+                ReleaseRef();
+                pointer = other.Detach();
+            }
+            return *this;
+        }
+
+        T* operator->() const noexcept
+        {
+            return pointer;
+        }
+
+        T& operator*() const noexcept
+        {
+            return *pointer;
+        }
+
+        bool operator==(nullptr_t) const noexcept
+        {
+            return pointer == nullptr;
+        }
+
+        bool operator!=(nullptr_t) const noexcept
+        {
+            return pointer != nullptr;
+        }
+
+        T* Get() const
+        {
+            return pointer;
+        }
+
+        void Reset(T* inPointer = nullptr)
+        {
+            // add before release, so resetting to the same object never drops it
+            T* oldPointer = pointer;
+            pointer = inPointer;
+            AddRef();
+            if (oldPointer != nullptr) {
+                oldPointer->Release();
+            }
+        }
+
+        auto RefCount() const
+        {
+            return pointer == nullptr ? 0 : pointer->GetRefCount();
+        }
+
+        template <typename T2>
+        IntrusiveRef<T2> StaticCast()
+        {
+            return IntrusiveRef<T2>(static_cast<T2*>(pointer));
+        }
+
+        template <typename T2>
+        IntrusiveRef<T2> DynamicCast()
+        {
+            return IntrusiveRef<T2>(dynamic_cast<T2*>(pointer));
+        }
+
+        template <typename T2>
+        IntrusiveRef<T2> ReinterpretCast()
+        {
+            return IntrusiveRef<T2>(reinterpret_cast<T2*>(pointer));
+        }
+
+        // gives up ownership without releasing the ref
+        T* Detach()
+        {
+            T* result = pointer;
+            pointer = nullptr;
+            return result;
+        }
+
+    private:
+        template <typename T2> friend class IntrusiveWeakRef;
+
+        struct AdoptTag {};
+
+        IntrusiveRef(T* inPointer, AdoptTag) : pointer(inPointer) {}
+
+        void AddRef()
+        {
+            if (pointer != nullptr) {
+                pointer->AddRef();
+            }
+        }
+
+        void ReleaseRef()
+        {
+            if (pointer != nullptr) {
+                pointer->Release();
+                pointer = nullptr;
+            }
+        }
+
+        T* pointer;
+    };
+
+    template <typename T>
+    class IntrusiveWeakRef {
+    public:
+        template <typename T2> IntrusiveWeakRef(const IntrusiveRef<T2>& inRef) : pointer(inRef.Get()), control(nullptr) { Acquire(); } // NOLINT
+        IntrusiveWeakRef(const IntrusiveWeakRef& other) : pointer(other.pointer), control(other.control) { AddRef(); } // NOLINT
+        IntrusiveWeakRef(IntrusiveWeakRef&& other) noexcept : pointer(other.pointer), control(other.control) // NOLINT
+        {
+            other.pointer = nullptr;
+            other.control = nullptr;
+        }
+        IntrusiveWeakRef() : pointer(nullptr), control(nullptr) {}
+        ~IntrusiveWeakRef() { Reset(); }
+
+        template <typename T2>
+        IntrusiveWeakRef& operator=(const IntrusiveRef<T2>& inRef)
+        {
+            Reset();
+            pointer = inRef.Get();
+            Acquire();
+            return *this;
+        }
+
+        IntrusiveWeakRef& operator=(const IntrusiveWeakRef& other)
+        {
+            if (this != &other) {
+                Reset();
+                pointer = other.pointer;
+                control = other.control;
+                AddRef();
+            }
+            return *this;
+        }
+
+        IntrusiveWeakRef& operator=(IntrusiveWeakRef&& other) noexcept
+        {
+            if (this != &other) {
+                Reset();
+                pointer = other.pointer;
+                control = other.control;
+                other.pointer = nullptr;
+                other.control = nullptr;
+            }
+            return *this;
+        }
+
+        void Reset()
+        {
+            if (control != nullptr) {
+                control->Release();
+            }
+            pointer = nullptr;
+            control = nullptr;
+        }
+
+        bool Expired() const
+        {
+            return control == nullptr || control->Expired();
+        }
+
+        IntrusiveRef<T> Lock() const
+        {
+            if (control == nullptr || !control->TryAddStrongRef()) {
+                return nullptr;
+            }
+            return IntrusiveRef<T>(pointer, typename IntrusiveRef<T>::AdoptTag {});
+        }
+
+    private:
+        using WeakControl = typename T::WeakControl;
+
+        void Acquire()
+        {
+            if (pointer != nullptr) {
+                control = pointer->GetWeakControl();
+                AddRef();
+            }
+        }
+
+        void AddRef()
+        {
+            if (control != nullptr) {
+                control->AddRef();
+            }
+        }
+
+        T* pointer;
+        WeakControl* control;
+    };
+
+    template <typename T, typename... Args>
+    Common::IntrusiveRef<T> MakeIntrusive(Args&&... args)
+    {
+        return Common::IntrusiveRef<T>(new T(std::forward<Args>(args)...));
+    }
+
+    // bump allocator over one fixed block, Allocate() returns nullptr once block is exhausted, memory is only released by Reset() or Rewind()
+    class LinearAllocator {
+    public:
+        explicit LinearAllocator(size_t inCapacity);
+        LinearAllocator(LinearAllocator&& other) noexcept;
+        ~LinearAllocator();
+        NonCopyable(LinearAllocator)
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        size_t GetMarker() const;
+        void Rewind(size_t marker);
+        void Reset();
+        size_t GetCapacity() const;
+        size_t GetUsedSize() const;
+
+    private:
+        std::byte* memory;
+        size_t capacity;
+        size_t offset;
+    };
+
+    // growable chain of linear blocks, Reset() and Rewind() keep blocks for reuse, so a warmed up arena stops touching the heap
+    class ArenaAllocator {
+    public:
+        static constexpr size_t defaultBlockSize = 64 * 1024;
+
+        struct Marker {
+            size_t blockIndex;
+            size_t offset;
+        };
+
+        explicit ArenaAllocator(size_t inBlockSize = defaultBlockSize);
+        ArenaAllocator(ArenaAllocator&& other) noexcept;
+        ~ArenaAllocator();
+        NonCopyable(ArenaAllocator)
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        Marker GetMarker() const;
+        void Rewind(const Marker& marker);
+        void Reset();
+        size_t GetBlockNum() const;
+        size_t GetUsedSize() const;
+
+    private:
+        size_t blockSize;
+        size_t current;
+        std::vector<LinearAllocator> blocks;
+    };
+
+    // double buffered arena, memory allocated in a frame stays valid until the end of the next frame, so it can be handed to a frame in flight
+    class FrameAllocator {
+    public:
+        explicit FrameAllocator(size_t inBlockSize = ArenaAllocator::defaultBlockSize);
+        ~FrameAllocator();
+        NonCopyable(FrameAllocator)
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        // call once per frame, releases everything allocated two frames ago
+        void NextFrame();
+        size_t GetUsedSize() const;
+
+    private:
+        uint8_t index;
+        ArenaAllocator arenas[2];
+    };
+
+    // per thread scratch memory, everything allocated through a scope is released when the scope ends, scopes nest in lifo order
+    class ScratchScope {
+    public:
+        ScratchScope();
+        ~ScratchScope();
+        NonCopyable(ScratchScope)
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        ArenaAllocator& GetArena();
+
+    private:
+        static ArenaAllocator& GetThreadArena();
+
+        ArenaAllocator& arena;
+        ArenaAllocator::Marker marker;
+    };
+
+    // stl compatible adapter over any allocator above, deallocate is a no-op, memory is released by the underlying allocator
+    template <typename T, typename A>
+    class StlAllocator {
+    public:
+        using value_type = T;
+
+        StlAllocator(A& inAllocator) : allocator(&inAllocator) {} // NOLINT
+        template <typename U> StlAllocator(const StlAllocator<U, A>& other) : allocator(other.GetAllocator()) {} // NOLINT
+
+        T* allocate(size_t n)
+        {
+            void* result = allocator->Allocate(n * sizeof(T), alignof(T));
+            if (result == nullptr) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(result);
+        }
+
+        void deallocate(T*, size_t) {}
+
+        A* GetAllocator() const
+        {
+            return allocator;
+        }
+
+        template <typename U>
+        bool operator==(const StlAllocator<U, A>& rhs) const
+        {
+            return allocator == rhs.GetAllocator();
+        }
+
+        template <typename U>
+        bool operator!=(const StlAllocator<U, A>& rhs) const
+        {
+            return allocator != rhs.GetAllocator();
+        }
+
+    private:
+        A* allocator;
+    };
+
+    template <typename T> using FrameStlAllocator = StlAllocator<T, FrameAllocator>;
+    template <typename T> using ArenaStlAllocator = StlAllocator<T, ArenaAllocator>;
+    template <typename T> using ScratchStlAllocator = StlAllocator<T, ScratchScope>;
+
+    // process wide pool of fixed size blocks, every thread keeps a small free list of its own and trades whole batches with the
+    // global free list, so the global lock is taken once per batchSize allocations at most
+    template <size_t BlockSize, size_t Alignment>
+    class FixedSizePool {
+    public:
+        static constexpr size_t blockSize = BlockSize;
+        static constexpr size_t batchSize = std::max<size_t>(64 * 1024 / BlockSize / 4, 8);
+        static constexpr size_t chunkBatchNum = 4;
+
+        static void* Allocate();
+        static void Deallocate(void* pointer);
+
+    private:
+        struct FreeNode {
+            FreeNode* next;
+        };
+
+        struct Batch {
+            FreeNode* head;
+            size_t count;
+        };
+
+        struct GlobalList {
+            ~GlobalList();
+
+            std::mutex mutex;
+            std::vector<Batch> batches;
+            std::vector<void*> chunks;
+        };
+
+        struct ThreadCache {
+            ~ThreadCache();
+
+            FreeNode* head = nullptr;
+            size_t count = 0;
+        };
+
+        static GlobalList& GetGlobalList();
+        static ThreadCache& GetThreadCache();
+        static void Refill(ThreadCache& cache);
+        static void ReturnBatch(ThreadCache& cache, size_t count);
+    };
+
+    namespace Internal {
+        template <typename T>
+        struct PoolSizeClass {
+            static constexpr size_t alignment = std::max(alignof(T), alignof(void*));
+            // round up to 16 bytes so that types of similar size share one pool
+            static constexpr size_t size = (std::max(sizeof(T), sizeof(void*)) + 15) / 16 * 16;
+            using Pool = FixedSizePool<(size + alignment - 1) / alignment * alignment, alignment>;
+        };
+    }
+
+    // objects of T live in the size class pool of T, so pooled objects must be deleted with their exact type
+    template <typename T>
+    class ObjectPool {
+    public:
+        template <typename... Args>
+        static T* New(Args&&... args);
+        static void Delete(T* object);
+    };
+
+    template <typename T>
+    struct PoolDeleter {
+        void operator()(T* object) const
+        {
+            ObjectPool<T>::Delete(object);
+        }
+    };
+
+    // single element allocations come from the size class pool, which also covers control blocks of std::allocate_shared
+    template <typename T>
+    class PoolStlAllocator {
+    public:
+        using value_type = T;
+
+        PoolStlAllocator() = default;
+        template <typename U> PoolStlAllocator(const PoolStlAllocator<U>&) {} // NOLINT
+
+        T* allocate(size_t n)
+        {
+            if (n == 1) {
+                return static_cast<T*>(Internal::PoolSizeClass<T>::Pool::Allocate());
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        void deallocate(T* pointer, size_t n)
+        {
+            if (n == 1) {
+                Internal::PoolSizeClass<T>::Pool::Deallocate(pointer);
+                return;
+            }
+            ::operator delete(pointer, std::align_val_t(alignof(T)));
+        }
+
+        template <typename U>
+        bool operator==(const PoolStlAllocator<U>&) const
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const PoolStlAllocator<U>&) const
+        {
+            return false;
+        }
+    };
+
+    template <typename T> using PooledUniqueRef = UniqueRef<T, PoolDeleter<T>>;
+
+    template <typename T, typename... Args>
+    PooledUniqueRef<T> MakePooledUnique(Args&&... args)
+    {
+        return std::unique_ptr<T, PoolDeleter<T>>(ObjectPool<T>::New(std::forward<Args>(args)...));
+    }
+
+    template <typename T, typename... Args>
+    SharedRef<T> MakePooledShared(Args&&... args)
+    {
+        return std::allocate_shared<T>(PoolStlAllocator<T>(), std::forward<Args>(args)...);
+    }
+}
+
+namespace Common {
+    template <size_t BlockSize, size_t Alignment>
+    FixedSizePool<BlockSize, Alignment>::GlobalList::~GlobalList()
+    {
+        for (void* chunk : chunks) {
+            ::operator delete(chunk, std::align_val_t(Alignment));
+        }
+    }
+
+    template <size_t BlockSize, size_t Alignment>
+    FixedSizePool<BlockSize, Alignment>::ThreadCache::~ThreadCache()
+    {
+        if (count > 0) {
+            ReturnBatch(*this, count);
+        }
+    }
+
+    template <size_t BlockSize, size_t Alignment>
+    void* FixedSizePool<BlockSize, Alignment>::Allocate()
+    {
+        auto& cache = GetThreadCache();
+        if (cache.head == nullptr) {
+            Refill(cache);
+        }
+        FreeNode* node = cache.head;
+        cache.head = node->next;
+        cache.count--;
+        return node;
+    }
+
+    template <size_t BlockSize, size_t Alignment>
+    void FixedSizePool<BlockSize, Alignment>::Deallocate(void* pointer)
+    {
+        auto& cache = GetThreadCache();
+        auto* node = static_cast<FreeNode*>(pointer);
+        node->next = cache.head;
+        cache.head = node;
+        cache.count++;
+        // keep one batch for the next allocations, hand the other one back to threads which allocate more than they free
+        if (cache.count >= batchSize * 2) {
+            ReturnBatch(cache, batchSize);
+        }
+    }
+
+    template <size_t BlockSize, size_t Alignment>
+    typename FixedSizePool<BlockSize, Alignment>::GlobalList& FixedSizePool<BlockSize, Alignment>::GetGlobalList()
+    {
+        static GlobalList globalList;
+        return globalList;
+    }
+
+    template <size_t BlockSize, size_t Alignment>
+    typename FixedSizePool<BlockSize, Alignment>::ThreadCache& FixedSizePool<BlockSize, Alignment>::GetThreadCache()
+    {
+        // thread caches of main thread are destroyed before function local statics, so they can still return blocks to global list
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+
+    template <size_t BlockSize, size_t Alignment>
+    void FixedSizePool<BlockSize, Alignment>::Refill(ThreadCache& cache)
+    {
+        auto& globalList = GetGlobalList();
+        {
+            std::unique_lock<std::mutex> lock(globalList.mutex);
+            if (!globalList.batches.empty()) {
+                const Batch batch = globalList.batches.back();
+                globalList.batches.pop_back();
+                cache.head = batch.head;
+                cache.count = batch.count;
+                return;
+            }
+        }
+
+        // carve a new chunk, first batch goes to the calling thread, the others to global list
+        auto* chunk = static_cast<std::byte*>(::operator new(BlockSize * batchSize * chunkBatchNum, std::align_val_t(Alignment)));
+        std::vector<Batch> newBatches;
+        newBatches.reserve(chunkBatchNum);
+        for (size_t i = 0; i < chunkBatchNum; i++) {
+            std::byte* batchBegin = chunk + i * batchSize * BlockSize;
+            for (size_t j = 0; j < batchSize; j++) {
+                auto* node = reinterpret_cast<FreeNode*>(batchBegin + j * BlockSize);
+                node->next = j + 1 < batchSize ? reinterpret_cast<FreeNode*>(batchBegin + (j + 1) * BlockSize) : nullptr;
+            }
+            newBatches.emplace_back(Batch { reinterpret_cast<FreeNode*>(batchBegin), batchSize });
+        }
+        cache.head = newBatches[0].head;
+        cache.count = newBatches[0].count;
+
+        std::unique_lock<std::mutex> lock(globalList.mutex);
+        globalList.chunks.emplace_back(chunk);
+        globalList.batches.insert(globalList.batches.end(), newBatches.begin() + 1, newBatches.end());
+    }
+
+    template <size_t BlockSize, size_t Alignment>
+    void FixedSizePool<BlockSize, Alignment>::ReturnBatch(ThreadCache& cache, size_t count)
+    {
+        Batch batch { cache.head, count };
+        FreeNode* tail = cache.head;
+        for (size_t i = 1; i < count; i++) {
+            tail = tail->next;
+        }
+        cache.head = tail->next;
+        cache.count -= count;
+        tail->next = nullptr;
+
+        auto& globalList = GetGlobalList();
+        std::unique_lock<std::mutex> lock(globalList.mutex);
+        globalList.batches.emplace_back(batch);
+    }
+
+    template <typename T>
+    template <typename... Args>
+    T* ObjectPool<T>::New(Args&&... args)
+    {
+        void* memory = Internal::PoolSizeClass<T>::Pool::Allocate();
+        return new (memory) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    void ObjectPool<T>::Delete(T* object)
+    {
+        if (object == nullptr) {
+            return;
+        }
+        object->~T();
+        Internal::PoolSizeClass<T>::Pool::Deallocate(object);
+    }
 }
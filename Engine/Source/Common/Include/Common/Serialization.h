@@ -8,14 +8,25 @@
 #include <string>
 #include <optional>
 #include <vector>
+#include <span>
+#include <string_view>
 #include <unordered_set>
 #include <unordered_map>
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
 
 #include <Common/Utility.h>
 #include <Common/Debug.h>
 #include <Common/Hash.h>
+#include <Common/Memory.h>
+#include <Common/Math/Half.h>
+#include <Common/Math/Vector.h>
+#include <Common/Math/Matrix.h>
 
 namespace Common {
+    class MappedFile;
+
     class SerializeStream {
     public:
         NonCopyable(SerializeStream)
@@ -33,6 +44,14 @@ namespace Common {
         virtual ~DeserializeStream();
 
         virtual void Read(void* data, size_t size) = 0;
+        // consumes size bytes without copying them out
+        virtual void Skip(size_t size);
+        // returns next size bytes without consuming them, empty if stream has no contiguous backing memory
+        virtual std::span<const uint8_t> Peek(size_t size);
+        // views (SpanView, StringView) deserialized from a zero copy stream reference memory returned by Peek() instead of owning a copy
+        virtual bool IsZeroCopy() const;
+        // held by views deserialized in zero copy mode, null if the owner of backing memory is the caller
+        virtual SharedRef<MappedFile> GetViewOwner() const;
 
     protected:
         DeserializeStream();
@@ -55,11 +74,73 @@ namespace Common {
         explicit BinaryFileDeserializeStream(const std::string& inFileName);
         ~BinaryFileDeserializeStream() override;
         void Read(void* data, size_t size) override;
+        void Skip(size_t size) override;
 
     private:
         std::ifstream file;
     };
 
+    // collects writes in a large block and hands the block to the file in one write once it is full, or on Flush() or destruction
+    class BufferedFileSerializeStream : public SerializeStream {
+    public:
+        static constexpr size_t defaultBufferSize = 1 << 20;
+
+        NonCopyable(BufferedFileSerializeStream)
+        explicit BufferedFileSerializeStream(const std::string& inFileName, size_t inBufferSize = defaultBufferSize);
+        ~BufferedFileSerializeStream() override;
+        void Write(const void* data, size_t size) override;
+        void Flush();
+
+    private:
+        std::ofstream file;
+        size_t used;
+        std::vector<uint8_t> buffer;
+    };
+
+    // read-only memory mapping of a whole file, shared between streams and objects referencing the mapped memory
+    class MappedFile {
+    public:
+        NonCopyable(MappedFile)
+        explicit MappedFile(const std::string& inFileName);
+        ~MappedFile();
+
+        bool IsValid() const;
+        const uint8_t* GetData() const;
+        size_t GetSize() const;
+
+    private:
+        bool valid;
+        const uint8_t* data;
+        size_t size;
+#if PLATFORM_WINDOWS
+        void* fileHandle;
+        void* mappingHandle;
+#endif
+    };
+
+    class MappedFileDeserializeStream : public DeserializeStream {
+    public:
+        NonCopyable(MappedFileDeserializeStream)
+        explicit MappedFileDeserializeStream(const std::string& inFileName, size_t pointerBegin = 0);
+        explicit MappedFileDeserializeStream(SharedRef<MappedFile> inFile, size_t pointerBegin = 0);
+        ~MappedFileDeserializeStream() override;
+        // false when the file could not be opened or mapped, callers should check it before reading
+        bool IsValid() const;
+        void Read(void* data, size_t size) override;
+        void Skip(size_t size) override;
+        std::span<const uint8_t> Peek(size_t size) override;
+        bool IsZeroCopy() const override;
+        SharedRef<MappedFile> GetViewOwner() const override;
+        const SharedRef<MappedFile>& GetFile() const;
+        // views keep the mapping alive, so objects deserialized in zero copy mode can outlive the stream
+        void SetZeroCopy(bool inZeroCopy);
+
+    private:
+        bool zeroCopy;
+        size_t pointer;
+        SharedRef<MappedFile> file;
+    };
+
     class ByteSerializeStream : public SerializeStream {
     public:
         NonCopyable(ByteSerializeStream)
@@ -78,12 +159,193 @@ namespace Common {
         explicit ByteDeserializeStream(const std::vector<uint8_t>& inBytes, size_t pointerBegin = 0);
         ~ByteDeserializeStream() override;
         void Read(void* data, size_t size) override;
+        void Skip(size_t size) override;
+        std::span<const uint8_t> Peek(size_t size) override;
+        bool IsZeroCopy() const override;
+        // views reference bytes directly, so bytes must outlive objects deserialized in zero copy mode
+        void SetZeroCopy(bool inZeroCopy);
 
     private:
+        bool zeroCopy;
         size_t pointer;
         const std::vector<uint8_t>& bytes;
     };
 
+    // limits reads to the next size bytes of another stream, bytes not consumed are skipped on destruction,
+    // so the parent always continues right after the bounded range. reads past the bound yield zeros and mark it overflowed
+    class BoundedDeserializeStream : public DeserializeStream {
+    public:
+        NonCopyable(BoundedDeserializeStream)
+        BoundedDeserializeStream(DeserializeStream& inStream, size_t inSize);
+        ~BoundedDeserializeStream() override;
+        void Read(void* data, size_t size) override;
+        void Skip(size_t size) override;
+        std::span<const uint8_t> Peek(size_t size) override;
+        bool IsZeroCopy() const override;
+        SharedRef<MappedFile> GetViewOwner() const override;
+        bool Overflowed() const;
+
+    private:
+        DeserializeStream& stream;
+        size_t remaining;
+        bool overflowed;
+    };
+
+    // read-only array which either owns its elements or views memory owned by someone else, e.g. a mapped asset file.
+    // serialized the same as std::vector<T>, deserializing from a zero copy stream gives a view without copying elements
+    template <typename T>
+    class SpanView {
+    public:
+        SpanView() = default;
+
+        explicit SpanView(std::vector<T> inStorage)
+            : storage(std::move(inStorage))
+            , view(storage)
+        {
+        }
+
+        explicit SpanView(std::span<const T> inView, SharedRef<MappedFile> inOwner = nullptr)
+            : view(inView)
+            , owner(std::move(inOwner))
+        {
+        }
+
+        SpanView(const SpanView& other)
+            : storage(other.storage)
+            , view(other.IsOwning() ? std::span<const T>(storage) : other.view)
+            , owner(other.owner)
+        {
+        }
+
+        SpanView(SpanView&& other) noexcept
+            : storage(std::move(other.storage))
+            , view(other.IsOwning() ? std::span<const T>(storage) : other.view)
+            , owner(std::move(other.owner))
+        {
+            other.view = {};
+        }
+
+        ~SpanView() = default;
+
+        SpanView& operator=(const SpanView& other)
+        {
+            if (this != &other) {
+                *this = SpanView(other);
+            }
+            return *this;
+        }
+
+        SpanView& operator=(SpanView&& other) noexcept
+        {
+            const bool otherOwning = other.IsOwning();
+            storage = std::move(other.storage);
+            view = otherOwning ? std::span<const T>(storage) : other.view;
+            owner = std::move(other.owner);
+            other.view = {};
+            return *this;
+        }
+
+        bool operator==(const SpanView& rhs) const
+        {
+            return std::equal(view.begin(), view.end(), rhs.view.begin(), rhs.view.end());
+        }
+
+        // empty views are treated as owning, so they never hold a owner
+        bool IsOwning() const
+        {
+            return view.empty() || view.data() == storage.data();
+        }
+
+        std::span<const T> Span() const { return view; }
+        std::vector<T> ToVector() const { return std::vector<T>(view.begin(), view.end()); }
+        const T* data() const { return view.data(); }
+        size_t size() const { return view.size(); }
+        bool empty() const { return view.empty(); }
+        const T& operator[](size_t index) const { return view[index]; }
+        auto begin() const { return view.begin(); }
+        auto end() const { return view.end(); }
+
+    private:
+        std::vector<T> storage;
+        std::span<const T> view;
+        SharedRef<MappedFile> owner;
+    };
+
+    // string counterpart of SpanView, serialized the same as std::string
+    class StringView {
+    public:
+        StringView() = default;
+
+        explicit StringView(std::string inStorage)
+            : storage(std::move(inStorage))
+            , view(storage)
+        {
+        }
+
+        explicit StringView(std::string_view inView, SharedRef<MappedFile> inOwner = nullptr)
+            : view(inView)
+            , owner(std::move(inOwner))
+        {
+        }
+
+        StringView(const StringView& other)
+            : storage(other.storage)
+            , view(other.IsOwning() ? std::string_view(storage) : other.view)
+            , owner(other.owner)
+        {
+        }
+
+        // small strings live inside std::string, so the view is always rebuilt from the moved storage
+        StringView(StringView&& other) noexcept
+            : storage(std::move(other.storage))
+            , view(other.IsOwning() ? std::string_view(storage) : other.view)
+            , owner(std::move(other.owner))
+        {
+            other.view = {};
+        }
+
+        ~StringView() = default;
+
+        StringView& operator=(const StringView& other)
+        {
+            if (this != &other) {
+                *this = StringView(other);
+            }
+            return *this;
+        }
+
+        StringView& operator=(StringView&& other) noexcept
+        {
+            const bool otherOwning = other.IsOwning();
+            storage = std::move(other.storage);
+            view = otherOwning ? std::string_view(storage) : other.view;
+            owner = std::move(other.owner);
+            other.view = {};
+            return *this;
+        }
+
+        bool operator==(const StringView& rhs) const
+        {
+            return view == rhs.view;
+        }
+
+        bool IsOwning() const
+        {
+            return view.empty() || view.data() == storage.data();
+        }
+
+        std::string_view View() const { return view; }
+        std::string ToString() const { return std::string(view); }
+        const char* data() const { return view.data(); }
+        size_t size() const { return view.size(); }
+        bool empty() const { return view.empty(); }
+
+    private:
+        std::string storage;
+        std::string_view view;
+        SharedRef<MappedFile> owner;
+    };
+
     template <typename T>
     struct Serializer {
         static constexpr bool serializable = false;
@@ -100,9 +362,17 @@ namespace Common {
         }
     };
 
+    // types whose serialized form is exactly their object representation, serializers mark them with bulkSerializable,
+    // containers of them are serialized as one header plus one contiguous block instead of a type id and a value per element
+    template <typename T>
+    concept BulkSerializable = requires { requires Serializer<T>::bulkSerializable; };
+
     template <typename T>
     requires Serializer<T>::serializable
     struct TypeIdSerializer {
+        // added to the type id of containers written in bulk layout, files written before bulk layout carry the plain type id
+        static constexpr uint32_t bulkTypeId = Serializer<T>::typeId + Common::HashUtils::StrCrc32("bulk");
+
         static void Serialize(SerializeStream& stream)
         {
             uint32_t typeId = Serializer<T>::typeId;
@@ -115,6 +385,21 @@ namespace Common {
             stream.Read(&typeId, sizeof(uint32_t));
             return typeId == Serializer<T>::typeId;
         }
+
+        static void SerializeBulk(SerializeStream& stream)
+        {
+            uint32_t typeId = bulkTypeId;
+            stream.Write(&typeId, sizeof(uint32_t));
+        }
+
+        // accepts both layouts, outBulk tells which one follows
+        static bool DeserializeWithLayout(DeserializeStream& stream, bool& outBulk)
+        {
+            uint32_t typeId;
+            stream.Read(&typeId, sizeof(uint32_t));
+            outBulk = typeId == bulkTypeId;
+            return outBulk || typeId == Serializer<T>::typeId;
+        }
     };
 }
 
@@ -122,12 +407,15 @@ namespace Common {
     template <> \
     struct Serializer<typeName> { \
         static constexpr bool serializable = true; \
+        static constexpr bool bulkSerializable = true; \
         static constexpr uint32_t typeId = Common::HashUtils::StrCrc32(#typeName); \
         \
         static void Serialize(SerializeStream& stream, const typeName& value) \
         { \
-            TypeIdSerializer<typeName>::Serialize(stream); \
-            stream.Write(&value, sizeof(typeName)); \
+            uint8_t buffer[sizeof(uint32_t) + sizeof(typeName)]; \
+            memcpy(buffer, &typeId, sizeof(uint32_t)); \
+            memcpy(buffer + sizeof(uint32_t), &value, sizeof(typeName)); \
+            stream.Write(buffer, sizeof(buffer)); \
         } \
         \
         static bool Deserialize(DeserializeStream& stream, typeName& value) \
@@ -153,6 +441,84 @@ namespace Common {
     IMPL_BASIC_TYPE_SERIALIZER(float)
     IMPL_BASIC_TYPE_SERIALIZER(double)
 
+    template <std::endian E>
+    struct Serializer<HalfFloat<E>> {
+        static constexpr bool serializable = true;
+        static constexpr bool bulkSerializable = true;
+        static constexpr uint32_t typeId = Common::HashUtils::StrCrc32("Common::HalfFloat");
+
+        static void Serialize(SerializeStream& stream, const HalfFloat<E>& value)
+        {
+            TypeIdSerializer<HalfFloat<E>>::Serialize(stream);
+            stream.Write(&value.value, sizeof(uint16_t));
+        }
+
+        static bool Deserialize(DeserializeStream& stream, HalfFloat<E>& value)
+        {
+            if (!TypeIdSerializer<HalfFloat<E>>::Deserialize(stream)) {
+                return false;
+            }
+            stream.Read(&value.value, sizeof(uint16_t));
+            return true;
+        }
+    };
+
+    template <typename T, uint8_t L>
+    requires BulkSerializable<T>
+    struct Serializer<Vector<T, L>> {
+        static_assert(sizeof(Vector<T, L>) == sizeof(T) * L);
+
+        static constexpr bool serializable = true;
+        static constexpr bool bulkSerializable = true;
+        static constexpr uint32_t typeId
+            = Common::HashUtils::StrCrc32("Common::Vector")
+            + Serializer<T>::typeId
+            + L;
+
+        static void Serialize(SerializeStream& stream, const Vector<T, L>& value)
+        {
+            TypeIdSerializer<Vector<T, L>>::Serialize(stream);
+            stream.Write(value.data, sizeof(Vector<T, L>));
+        }
+
+        static bool Deserialize(DeserializeStream& stream, Vector<T, L>& value)
+        {
+            if (!TypeIdSerializer<Vector<T, L>>::Deserialize(stream)) {
+                return false;
+            }
+            stream.Read(value.data, sizeof(Vector<T, L>));
+            return true;
+        }
+    };
+
+    template <typename T, uint8_t R, uint8_t C>
+    requires BulkSerializable<T>
+    struct Serializer<Matrix<T, R, C>> {
+        static_assert(sizeof(Matrix<T, R, C>) == sizeof(T) * R * C);
+
+        static constexpr bool serializable = true;
+        static constexpr bool bulkSerializable = true;
+        static constexpr uint32_t typeId
+            = Common::HashUtils::StrCrc32("Common::Matrix")
+            + Serializer<T>::typeId
+            + (R << 4) + C;
+
+        static void Serialize(SerializeStream& stream, const Matrix<T, R, C>& value)
+        {
+            TypeIdSerializer<Matrix<T, R, C>>::Serialize(stream);
+            stream.Write(value.data, sizeof(Matrix<T, R, C>));
+        }
+
+        static bool Deserialize(DeserializeStream& stream, Matrix<T, R, C>& value)
+        {
+            if (!TypeIdSerializer<Matrix<T, R, C>>::Deserialize(stream)) {
+                return false;
+            }
+            stream.Read(value.data, sizeof(Matrix<T, R, C>));
+            return true;
+        }
+    };
+
     template <>
     struct Serializer<std::string> {
         static constexpr bool serializable = true;
@@ -257,21 +623,33 @@ namespace Common {
             = Common::HashUtils::StrCrc32("std::vector")
             + Serializer<T>::typeId;
 
+        // std::vector<bool> has no contiguous storage
+        static constexpr bool bulk = BulkSerializable<T> && !std::is_same_v<T, bool>;
+
         static void Serialize(SerializeStream& stream, const std::vector<T>& value)
         {
-            TypeIdSerializer<std::vector<T>>::Serialize(stream);
-
             uint64_t size = value.size();
-            Serializer<uint64_t>::Serialize(stream, size);
-
-            for (auto i = 0; i < size; i++) {
-                Serializer<T>::Serialize(stream, value[i]);
+            if constexpr (bulk) {
+                TypeIdSerializer<std::vector<T>>::SerializeBulk(stream);
+                Serializer<uint64_t>::Serialize(stream, size);
+                // data() of an empty vector may be null, which memcpy does not accept even with zero size
+                if (size > 0) {
+                    stream.Write(value.data(), size * sizeof(T));
+                }
+            } else {
+                TypeIdSerializer<std::vector<T>>::Serialize(stream);
+                Serializer<uint64_t>::Serialize(stream, size);
+
+                for (uint64_t i = 0; i < size; i++) {
+                    Serializer<T>::Serialize(stream, value[i]);
+                }
             }
         }
 
         static bool Deserialize(DeserializeStream& stream, std::vector<T>& value)
         {
-            if (!TypeIdSerializer<std::vector<T>>::Deserialize(stream)) {
+            bool bulkLayout;
+            if (!TypeIdSerializer<std::vector<T>>::DeserializeWithLayout(stream, bulkLayout)) {
                 return false;
             }
 
@@ -280,8 +658,22 @@ namespace Common {
             uint64_t size;
             Serializer<uint64_t>::Deserialize(stream, size);
 
+            if constexpr (bulk) {
+                if (bulkLayout) {
+                    value.resize(size);
+                    if (size > 0) {
+                        stream.Read(value.data(), size * sizeof(T));
+                    }
+                    return true;
+                }
+            }
+            if (bulkLayout) {
+                // bulk data of a type which is no longer bulk serializable, element layout is unknown
+                return false;
+            }
+
             value.reserve(size);
-            for (auto i = 0; i < size; i++) {
+            for (uint64_t i = 0; i < size; i++) {
                 T element;
                 Serializer<T>::Deserialize(stream, element);
                 value.emplace_back(std::move(element));
@@ -300,19 +692,38 @@ namespace Common {
 
         static void Serialize(SerializeStream& stream, const std::unordered_set<T>& value)
         {
-            TypeIdSerializer<T>::Serialize(stream);
-
             uint64_t size = value.size();
-            Serializer<uint64_t>::Serialize(stream, size);
-
-            for (const auto& element : value) {
-                Serializer<T>::Serialize(stream, element);
+            if constexpr (BulkSerializable<T>) {
+                // elements are packed into one block, so the stream sees a single write
+                TypeIdSerializer<std::unordered_set<T>>::SerializeBulk(stream);
+                Serializer<uint64_t>::Serialize(stream, size);
+
+                std::vector<uint8_t> block(size * sizeof(T));
+                uint8_t* pointer = block.data();
+                for (const auto& element : value) {
+                    memcpy(pointer, &element, sizeof(T));
+                    pointer += sizeof(T);
+                }
+                if (size > 0) {
+                    stream.Write(block.data(), block.size());
+                }
+            } else {
+                TypeIdSerializer<T>::Serialize(stream);
+                Serializer<uint64_t>::Serialize(stream, size);
+
+                for (const auto& element : value) {
+                    Serializer<T>::Serialize(stream, element);
+                }
             }
         }
 
         static bool Deserialize(DeserializeStream& stream, std::unordered_set<T>& value)
         {
-            if (!TypeIdSerializer<T>::Deserialize(stream)) {
+            // per element layout is tagged with the type id of element
+            uint32_t typeId;
+            stream.Read(&typeId, sizeof(uint32_t));
+            const bool bulkLayout = typeId == TypeIdSerializer<std::unordered_set<T>>::bulkTypeId;
+            if (!bulkLayout && typeId != Serializer<T>::typeId) {
                 return false;
             }
 
@@ -321,8 +732,28 @@ namespace Common {
             uint64_t size;
             Serializer<uint64_t>::Deserialize(stream, size);
 
+            if constexpr (BulkSerializable<T>) {
+                if (bulkLayout) {
+                    std::vector<uint8_t> block(size * sizeof(T));
+                    if (size > 0) {
+                        stream.Read(block.data(), block.size());
+                    }
+
+                    value.reserve(size);
+                    for (uint64_t i = 0; i < size; i++) {
+                        T element;
+                        memcpy(&element, block.data() + i * sizeof(T), sizeof(T));
+                        value.emplace(std::move(element));
+                    }
+                    return true;
+                }
+            }
+            if (bulkLayout) {
+                return false;
+            }
+
             value.reserve(size);
-            for (auto i = 0; i < size; i++) {
+            for (uint64_t i = 0; i < size; i++) {
                 T temp;
                 Serializer<T>::Deserialize(stream, temp);
                 value.emplace(std::move(temp));
@@ -340,22 +771,42 @@ namespace Common {
             + Serializer<K>::typeId
             + Serializer<V>::typeId;
 
+        static constexpr bool bulk = BulkSerializable<K> && BulkSerializable<V>;
+        static constexpr size_t bulkEntrySize = sizeof(K) + sizeof(V);
+
         static void Serialize(SerializeStream& stream, const std::unordered_map<K, V>& value)
         {
-            TypeIdSerializer<std::unordered_map<K, V>>::Serialize(stream);
-
             uint64_t size = value.size();
-            Serializer<uint64_t>::Serialize(stream, size);
-
-            for (const auto& pair : value) {
-                Serializer<K>::Serialize(stream, pair.first);
-                Serializer<V>::Serialize(stream, pair.second);
+            if constexpr (bulk) {
+                // entries are packed as key bytes followed by value bytes into one block, so the stream sees a single write
+                TypeIdSerializer<std::unordered_map<K, V>>::SerializeBulk(stream);
+                Serializer<uint64_t>::Serialize(stream, size);
+
+                std::vector<uint8_t> block(size * bulkEntrySize);
+                uint8_t* pointer = block.data();
+                for (const auto& pair : value) {
+                    memcpy(pointer, &pair.first, sizeof(K));
+                    memcpy(pointer + sizeof(K), &pair.second, sizeof(V));
+                    pointer += bulkEntrySize;
+                }
+                if (size > 0) {
+                    stream.Write(block.data(), block.size());
+                }
+            } else {
+                TypeIdSerializer<std::unordered_map<K, V>>::Serialize(stream);
+                Serializer<uint64_t>::Serialize(stream, size);
+
+                for (const auto& pair : value) {
+                    Serializer<K>::Serialize(stream, pair.first);
+                    Serializer<V>::Serialize(stream, pair.second);
+                }
             }
         }
 
         static bool Deserialize(DeserializeStream& stream, std::unordered_map<K, V>& value)
         {
-            if (!TypeIdSerializer<std::unordered_map<K, V>>::Deserialize(stream)) {
+            bool bulkLayout;
+            if (!TypeIdSerializer<std::unordered_map<K, V>>::DeserializeWithLayout(stream, bulkLayout)) {
                 return false;
             }
 
@@ -364,8 +815,29 @@ namespace Common {
             uint64_t size;
             Serializer<uint64_t>::Deserialize(stream, size);
 
+            if constexpr (bulk) {
+                if (bulkLayout) {
+                    std::vector<uint8_t> block(size * bulkEntrySize);
+                    if (size > 0) {
+                        stream.Read(block.data(), block.size());
+                    }
+
+                    value.reserve(size);
+                    for (uint64_t i = 0; i < size; i++) {
+                        std::pair<K, V> pair;
+                        memcpy(&pair.first, block.data() + i * bulkEntrySize, sizeof(K));
+                        memcpy(&pair.second, block.data() + i * bulkEntrySize + sizeof(K), sizeof(V));
+                        value.emplace(std::move(pair));
+                    }
+                    return true;
+                }
+            }
+            if (bulkLayout) {
+                return false;
+            }
+
             value.reserve(size);
-            for (auto i = 0; i < size; i++) {
+            for (uint64_t i = 0; i < size; i++) {
                 std::pair<K, V> pair;
                 Serializer<K>::Deserialize(stream, pair.first);
                 Serializer<V>::Deserialize(stream, pair.second);
@@ -374,4 +846,99 @@ namespace Common {
             return true;
         }
     };
+    template <typename T>
+    requires BulkSerializable<T> && (!std::is_same_v<T, bool>)
+    struct Serializer<SpanView<T>> {
+        static constexpr bool serializable = true;
+        static constexpr uint32_t typeId = Serializer<std::vector<T>>::typeId;
+
+        static void Serialize(SerializeStream& stream, const SpanView<T>& value)
+        {
+            uint64_t size = value.size();
+            TypeIdSerializer<std::vector<T>>::SerializeBulk(stream);
+            Serializer<uint64_t>::Serialize(stream, size);
+            if (size > 0) {
+                stream.Write(value.data(), size * sizeof(T));
+            }
+        }
+
+        static bool Deserialize(DeserializeStream& stream, SpanView<T>& value)
+        {
+            bool bulkLayout;
+            if (!TypeIdSerializer<std::vector<T>>::DeserializeWithLayout(stream, bulkLayout)) {
+                return false;
+            }
+
+            uint64_t size;
+            Serializer<uint64_t>::Deserialize(stream, size);
+
+            if (bulkLayout && size > 0 && stream.IsZeroCopy()) {
+                // misaligned elements can not be viewed in place, they fall back to a copy
+                const auto bytes = stream.Peek(size * sizeof(T));
+                if (!bytes.empty() && reinterpret_cast<uintptr_t>(bytes.data()) % alignof(T) == 0) {
+                    value = SpanView<T>(std::span<const T>(reinterpret_cast<const T*>(bytes.data()), size), stream.GetViewOwner());
+                    stream.Skip(bytes.size());
+                    return true;
+                }
+            }
+
+            std::vector<T> storage;
+            if (bulkLayout) {
+                storage.resize(size);
+                if (size > 0) {
+                    stream.Read(storage.data(), size * sizeof(T));
+                }
+            } else {
+                storage.reserve(size);
+                for (uint64_t i = 0; i < size; i++) {
+                    T element;
+                    Serializer<T>::Deserialize(stream, element);
+                    storage.emplace_back(std::move(element));
+                }
+            }
+            value = SpanView<T>(std::move(storage));
+            return true;
+        }
+    };
+
+    template <>
+    struct Serializer<StringView> {
+        static constexpr bool serializable = true;
+        static constexpr uint32_t typeId = Serializer<std::string>::typeId;
+
+        static void Serialize(SerializeStream& stream, const StringView& value)
+        {
+            TypeIdSerializer<std::string>::Serialize(stream);
+
+            uint64_t size = value.size();
+            Serializer<uint64_t>::Serialize(stream, size);
+            if (size > 0) {
+                stream.Write(value.data(), size);
+            }
+        }
+
+        static bool Deserialize(DeserializeStream& stream, StringView& value)
+        {
+            if (!TypeIdSerializer<std::string>::Deserialize(stream)) {
+                return false;
+            }
+
+            uint64_t size;
+            Serializer<uint64_t>::Deserialize(stream, size);
+
+            if (size > 0 && stream.IsZeroCopy()) {
+                if (const auto bytes = stream.Peek(size); !bytes.empty()) {
+                    value = StringView(std::string_view(reinterpret_cast<const char*>(bytes.data()), size), stream.GetViewOwner());
+                    stream.Skip(size);
+                    return true;
+                }
+            }
+
+            std::string storage;
+            storage.resize(size);
+            stream.Read(storage.data(), size);
+            value = StringView(std::move(storage));
+            return true;
+        }
+    };
 }
@@ -0,0 +1,270 @@
+//
+// Created by johnk on 2024/3/17.
+//
+
+#include <Common/Container.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COMMON_SET_INTERSECTION_SSE2 1
+#include <emmintrin.h>
+#else
+#define COMMON_SET_INTERSECTION_SSE2 0
+#endif
+
+namespace Common::Internal {
+    template <typename T>
+    static size_t IntersectSortedUniqueImpl(const T* lhs, size_t lhsNum, const T* rhs, size_t rhsNum, T* out)
+    {
+        size_t i = 0;
+        size_t j = 0;
+        size_t count = 0;
+
+#if COMMON_SET_INTERSECTION_SSE2
+        // compare a block of four lhs elements against all rotations of a block of four rhs elements, then drop the
+        // block with the smaller maximum, elements are unique so each lhs element matches at most once
+        while (i + 4 <= lhsNum && j + 4 <= rhsNum) {
+            const __m128i blockLhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+            const __m128i blockRhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + j));
+            __m128i equal = _mm_cmpeq_epi32(blockLhs, blockRhs);
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(blockLhs, _mm_shuffle_epi32(blockRhs, _MM_SHUFFLE(0, 3, 2, 1))));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(blockLhs, _mm_shuffle_epi32(blockRhs, _MM_SHUFFLE(1, 0, 3, 2))));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(blockLhs, _mm_shuffle_epi32(blockRhs, _MM_SHUFFLE(2, 1, 0, 3))));
+
+            for (int mask = _mm_movemask_ps(_mm_castsi128_ps(equal)); mask != 0; mask &= mask - 1) {
+                out[count++] = lhs[i + std::countr_zero(static_cast<uint32_t>(mask))];
+            }
+
+            const T maxLhs = lhs[i + 3];
+            const T maxRhs = rhs[j + 3];
+            if (maxLhs <= maxRhs) {
+                i += 4;
+            }
+            if (maxRhs <= maxLhs) {
+                j += 4;
+            }
+        }
+#endif
+
+        while (i < lhsNum && j < rhsNum) {
+            if (lhs[i] < rhs[j]) {
+                i++;
+            } else if (rhs[j] < lhs[i]) {
+                j++;
+            } else {
+                out[count++] = lhs[i];
+                i++;
+                j++;
+            }
+        }
+        return count;
+    }
+
+    size_t IntersectSortedUnique(const uint32_t* lhs, size_t lhsNum, const uint32_t* rhs, size_t rhsNum, uint32_t* out)
+    {
+        return IntersectSortedUniqueImpl(lhs, lhsNum, rhs, rhsNum, out);
+    }
+
+    size_t IntersectSortedUnique(const int32_t* lhs, size_t lhsNum, const int32_t* rhs, size_t rhsNum, int32_t* out)
+    {
+        return IntersectSortedUniqueImpl(lhs, lhsNum, rhs, rhsNum, out);
+    }
+}
+
+namespace Common {
+    DynamicBitset::Iterator::Iterator(const uint64_t* inWords, size_t inWordNum, size_t inWordIndex)
+        : words(inWords)
+        , wordNum(inWordNum)
+        , wordIndex(inWordIndex)
+        , current(inWordIndex < inWordNum ? inWords[inWordIndex] : 0)
+    {
+        SkipEmptyWords();
+    }
+
+    size_t DynamicBitset::Iterator::operator*() const
+    {
+        return wordIndex * BitSetUtils::wordBits + static_cast<size_t>(std::countr_zero(current));
+    }
+
+    DynamicBitset::Iterator& DynamicBitset::Iterator::operator++()
+    {
+        current &= current - 1;
+        SkipEmptyWords();
+        return *this;
+    }
+
+    DynamicBitset::Iterator DynamicBitset::Iterator::operator++(int)
+    {
+        Iterator result = *this;
+        ++(*this);
+        return result;
+    }
+
+    bool DynamicBitset::Iterator::operator==(const Iterator& rhs) const
+    {
+        return wordIndex == rhs.wordIndex && current == rhs.current;
+    }
+
+    void DynamicBitset::Iterator::SkipEmptyWords()
+    {
+        while (current == 0 && wordIndex < wordNum) {
+            wordIndex++;
+            current = wordIndex < wordNum ? words[wordIndex] : 0;
+        }
+    }
+
+    DynamicBitset::DynamicBitset()
+        : bitNum(0)
+    {
+    }
+
+    DynamicBitset::DynamicBitset(size_t inBitNum, bool value)
+        : bitNum(0)
+    {
+        Resize(inBitNum, value);
+    }
+
+    DynamicBitset::DynamicBitset(const DynamicBitset& other) = default;
+
+    DynamicBitset::DynamicBitset(DynamicBitset&& other) noexcept
+        : bitNum(other.bitNum)
+        , words(std::move(other.words))
+    {
+        other.bitNum = 0;
+        other.words.clear();
+    }
+
+    DynamicBitset::~DynamicBitset() = default;
+
+    DynamicBitset& DynamicBitset::operator=(const DynamicBitset& other) = default;
+
+    DynamicBitset& DynamicBitset::operator=(DynamicBitset&& other) noexcept
+    {
+        bitNum = other.bitNum;
+        words = std::move(other.words);
+        other.bitNum = 0;
+        other.words.clear();
+        return *this;
+    }
+
+    size_t DynamicBitset::Size() const
+    {
+        return bitNum;
+    }
+
+    void DynamicBitset::Resize(size_t inBitNum, bool value)
+    {
+        const size_t oldBitNum = bitNum;
+        words.resize(BitSetUtils::GetWordNum(inBitNum), value ? ~uint64_t(0) : 0);
+        bitNum = inBitNum;
+        if (value && inBitNum > oldBitNum && oldBitNum % BitSetUtils::wordBits != 0) {
+            // the old last word keeps zero padding above the old size, fill it for the newly covered bits
+            words[oldBitNum / BitSetUtils::wordBits] |= ~uint64_t(0) << (oldBitNum % BitSetUtils::wordBits);
+        }
+        ClearUnusedBits();
+    }
+
+    void DynamicBitset::SetAll()
+    {
+        std::fill(words.begin(), words.end(), ~uint64_t(0));
+        ClearUnusedBits();
+    }
+
+    void DynamicBitset::ResetAll()
+    {
+        std::fill(words.begin(), words.end(), 0);
+    }
+
+    size_t DynamicBitset::Count() const
+    {
+        return BitSetUtils::Count(words);
+    }
+
+    bool DynamicBitset::Any() const
+    {
+        return std::any_of(words.begin(), words.end(), [](uint64_t word) -> bool { return word != 0; });
+    }
+
+    bool DynamicBitset::None() const
+    {
+        return !Any();
+    }
+
+    bool DynamicBitset::Intersects(const DynamicBitset& rhs) const
+    {
+        return BitSetUtils::Intersects(words, rhs.words);
+    }
+
+    bool DynamicBitset::IsSubsetOf(const DynamicBitset& rhs) const
+    {
+        return BitSetUtils::IsSubset(words, rhs.words);
+    }
+
+    std::span<const uint64_t> DynamicBitset::GetWords() const
+    {
+        return words;
+    }
+
+    DynamicBitset& DynamicBitset::operator&=(const DynamicBitset& rhs)
+    {
+        BitSetUtils::AndWith(words, rhs.words);
+        return *this;
+    }
+
+    DynamicBitset& DynamicBitset::operator|=(const DynamicBitset& rhs)
+    {
+        const size_t common = std::min(words.size(), rhs.words.size());
+        BitSetUtils::OrWith(std::span<uint64_t>(words.data(), common), std::span<const uint64_t>(rhs.words.data(), common));
+        ClearUnusedBits();
+        return *this;
+    }
+
+    DynamicBitset& DynamicBitset::operator-=(const DynamicBitset& rhs)
+    {
+        BitSetUtils::AndNotWith(words, rhs.words);
+        return *this;
+    }
+
+    DynamicBitset DynamicBitset::operator&(const DynamicBitset& rhs) const
+    {
+        DynamicBitset result = *this;
+        result &= rhs;
+        return result;
+    }
+
+    DynamicBitset DynamicBitset::operator|(const DynamicBitset& rhs) const
+    {
+        DynamicBitset result = *this;
+        result |= rhs;
+        return result;
+    }
+
+    DynamicBitset DynamicBitset::operator-(const DynamicBitset& rhs) const
+    {
+        DynamicBitset result = *this;
+        result -= rhs;
+        return result;
+    }
+
+    bool DynamicBitset::operator==(const DynamicBitset& rhs) const
+    {
+        return bitNum == rhs.bitNum && words == rhs.words;
+    }
+
+    DynamicBitset::Iterator DynamicBitset::begin() const
+    {
+        return { words.data(), words.size(), 0 };
+    }
+
+    DynamicBitset::Iterator DynamicBitset::end() const
+    {
+        return { words.data(), words.size(), words.size() };
+    }
+
+    void DynamicBitset::ClearUnusedBits()
+    {
+        // bits above bitNum in the last word stay zero, so Count() and comparisons can work on whole words
+        if (const size_t usedBits = bitNum % BitSetUtils::wordBits; usedBits != 0) {
+            words.back() &= (uint64_t(1) << usedBits) - 1;
+        }
+    }
+}
@@ -0,0 +1,253 @@
+//
+// Created by johnk on 2024/3/2.
+//
+
+#if PLATFORM_LINUX
+#include <sched.h>
+#endif
+
+#include <Common/JobSystem.h>
+#include <Common/Debug.h>
+
+namespace Common::Internal {
+    static constexpr uint32_t jobSpinCount = 64;
+    static constexpr uint32_t jobYieldCount = 16;
+
+    static thread_local const JobSystem* currentJobSystem = nullptr;
+    static thread_local size_t currentWorkerSlot = 0;
+
+    static size_t GetJobSystemThreadNum(const JobSystemDesc& desc)
+    {
+        return desc.threadNum == 0 ? std::max<uint32_t>(std::thread::hardware_concurrency(), 1) : desc.threadNum;
+    }
+
+    static void SetCurrentThreadAffinity(uint32_t core)
+    {
+#if PLATFORM_WINDOWS
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << core);
+#elif PLATFORM_LINUX
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(core, &cpuSet);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+#else
+        // macOS has no hard affinity api, only affinity tags as hint, so just ignore it
+        (void) core;
+#endif
+    }
+}
+
+namespace Common {
+    JobCounter::JobCounter() : value(0) {}
+
+    JobCounter::~JobCounter()
+    {
+        Assert(Finished());
+    }
+
+    bool JobCounter::Finished() const
+    {
+        if (value.load() != 0) {
+            return false;
+        }
+        // value drops to zero inside the lock, acquiring it makes sure the last decrement no longer touches this counter
+        std::unique_lock<std::mutex> lock(mutex);
+        return true;
+    }
+
+    void JobCounter::Increment()
+    {
+        value.fetch_add(1);
+    }
+
+    void JobCounter::Decrement()
+    {
+        std::vector<std::function<void()>> readyContinuations;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (value.fetch_sub(1) != 1) {
+                return;
+            }
+            readyContinuations.swap(continuations);
+        }
+        for (auto& continuation : readyContinuations) {
+            continuation();
+        }
+    }
+
+    JobSystem::JobSystem(const JobSystemDesc& inDesc)
+        : stop(false)
+        , pendingNum(0)
+        , sleepingNum(0)
+        , threadNum(Internal::GetJobSystemThreadNum(inDesc))
+        , coreAffinities(inDesc.coreAffinities)
+    {
+        queues = std::make_unique<WorkerQueue[]>(threadNum + 1);
+        threads.reserve(threadNum);
+        for (size_t i = 0; i < threadNum; i++) {
+            threads.emplace_back(NamedThread("JobWorker-" + std::to_string(i), [this, i]() -> void { WorkerLoop(i); }));
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stop.store(true);
+        }
+        condition.notify_all();
+        for (auto& thread : threads) {
+            thread.Join();
+        }
+    }
+
+    void JobSystem::Schedule(std::function<void()> job, JobCounter* counter, JobCounter* dependency)
+    {
+        Assert(!stop.load());
+        if (counter != nullptr) {
+            counter->Increment();
+        }
+
+        Job newJob { std::move(job), counter };
+        if (dependency != nullptr) {
+            std::unique_lock<std::mutex> lock(dependency->mutex);
+            if (dependency->value.load() != 0) {
+                dependency->continuations.emplace_back([this, newJob]() mutable -> void { Push(std::move(newJob)); });
+                return;
+            }
+        }
+        Push(std::move(newJob));
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        const size_t slot = GetCurrentWorkerSlot();
+        Job job;
+        while (!counter.Finished()) {
+            if (TryTake(slot, job)) {
+                Execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    size_t JobSystem::GetThreadNum() const
+    {
+        return threadNum;
+    }
+
+    size_t JobSystem::GetCurrentWorkerSlot() const
+    {
+        return Internal::currentJobSystem == this ? Internal::currentWorkerSlot : threadNum;
+    }
+
+    void JobSystem::Push(Job&& job)
+    {
+        // counted before it is visible, so pendingNum never underflows when a thief takes the job right away
+        pendingNum.fetch_add(1);
+        {
+            auto& queue = queues[GetCurrentWorkerSlot()];
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            queue.jobs.emplace_back(std::move(job));
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepingNum.load() > 0) {
+            // lock pairs with the sleeping check of workers, so the notification can not slip in before they wait
+            { std::unique_lock<std::mutex> lock(mutex); }
+            condition.notify_one();
+        }
+    }
+
+    bool JobSystem::TryTake(size_t slot, Job& outJob)
+    {
+        if (pendingNum.load() == 0) {
+            return false;
+        }
+
+        {
+            // workers pop their newest job for cache locality, the shared queue of outside threads stays fifo
+            auto& queue = queues[slot];
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                if (slot < threadNum) {
+                    outJob = std::move(queue.jobs.back());
+                    queue.jobs.pop_back();
+                } else {
+                    outJob = std::move(queue.jobs.front());
+                    queue.jobs.pop_front();
+                }
+                pendingNum.fetch_sub(1);
+                return true;
+            }
+        }
+        return TrySteal(slot, outJob);
+    }
+
+    bool JobSystem::TrySteal(size_t thief, Job& outJob)
+    {
+        // thieves take the oldest job of a victim, which tends to be the largest piece of remaining work
+        const size_t queueNum = threadNum + 1;
+        for (size_t i = 1; i < queueNum; i++) {
+            auto& queue = queues[(thief + i) % queueNum];
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            if (queue.jobs.empty()) {
+                continue;
+            }
+            outJob = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            pendingNum.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    void JobSystem::Execute(Job& job)
+    {
+        job.func();
+        job.func = nullptr;
+        if (job.counter != nullptr) {
+            job.counter->Decrement();
+        }
+    }
+
+    void JobSystem::WorkerLoop(size_t slot)
+    {
+        Internal::currentJobSystem = this;
+        Internal::currentWorkerSlot = slot;
+        if (!coreAffinities.empty()) {
+            Internal::SetCurrentThreadAffinity(coreAffinities[slot % coreAffinities.size()]);
+        }
+
+        Job job;
+        while (true) {
+            bool found = false;
+            for (uint32_t i = 0; i < Internal::jobSpinCount + Internal::jobYieldCount && !found; i++) {
+                found = TryTake(slot, job);
+                if (!found && i >= Internal::jobSpinCount) {
+                    std::this_thread::yield();
+                }
+            }
+
+            if (!found) {
+                std::unique_lock<std::mutex> lock(mutex);
+                sleepingNum.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                found = TryTake(slot, job);
+                if (!found && !stop.load()) {
+                    condition.wait(lock, [this]() -> bool { return stop.load() || pendingNum.load() > 0; });
+                }
+                sleepingNum.fetch_sub(1);
+
+                if (!found && stop.load() && pendingNum.load() == 0) {
+                    return;
+                }
+                if (!found) {
+                    continue;
+                }
+            }
+            Execute(job);
+        }
+    }
+}
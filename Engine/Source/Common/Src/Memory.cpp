@@ -0,0 +1,204 @@
+//
+// Created by johnk on 2024/3/9.
+//
+
+#include <algorithm>
+
+#include <Common/Memory.h>
+#include <Common/Debug.h>
+
+namespace Common::Internal {
+    static size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+namespace Common {
+    LinearAllocator::LinearAllocator(size_t inCapacity)
+        : memory(static_cast<std::byte*>(::operator new(inCapacity, std::align_val_t(alignof(std::max_align_t)))))
+        , capacity(inCapacity)
+        , offset(0)
+    {
+    }
+
+    LinearAllocator::LinearAllocator(LinearAllocator&& other) noexcept
+        : memory(other.memory)
+        , capacity(other.capacity)
+        , offset(other.offset)
+    {
+        other.memory = nullptr;
+        other.capacity = 0;
+        other.offset = 0;
+    }
+
+    LinearAllocator::~LinearAllocator()
+    {
+        if (memory != nullptr) {
+            ::operator delete(memory, std::align_val_t(alignof(std::max_align_t)));
+        }
+    }
+
+    void* LinearAllocator::Allocate(size_t size, size_t alignment)
+    {
+        Assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        const auto base = reinterpret_cast<uintptr_t>(memory);
+        const size_t alignedOffset = Internal::AlignUp(base + offset, alignment) - base;
+        if (alignedOffset + size > capacity) {
+            return nullptr;
+        }
+        offset = alignedOffset + size;
+        return memory + alignedOffset;
+    }
+
+    size_t LinearAllocator::GetMarker() const
+    {
+        return offset;
+    }
+
+    void LinearAllocator::Rewind(size_t marker)
+    {
+        Assert(marker <= offset);
+        offset = marker;
+    }
+
+    void LinearAllocator::Reset()
+    {
+        offset = 0;
+    }
+
+    size_t LinearAllocator::GetCapacity() const
+    {
+        return capacity;
+    }
+
+    size_t LinearAllocator::GetUsedSize() const
+    {
+        return offset;
+    }
+
+    ArenaAllocator::ArenaAllocator(size_t inBlockSize)
+        : blockSize(inBlockSize)
+        , current(0)
+    {
+    }
+
+    ArenaAllocator::ArenaAllocator(ArenaAllocator&& other) noexcept
+        : blockSize(other.blockSize)
+        , current(other.current)
+        , blocks(std::move(other.blocks))
+    {
+        other.current = 0;
+    }
+
+    ArenaAllocator::~ArenaAllocator() = default;
+
+    void* ArenaAllocator::Allocate(size_t size, size_t alignment)
+    {
+        if (!blocks.empty()) {
+            if (void* result = blocks[current].Allocate(size, alignment); result != nullptr) {
+                return result;
+            }
+        }
+
+        // blocks behind current are free since the last rewind, reuse the first one which is large enough
+        for (size_t i = blocks.empty() ? 0 : current + 1; i < blocks.size(); i++) {
+            if (void* result = blocks[i].Allocate(size, alignment); result != nullptr) {
+                current = i;
+                return result;
+            }
+        }
+
+        blocks.emplace_back(std::max(blockSize, size + alignment));
+        current = blocks.size() - 1;
+        return blocks[current].Allocate(size, alignment);
+    }
+
+    ArenaAllocator::Marker ArenaAllocator::GetMarker() const
+    {
+        return { current, blocks.empty() ? 0 : blocks[current].GetMarker() };
+    }
+
+    void ArenaAllocator::Rewind(const Marker& marker)
+    {
+        if (blocks.empty()) {
+            return;
+        }
+        Assert(marker.blockIndex <= current);
+        for (size_t i = marker.blockIndex + 1; i <= current; i++) {
+            blocks[i].Reset();
+        }
+        blocks[marker.blockIndex].Rewind(marker.offset);
+        current = marker.blockIndex;
+    }
+
+    void ArenaAllocator::Reset()
+    {
+        Rewind({ 0, 0 });
+    }
+
+    size_t ArenaAllocator::GetBlockNum() const
+    {
+        return blocks.size();
+    }
+
+    size_t ArenaAllocator::GetUsedSize() const
+    {
+        size_t result = 0;
+        for (const auto& block : blocks) {
+            result += block.GetUsedSize();
+        }
+        return result;
+    }
+
+    FrameAllocator::FrameAllocator(size_t inBlockSize)
+        : index(0)
+        , arenas { ArenaAllocator(inBlockSize), ArenaAllocator(inBlockSize) }
+    {
+    }
+
+    FrameAllocator::~FrameAllocator() = default;
+
+    void* FrameAllocator::Allocate(size_t size, size_t alignment)
+    {
+        return arenas[index].Allocate(size, alignment);
+    }
+
+    void FrameAllocator::NextFrame()
+    {
+        index ^= 1;
+        arenas[index].Reset();
+    }
+
+    size_t FrameAllocator::GetUsedSize() const
+    {
+        return arenas[0].GetUsedSize() + arenas[1].GetUsedSize();
+    }
+
+    ScratchScope::ScratchScope()
+        : arena(GetThreadArena())
+        , marker(arena.GetMarker())
+    {
+    }
+
+    ScratchScope::~ScratchScope()
+    {
+        arena.Rewind(marker);
+    }
+
+    void* ScratchScope::Allocate(size_t size, size_t alignment)
+    {
+        return arena.Allocate(size, alignment);
+    }
+
+    ArenaAllocator& ScratchScope::GetArena()
+    {
+        return arena;
+    }
+
+    ArenaAllocator& ScratchScope::GetThreadArena()
+    {
+        static thread_local ArenaAllocator threadArena;
+        return threadArena;
+    }
+}
@@ -2,6 +2,19 @@
 // Created by johnk on 2023/7/13.
 //
 
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#if PLATFORM_WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <Common/Serialization.h>
 
 namespace Common {
@@ -13,6 +26,31 @@ namespace Common {
 
     DeserializeStream::~DeserializeStream() = default;
 
+    void DeserializeStream::Skip(size_t size)
+    {
+        uint8_t temp[256];
+        while (size > 0) {
+            const size_t readSize = std::min<size_t>(size, sizeof(temp));
+            Read(temp, readSize);
+            size -= readSize;
+        }
+    }
+
+    std::span<const uint8_t> DeserializeStream::Peek(size_t)
+    {
+        return {};
+    }
+
+    bool DeserializeStream::IsZeroCopy() const
+    {
+        return false;
+    }
+
+    SharedRef<MappedFile> DeserializeStream::GetViewOwner() const
+    {
+        return nullptr;
+    }
+
     BinaryFileSerializeStream::BinaryFileSerializeStream(const std::string& inFileName)
         : file(inFileName, std::ios::binary)
     {
@@ -51,6 +89,218 @@ namespace Common {
         file.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
     }
 
+    void BinaryFileDeserializeStream::Skip(size_t size)
+    {
+        file.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+    }
+
+    BufferedFileSerializeStream::BufferedFileSerializeStream(const std::string& inFileName, size_t inBufferSize)
+        : used(0)
+        , buffer(inBufferSize)
+    {
+        // the block buffer replaces the one of file stream, so data is not copied twice
+        file.rdbuf()->pubsetbuf(nullptr, 0);
+        file.open(inFileName, std::ios::binary);
+    }
+
+    BufferedFileSerializeStream::~BufferedFileSerializeStream()
+    {
+        try {
+            Flush();
+            file.close();
+        } catch (const std::exception& e) {
+            QuickFail();
+        }
+    }
+
+    void BufferedFileSerializeStream::Write(const void* data, size_t size)
+    {
+        if (used + size > buffer.size()) {
+            Flush();
+            // large writes bypass the buffer
+            if (size >= buffer.size()) {
+                file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                return;
+            }
+        }
+        memcpy(buffer.data() + used, data, size);
+        used += size;
+    }
+
+    void BufferedFileSerializeStream::Flush()
+    {
+        if (used == 0) {
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+
+#if PLATFORM_WINDOWS
+    MappedFile::MappedFile(const std::string& inFileName)
+        : valid(false)
+        , data(nullptr)
+        , size(0)
+        , fileHandle(INVALID_HANDLE_VALUE)
+        , mappingHandle(nullptr)
+    {
+        // share delete lets a mapped file be replaced by rename while views of it are still alive
+        fileHandle = CreateFileA(inFileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            return;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize)) {
+            return;
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        // empty file can not be mapped
+        if (size == 0) {
+            valid = true;
+            return;
+        }
+
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr) {
+            size = 0;
+            return;
+        }
+        data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        valid = data != nullptr;
+        if (!valid) {
+            size = 0;
+        }
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data != nullptr) {
+            UnmapViewOfFile(data);
+        }
+        if (mappingHandle != nullptr) {
+            CloseHandle(mappingHandle);
+        }
+        if (fileHandle != INVALID_HANDLE_VALUE) {
+            CloseHandle(fileHandle);
+        }
+    }
+#else
+    MappedFile::MappedFile(const std::string& inFileName)
+        : valid(false)
+        , data(nullptr)
+        , size(0)
+    {
+        const int fd = open(inFileName.c_str(), O_RDONLY);
+        if (fd == -1) {
+            return;
+        }
+
+        struct stat fileStat {};
+        if (fstat(fd, &fileStat) == 0) {
+            size = static_cast<size_t>(fileStat.st_size);
+            // empty file can not be mapped
+            if (size == 0) {
+                valid = true;
+            } else if (void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); address != MAP_FAILED) {
+                data = static_cast<const uint8_t*>(address);
+                valid = true;
+            } else {
+                size = 0;
+            }
+        }
+        // mapping keeps the file referenced, descriptor is no longer needed
+        close(fd);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data != nullptr) {
+            munmap(const_cast<uint8_t*>(data), size);
+        }
+    }
+#endif
+
+    bool MappedFile::IsValid() const
+    {
+        return valid;
+    }
+
+    const uint8_t* MappedFile::GetData() const
+    {
+        return data;
+    }
+
+    size_t MappedFile::GetSize() const
+    {
+        return size;
+    }
+
+    MappedFileDeserializeStream::MappedFileDeserializeStream(const std::string& inFileName, size_t pointerBegin)
+        : MappedFileDeserializeStream(Common::MakeShared<MappedFile>(inFileName), pointerBegin)
+    {
+    }
+
+    MappedFileDeserializeStream::MappedFileDeserializeStream(SharedRef<MappedFile> inFile, size_t pointerBegin)
+        : zeroCopy(false)
+        , pointer(pointerBegin)
+        , file(std::move(inFile))
+    {
+    }
+
+    MappedFileDeserializeStream::~MappedFileDeserializeStream() = default;
+
+    bool MappedFileDeserializeStream::IsValid() const
+    {
+        return file->IsValid() && pointer <= file->GetSize();
+    }
+
+    void MappedFileDeserializeStream::Read(void* data, size_t size)
+    {
+        // out of range reads yield zeros instead of touching memory outside the mapping, type id checks then reject the data
+        const size_t readSize = IsValid() ? std::min<size_t>(size, file->GetSize() - pointer) : 0;
+        if (readSize > 0) {
+            memcpy(data, file->GetData() + pointer, readSize);
+        }
+        if (readSize < size) {
+            memset(static_cast<uint8_t*>(data) + readSize, 0, size - readSize);
+        }
+        pointer += readSize;
+    }
+
+    void MappedFileDeserializeStream::Skip(size_t size)
+    {
+        pointer += IsValid() ? std::min<size_t>(size, file->GetSize() - pointer) : 0;
+    }
+
+    std::span<const uint8_t> MappedFileDeserializeStream::Peek(size_t size)
+    {
+        if (!IsValid() || size > file->GetSize() - pointer) {
+            return {};
+        }
+        return { file->GetData() + pointer, size };
+    }
+
+    bool MappedFileDeserializeStream::IsZeroCopy() const
+    {
+        return zeroCopy;
+    }
+
+    SharedRef<MappedFile> MappedFileDeserializeStream::GetViewOwner() const
+    {
+        return file;
+    }
+
+    const SharedRef<MappedFile>& MappedFileDeserializeStream::GetFile() const
+    {
+        return file;
+    }
+
+    void MappedFileDeserializeStream::SetZeroCopy(bool inZeroCopy)
+    {
+        zeroCopy = inZeroCopy;
+    }
+
     ByteSerializeStream::ByteSerializeStream(std::vector<uint8_t>& inBytes, size_t pointerBegin)
         : pointer(pointerBegin)
         , bytes(inBytes)
@@ -74,7 +324,8 @@ namespace Common {
     }
 
     ByteDeserializeStream::ByteDeserializeStream(const std::vector<uint8_t>& inBytes, size_t pointerBegin)
-        : pointer(pointerBegin)
+        : zeroCopy(false)
+        , pointer(pointerBegin)
         , bytes(inBytes)
     {
         Assert(pointer >= 0 && pointer <= bytes.size());
@@ -89,4 +340,77 @@ namespace Common {
         memcpy(data, bytes.data() + pointer, size);
         pointer = newPointer;
     }
+
+    void ByteDeserializeStream::Skip(size_t size)
+    {
+        Assert(pointer + size <= bytes.size());
+        pointer += size;
+    }
+
+    std::span<const uint8_t> ByteDeserializeStream::Peek(size_t size)
+    {
+        Assert(pointer + size <= bytes.size());
+        return { bytes.data() + pointer, size };
+    }
+
+    bool ByteDeserializeStream::IsZeroCopy() const
+    {
+        return zeroCopy;
+    }
+
+    void ByteDeserializeStream::SetZeroCopy(bool inZeroCopy)
+    {
+        zeroCopy = inZeroCopy;
+    }
+
+    BoundedDeserializeStream::BoundedDeserializeStream(DeserializeStream& inStream, size_t inSize)
+        : stream(inStream)
+        , remaining(inSize)
+        , overflowed(false)
+    {
+    }
+
+    BoundedDeserializeStream::~BoundedDeserializeStream()
+    {
+        stream.Skip(remaining);
+    }
+
+    void BoundedDeserializeStream::Read(void* data, size_t size)
+    {
+        const size_t readSize = std::min<size_t>(size, remaining);
+        stream.Read(data, readSize);
+        if (readSize < size) {
+            memset(static_cast<uint8_t*>(data) + readSize, 0, size - readSize);
+            overflowed = true;
+        }
+        remaining -= readSize;
+    }
+
+    void BoundedDeserializeStream::Skip(size_t size)
+    {
+        const size_t skipSize = std::min<size_t>(size, remaining);
+        stream.Skip(skipSize);
+        overflowed = overflowed || skipSize < size;
+        remaining -= skipSize;
+    }
+
+    std::span<const uint8_t> BoundedDeserializeStream::Peek(size_t size)
+    {
+        return size > remaining ? std::span<const uint8_t> {} : stream.Peek(size);
+    }
+
+    bool BoundedDeserializeStream::IsZeroCopy() const
+    {
+        return stream.IsZeroCopy();
+    }
+
+    SharedRef<MappedFile> BoundedDeserializeStream::GetViewOwner() const
+    {
+        return stream.GetViewOwner();
+    }
+
+    bool BoundedDeserializeStream::Overflowed() const
+    {
+        return overflowed;
+    }
 }
@@ -2,10 +2,97 @@
 // Created by johnk on 2022/7/20.
 //
 
+#include <array>
+#include <chrono>
+#include <queue>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include <Common/Concurrent.h>
 
+// thread pool before it was backed by MPMCQueue, one mutex for all producers and workers and a std::function per task, kept as a baseline
+class MutexThreadPool {
+public:
+    MutexThreadPool(const std::string& name, uint8_t threadNum) : stop(false)
+    {
+        threads.reserve(threadNum);
+        for (auto i = 0; i < threadNum; i++) {
+            threads.emplace_back(Common::NamedThread(name + "-" + std::to_string(i), [this]() -> void {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        condition.wait(lock, [this]() -> bool { return stop || !tasks.empty(); });
+                        if (stop && tasks.empty()) {
+                            return;
+                        }
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            }));
+        }
+    }
+
+    ~MutexThreadPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for (auto& thread : threads) {
+            thread.Join();
+        }
+    }
+
+    template <typename F>
+    auto EmplaceTask(F&& task)
+    {
+        using RetType = std::invoke_result_t<F>;
+        auto packagedTask = std::make_shared<std::packaged_task<RetType()>>(std::forward<F>(task));
+        auto result = packagedTask->get_future();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            tasks.emplace([packagedTask]() -> void { (*packagedTask)(); });
+        }
+        condition.notify_one();
+        return result;
+    }
+
+private:
+    bool stop;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<Common::NamedThread> threads;
+    std::queue<std::function<void()>> tasks;
+};
+
+// 4 producers emplace 10000 tasks each, measured until the pool is destroyed, i.e. all tasks are executed
+template <typename P, typename... Args>
+static double MeasureThreadPoolContention(std::atomic<uint32_t>& count, Args&&... args)
+{
+    const auto begin = std::chrono::steady_clock::now();
+    {
+        P threadPool(std::forward<Args>(args)...);
+        std::vector<std::thread> producers;
+        producers.reserve(4);
+        for (auto i = 0; i < 4; i++) {
+            producers.emplace_back([&threadPool, &count]() -> void {
+                for (auto j = 0; j < 10000; j++) {
+                    threadPool.EmplaceTask([&count]() -> void { count++; });
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
 TEST(ConcurrentTest, NamedThreadTest)
 {
     std::atomic<uint32_t> value = 0;
@@ -65,6 +152,77 @@ TEST(ConcurrentTest, ThreadPoolTest3)
     ASSERT_EQ(count, 200);
 }
 
+TEST(ConcurrentTest, ThreadPoolContentionTest)
+{
+    std::atomic<uint32_t> count = 0;
+    const double mpmcMs = MeasureThreadPoolContention<Common::ThreadPool>(count, "TestThreadPool", 4);
+    ASSERT_EQ(count, 40000);
+
+    // small queue capacity forces producers to back off on a full queue
+    count = 0;
+    const double mpmcSmallQueueMs = MeasureThreadPoolContention<Common::ThreadPool>(count, "TestThreadPool", 4, 64);
+    ASSERT_EQ(count, 40000);
+
+    count = 0;
+    const double mutexMs = MeasureThreadPoolContention<MutexThreadPool>(count, "TestThreadPool", 4);
+    ASSERT_EQ(count, 40000);
+
+    RecordProperty("mpmcMs", std::to_string(mpmcMs));
+    RecordProperty("mpmcSmallQueueMs", std::to_string(mpmcSmallQueueMs));
+    RecordProperty("mutexMs", std::to_string(mutexMs));
+}
+
+TEST(ConcurrentTest, MPMCQueueTest0)
+{
+    Common::MPMCQueue<uint32_t> queue(3);
+    ASSERT_EQ(queue.Capacity(), 4);
+    ASSERT_TRUE(queue.Empty());
+    for (uint32_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryEmplace(i));
+    }
+    ASSERT_FALSE(queue.TryEmplace(4u));
+
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryPop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(queue.TryPop(value));
+    ASSERT_TRUE(queue.Empty());
+}
+
+TEST(ConcurrentTest, MPMCQueueTest1)
+{
+    Common::MPMCQueue<uint64_t> queue(128);
+    std::atomic<uint64_t> sum = 0;
+    std::atomic<uint32_t> popped = 0;
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 4; i++) {
+        threads.emplace_back([&queue, i]() -> void {
+            for (uint64_t j = 1; j <= 10000; j++) {
+                while (!queue.TryEmplace(j + i * 10000)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&queue, &sum, &popped]() -> void {
+            uint64_t value;
+            while (popped.load() < 40000) {
+                if (queue.TryPop(value)) {
+                    sum += value;
+                    popped++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(sum, 40000ull * 40001 / 2);
+}
+
 TEST(ConcurrentTest, WorkerThread0)
 {
     uint32_t value = 0;
@@ -115,3 +273,215 @@ TEST(ConcurrentTest, WorkerThread3)
     syncSignal.wait();
     ASSERT_EQ(value, 10);
 }
+
+TEST(ConcurrentTest, WorkerThreadFlushTest)
+{
+    // flush right after the worker drained the queue must not wait for a notification which was already sent
+    uint32_t value = 0;
+    Common::WorkerThread workerThread("TestWorkerThread");
+    for (auto i = 0; i < 1000; i++) {
+        workerThread.EmplaceTask([&value]() -> void { value++; });
+        workerThread.Flush();
+        workerThread.Flush();
+        ASSERT_EQ(value, i + 1);
+    }
+}
+
+TEST(ConcurrentTest, SPSCQueueTest0)
+{
+    Common::SPSCQueue<uint32_t> queue(3);
+    ASSERT_EQ(queue.Capacity(), 4);
+    ASSERT_TRUE(queue.Empty());
+    ASSERT_EQ(queue.Front(), nullptr);
+    for (uint32_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryEmplace(i));
+    }
+    ASSERT_FALSE(queue.TryEmplace(4u));
+
+    ASSERT_EQ(*queue.Front(), 0);
+    queue.Pop();
+    ASSERT_TRUE(queue.TryEmplace(4u));
+
+    uint32_t value = 0;
+    for (uint32_t i = 1; i < 5; i++) {
+        ASSERT_TRUE(queue.TryPop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(queue.TryPop(value));
+    ASSERT_TRUE(queue.Empty());
+}
+
+TEST(ConcurrentTest, SPSCQueueTest1)
+{
+    // elements left in queue are destroyed with it
+    auto counter = std::make_shared<uint32_t>(0);
+    {
+        Common::SPSCQueue<std::shared_ptr<uint32_t>> queue(8);
+        for (auto i = 0; i < 5; i++) {
+            ASSERT_TRUE(queue.TryEmplace(counter));
+        }
+        ASSERT_EQ(counter.use_count(), 6);
+    }
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
+TEST(ConcurrentTest, SPSCQueueTest2)
+{
+    Common::SPSCQueue<uint64_t> queue(64);
+    std::thread producer([&queue]() -> void {
+        for (uint64_t i = 0; i < 100000; i++) {
+            while (!queue.TryEmplace(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t value = 0;
+    while (expected < 100000) {
+        if (queue.TryPop(value)) {
+            ASSERT_EQ(value, expected);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    ASSERT_TRUE(queue.Empty());
+}
+
+TEST(ConcurrentTest, SPSCWorkerThread0)
+{
+    uint32_t value = 0;
+    {
+        Common::SPSCWorkerThread workerThread("TestWorkerThread");
+        for (auto i = 0; i < 10; i++) {
+            workerThread.Submit([&value]() -> void { value++; });
+        }
+    }
+    ASSERT_EQ(value, 10);
+}
+
+TEST(ConcurrentTest, SPSCWorkerThread1)
+{
+    uint32_t value = 0;
+    Common::SPSCWorkerThread workerThread("TestWorkerThread");
+    for (auto i = 0; i < 10; i++) {
+        workerThread.EmplaceTask([&value]() -> void { value++; });
+    }
+    workerThread.Flush();
+    ASSERT_EQ(value, 10);
+    for (auto i = 0; i < 5; i++) {
+        workerThread.EmplaceTask([&value]() -> void { value *= 2; });
+    }
+    auto result = workerThread.EmplaceTask([&value]() -> uint32_t { return value; });
+    ASSERT_EQ(result.get(), 320);
+}
+
+TEST(ConcurrentTest, SPSCWorkerThreadFenceTest)
+{
+    // frame fences, producer runs at most two frames ahead of the worker
+    std::atomic<uint32_t> executedFrame = 0;
+    std::array<uint64_t, 2> frameFences = { 0, 0 };
+    Common::SPSCWorkerThread workerThread("TestWorkerThread", 16);
+    for (uint32_t frame = 1; frame <= 200; frame++) {
+        workerThread.WaitFence(frameFences[frame % 2]);
+        ASSERT_TRUE(workerThread.IsFencePassed(frameFences[frame % 2]));
+        ASSERT_GE(executedFrame.load() + 2, frame);
+        for (auto i = 0; i < 20; i++) {
+            workerThread.Submit([]() -> void {});
+        }
+        frameFences[frame % 2] = workerThread.Submit([&executedFrame, frame]() -> void { executedFrame.store(frame); });
+        ASSERT_EQ(frameFences[frame % 2], workerThread.GetFence());
+    }
+    workerThread.Flush();
+    ASSERT_EQ(executedFrame.load(), 200);
+    ASSERT_TRUE(workerThread.IsFencePassed(workerThread.GetFence()));
+}
+
+TEST(ConcurrentTest, SPSCWorkerThreadProducerTest)
+{
+    // only the constructing thread may push
+    ASSERT_DEATH({
+        Common::SPSCWorkerThread workerThread("TestWorkerThread");
+        std::thread([&workerThread]() -> void { workerThread.Submit([]() -> void {}); }).join();
+    }, "");
+}
+
+TEST(ConcurrentTest, SPSCWorkerThreadForeignTaskTest)
+{
+    // emplacing is allowed from any thread, including the worker itself, e.g. a command enqueuing a follow-up
+    std::atomic<uint32_t> value = 0;
+    Common::SPSCWorkerThread workerThread("TestWorkerThread");
+    std::vector<std::thread> producers;
+    for (auto i = 0; i < 4; i++) {
+        producers.emplace_back([&]() -> void {
+            for (auto j = 0; j < 1000; j++) {
+                workerThread.EmplaceTask([&]() -> void { value++; });
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    workerThread.Flush();
+    ASSERT_EQ(value.load(), 4000);
+
+    std::future<uint32_t> followUp;
+    workerThread.EmplaceTask([&]() -> void {
+        followUp = workerThread.EmplaceTask([&]() -> uint32_t { return ++value; });
+    }).get();
+    ASSERT_EQ(followUp.get(), 4001);
+}
+
+TEST(ConcurrentTest, SPSCWorkerThreadLargeTaskTest)
+{
+    // captures larger than inline storage of a task are moved to heap
+    std::array<uint64_t, 16> values {};
+    values.fill(1);
+    uint64_t sum = 0;
+    auto shared = std::make_shared<uint32_t>(2);
+    Common::SPSCWorkerThread workerThread("TestWorkerThread");
+    workerThread.Submit([values, shared, &sum]() -> void {
+        for (const auto value : values) {
+            sum += value * *shared;
+        }
+    });
+    workerThread.Flush();
+    ASSERT_EQ(sum, 32);
+    ASSERT_EQ(shared.use_count(), 1);
+}
+
+TEST(ConcurrentTest, SPSCWorkerThreadThroughputTest)
+{
+    constexpr uint32_t taskNum = 1000000;
+    uint64_t sum = 0;
+    Common::SPSCWorkerThread workerThread("TestWorkerThread", 1024);
+
+    const auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < taskNum; i++) {
+        workerThread.Submit([&sum, i]() -> void { sum += i; });
+    }
+    workerThread.Flush();
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    ASSERT_EQ(sum, static_cast<uint64_t>(taskNum) * (taskNum - 1) / 2);
+    RecordProperty("tasksPerSecond", std::to_string(static_cast<uint64_t>(taskNum / seconds)));
+}
+
+TEST(ConcurrentTest, WorkerThreadThroughputTest)
+{
+    constexpr uint32_t taskNum = 200000;
+    uint64_t sum = 0;
+    Common::WorkerThread workerThread("TestWorkerThread");
+
+    const auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < taskNum; i++) {
+        workerThread.EmplaceTask([&sum, i]() -> void { sum += i; });
+    }
+    workerThread.Flush();
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    ASSERT_EQ(sum, static_cast<uint64_t>(taskNum) * (taskNum - 1) / 2);
+    RecordProperty("tasksPerSecond", std::to_string(static_cast<uint64_t>(taskNum / seconds)));
+}
@@ -2,9 +2,15 @@
 // Created by johnk on 2023/12/5.
 //
 
+#include <string>
+#include <memory>
+#include <random>
+#include <set>
+
 #include <gtest/gtest.h>
 
 #include <Common/Container.h>
+#include <Common/HashMap.h>
 
 TEST(ContainerTest, VectorSwapDeleteTest)
 {
@@ -72,3 +78,242 @@ TEST(ContainerTest, SetGetIntersection)
 
     ASSERT_EQ(result.size(), 3);
 }
+
+TEST(ContainerTest, SetAlgebraTest)
+{
+    std::unordered_set<int> a = { 1, 2, 3, 4, 5 };
+    std::unordered_set<int> b = { 3, 4, 5, 6, 7 };
+    ASSERT_EQ(Common::SetUtils::GetUnion(a, b), (std::unordered_set<int> { 1, 2, 3, 4, 5, 6, 7 }));
+    ASSERT_EQ(Common::SetUtils::GetDifference(a, b), (std::unordered_set<int> { 1, 2 }));
+    ASSERT_TRUE(Common::SetUtils::Intersects(a, b));
+    ASSERT_FALSE(Common::SetUtils::IsSubset(a, b));
+    ASSERT_TRUE(Common::SetUtils::IsSubset(std::unordered_set<int> { 3, 5 }, b));
+
+    Common::FlatHashSet<int> c = { 1, 2, 3 };
+    Common::FlatHashSet<int> d = { 3, 4 };
+    ASSERT_EQ(Common::SetUtils::GetIntersection(c, d), (Common::FlatHashSet<int> { 3 }));
+    ASSERT_FALSE(Common::SetUtils::Intersects(c, Common::FlatHashSet<int> { 5, 6 }));
+}
+
+TEST(ContainerTest, SortedSetAlgebraTest)
+{
+    std::vector<int> a = { 1, 2, 3, 4, 5 };
+    std::vector<int> b = { 3, 4, 5, 6, 7 };
+    ASSERT_EQ(Common::VectorUtils::GetUnion(a, b), (std::vector<int> { 1, 2, 3, 4, 5, 6, 7 }));
+    ASSERT_EQ(Common::VectorUtils::GetDifference(a, b), (std::vector<int> { 1, 2 }));
+    ASSERT_TRUE(Common::VectorUtils::Intersects(a, b));
+    ASSERT_FALSE(Common::VectorUtils::Intersects(a, std::vector<int> { 0, 6, 8 }));
+
+    std::mt19937 random(7); // NOLINT
+    for (uint32_t round = 0; round < 64; round++) {
+        std::uniform_int_distribution<uint32_t> dist(0, 64 + round * 16);
+        std::set<uint32_t> setLhs;
+        std::set<uint32_t> setRhs;
+        for (uint32_t i = 0; i < round * 4; i++) {
+            setLhs.emplace(dist(random));
+            setRhs.emplace(dist(random));
+        }
+        std::vector<uint32_t> lhs(setLhs.begin(), setLhs.end());
+        std::vector<uint32_t> rhs(setRhs.begin(), setRhs.end());
+        ASSERT_EQ(Common::VectorUtils::GetUniqueIntersection(lhs, rhs), Common::VectorUtils::GetIntersection(lhs, rhs));
+    }
+
+    std::vector<int32_t> signedLhs = { -9, -5, -3, -1, 0, 2, 4, 8, 9 };
+    std::vector<int32_t> signedRhs = { -8, -5, -2, -1, 1, 2, 3, 9 };
+    ASSERT_EQ(Common::VectorUtils::GetUniqueIntersection(signedLhs, signedRhs), (std::vector<int32_t> { -5, -1, 2, 9 }));
+}
+
+TEST(ContainerTest, BitSetUtilsTest)
+{
+    std::vector<uint64_t> a(Common::BitSetUtils::GetWordNum(200), 0);
+    std::vector<uint64_t> b(Common::BitSetUtils::GetWordNum(100), 0);
+    ASSERT_EQ(a.size(), 4);
+    ASSERT_EQ(b.size(), 2);
+
+    auto set = [](std::vector<uint64_t>& words, size_t index) -> void { words[index / 64] |= 1ull << (index % 64); };
+    for (size_t index : { 1, 63, 64, 99, 150, 199 }) {
+        set(a, index);
+    }
+    for (size_t index : { 1, 64, 70 }) {
+        set(b, index);
+    }
+
+    ASSERT_EQ(Common::BitSetUtils::Count(a), 6);
+    ASSERT_TRUE(Common::BitSetUtils::Intersects(a, b));
+    ASSERT_FALSE(Common::BitSetUtils::IsSubset(b, a));
+
+    std::vector<uint64_t> intersection = a;
+    Common::BitSetUtils::AndWith(intersection, b);
+    std::vector<size_t> indices;
+    Common::BitSetUtils::ForEachSetBit(intersection, [&](size_t index) -> void { indices.emplace_back(index); });
+    ASSERT_EQ(indices, (std::vector<size_t> { 1, 64 }));
+    ASSERT_TRUE(Common::BitSetUtils::IsSubset(intersection, b));
+
+    std::vector<uint64_t> unionSet = a;
+    Common::BitSetUtils::OrWith(unionSet, b);
+    ASSERT_EQ(Common::BitSetUtils::Count(unionSet), 7);
+
+    Common::BitSetUtils::AndNotWith(unionSet, a);
+    indices.clear();
+    Common::BitSetUtils::ForEachSetBit(unionSet, [&](size_t index) -> void { indices.emplace_back(index); });
+    ASSERT_EQ(indices, (std::vector<size_t> { 70 }));
+}
+
+TEST(ContainerTest, SmallVectorTest)
+{
+    Common::SmallVector<std::string, 4> vec = { "a", "b", "c" };
+    ASSERT_TRUE(vec.IsInline());
+    ASSERT_EQ(vec.size(), 3);
+
+    vec.emplace_back("d");
+    ASSERT_TRUE(vec.IsInline());
+    vec.push_back(vec[0]);
+    ASSERT_FALSE(vec.IsInline());
+    ASSERT_EQ(vec.size(), 5);
+    ASSERT_EQ(vec[4], "a");
+
+    vec.insert(vec.begin() + 1, "e");
+    ASSERT_EQ(vec, (Common::SmallVector<std::string, 4> { "a", "e", "b", "c", "d", "a" }));
+    vec.erase(vec.begin(), vec.begin() + 2);
+    ASSERT_EQ(vec, (Common::SmallVector<std::string, 4> { "b", "c", "d", "a" }));
+
+    Common::SmallVector<std::string, 4> moved = std::move(vec);
+    ASSERT_TRUE(vec.empty()); // NOLINT
+    ASSERT_EQ(moved.size(), 4);
+    moved.resize(2);
+    ASSERT_EQ(moved.back(), "c");
+
+    Common::SmallVector<std::string, 4> inlineMoved = { "x", "y" };
+    Common::SmallVector<std::string, 4> target;
+    target = std::move(inlineMoved);
+    ASSERT_TRUE(target.IsInline());
+    ASSERT_EQ(target, (Common::SmallVector<std::string, 4> { "x", "y" }));
+
+    Common::SmallVector<std::string, 4> copied = target;
+    copied[0] = "z";
+    ASSERT_EQ(target[0], "x");
+}
+
+TEST(ContainerTest, FixedVectorTest)
+{
+    Common::FixedVector<int, 8> vec;
+    for (int i = 0; i < 8; i++) {
+        vec.emplace_back(i);
+    }
+    ASSERT_EQ(vec.size(), 8);
+    ASSERT_EQ(vec.capacity(), 8);
+    ASSERT_TRUE(vec.IsInline());
+
+    int sum = 0;
+    for (const auto& value : vec) {
+        sum += value;
+    }
+    ASSERT_EQ(sum, 28);
+
+    vec.erase(vec.begin() + 3);
+    vec.pop_back();
+    ASSERT_EQ(vec, (Common::FixedVector<int, 8> { 0, 1, 2, 4, 5, 6 }));
+
+    // overflow must never write past inline storage
+    vec.emplace_back(7);
+    vec.emplace_back(8);
+    ASSERT_DEATH(vec.emplace_back(9), "");
+    ASSERT_DEATH(vec.reserve(9), "");
+}
+
+TEST(ContainerTest, InlineFunctionTest)
+{
+    int counter = 0;
+    Common::InlineFunction<int(int)> func = [&counter](int value) -> int {
+        counter += value;
+        return counter;
+    };
+    ASSERT_TRUE(func);
+    ASSERT_EQ(func(2), 2);
+
+    Common::InlineFunction<int(int)> copied = func;
+    ASSERT_EQ(copied(3), 5);
+
+    Common::InlineFunction<int(int)> moved = std::move(func);
+    ASSERT_FALSE(func); // NOLINT
+    ASSERT_EQ(moved(1), 6);
+
+    auto shared = std::make_shared<int>(1);
+    Common::InlineFunction<void()> holder = [shared]() -> void { (*shared)++; };
+    ASSERT_EQ(shared.use_count(), 2);
+    holder();
+    ASSERT_EQ(*shared, 2);
+    holder = nullptr;
+    ASSERT_EQ(shared.use_count(), 1);
+}
+
+TEST(ContainerTest, DynamicBitsetTest)
+{
+    Common::DynamicBitset a(130);
+    ASSERT_EQ(a.Size(), 130);
+    ASSERT_TRUE(a.None());
+    a.Set(0);
+    a.Set(64);
+    a.Set(129);
+    ASSERT_TRUE(a.Test(64));
+    ASSERT_FALSE(a.Test(65));
+    ASSERT_EQ(a.Count(), 3);
+
+    std::vector<size_t> indices(a.begin(), a.end());
+    ASSERT_EQ(indices, (std::vector<size_t> { 0, 64, 129 }));
+
+    Common::DynamicBitset b(70);
+    b.Set(64);
+    b.Set(5);
+    ASSERT_TRUE(a.Intersects(b));
+    ASSERT_EQ((a & b).Count(), 1);
+    ASSERT_TRUE((a & b).Test(64));
+    ASSERT_EQ((a | b).Count(), 4);
+    ASSERT_EQ((a - b).Count(), 2);
+    ASSERT_FALSE(b.IsSubsetOf(a));
+    ASSERT_TRUE((a & b).IsSubsetOf(b));
+
+    a.Reset(64);
+    ASSERT_FALSE(a.Intersects(b));
+
+    Common::DynamicBitset c(10, true);
+    ASSERT_EQ(c.Count(), 10);
+    c.Resize(100, true);
+    ASSERT_EQ(c.Count(), 100);
+    c.Resize(40);
+    ASSERT_EQ(c.Count(), 40);
+    c.ResetAll();
+    ASSERT_EQ(c.begin(), c.end());
+    c.SetAll();
+    ASSERT_EQ(c.Count(), 40);
+}
+
+TEST(ContainerTest, SparseSetTest)
+{
+    Common::SparseSet<uint32_t> set;
+    ASSERT_TRUE(set.Insert(5));
+    ASSERT_TRUE(set.Insert(1000));
+    ASSERT_TRUE(set.Insert(3));
+    ASSERT_FALSE(set.Insert(5));
+    ASSERT_EQ(set.Size(), 3);
+    ASSERT_TRUE(set.Contains(1000));
+    ASSERT_FALSE(set.Contains(4));
+    ASSERT_FALSE(set.Contains(100000));
+
+    ASSERT_TRUE(set.Erase(5));
+    ASSERT_FALSE(set.Erase(5));
+    ASSERT_EQ(set.Size(), 2);
+    ASSERT_EQ(set.Data()[set.GetDenseIndex(3)], 3);
+    ASSERT_EQ(set.Data()[set.GetDenseIndex(1000)], 1000);
+
+    uint32_t sum = 0;
+    for (const auto index : set) {
+        sum += index;
+    }
+    ASSERT_EQ(sum, 1003);
+
+    set.Clear();
+    ASSERT_TRUE(set.Empty());
+    ASSERT_FALSE(set.Contains(3));
+    ASSERT_TRUE(set.Insert(3));
+}
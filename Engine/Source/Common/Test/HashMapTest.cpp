@@ -0,0 +1,238 @@
+//
+// Created by johnk on 2024/3/16.
+//
+
+#include <string>
+#include <unordered_map>
+#include <random>
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include <Common/HashMap.h>
+#include <Common/Memory.h>
+
+TEST(HashMapTest, BasicTest)
+{
+    Common::FlatHashMap<int, std::string> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.find(1), map.end());
+    ASSERT_EQ(map.begin(), map.end());
+
+    ASSERT_TRUE(map.emplace(1, "a").second);
+    ASSERT_TRUE(map.insert({ 2, "b" }).second);
+    ASSERT_TRUE(map.try_emplace(3, "c").second);
+    ASSERT_FALSE(map.try_emplace(3, "d").second);
+    ASSERT_FALSE(map.emplace(1, "e").second);
+    map[4] = "f";
+    ASSERT_FALSE(map.insert_or_assign(4, "g").second);
+
+    ASSERT_EQ(map.size(), 4);
+    ASSERT_EQ(map.at(1), "a");
+    ASSERT_EQ(map.at(2), "b");
+    ASSERT_EQ(map.at(3), "c");
+    ASSERT_EQ(map.at(4), "g");
+    ASSERT_TRUE(map.contains(2));
+    ASSERT_EQ(map.count(5), 0);
+
+    ASSERT_EQ(map.erase(2), 1);
+    ASSERT_EQ(map.erase(2), 0);
+    ASSERT_FALSE(map.contains(2));
+    ASSERT_EQ(map.size(), 3);
+
+    size_t count = 0;
+    for (const auto& [key, value] : map) {
+        ASSERT_EQ(map.at(key), value);
+        count++;
+    }
+    ASSERT_EQ(count, 3);
+
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.begin(), map.end());
+}
+
+TEST(HashMapTest, SetTest)
+{
+    Common::FlatHashSet<std::string> set = { "a", "b", "c" };
+    ASSERT_EQ(set.size(), 3);
+    ASSERT_FALSE(set.insert("a").second);
+    ASSERT_TRUE(set.contains("b"));
+    ASSERT_EQ(set.erase("b"), 1);
+    ASSERT_FALSE(set.contains("b"));
+
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(*set.begin())>>);
+
+    Common::FlatHashSet<std::string> other = { "c", "a" };
+    ASSERT_EQ(set, other);
+    other.insert("d");
+    ASSERT_NE(set, other);
+}
+
+TEST(HashMapTest, RandomOperationTest)
+{
+    std::mt19937 random(42); // NOLINT
+    std::uniform_int_distribution<int> keyDist(0, 2047);
+    std::uniform_int_distribution<int> opDist(0, 2);
+
+    Common::FlatHashMap<int, int> map;
+    std::unordered_map<int, int> reference;
+    for (int i = 0; i < 100000; i++) {
+        const int key = keyDist(random);
+        const int op = opDist(random);
+        if (op == 0) {
+            ASSERT_EQ(map.erase(key), reference.erase(key));
+        } else {
+            map[key] = i;
+            reference[key] = i;
+        }
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    for (const auto& [key, value] : reference) {
+        ASSERT_EQ(map.at(key), value);
+    }
+    size_t count = 0;
+    for (const auto& [key, value] : map) {
+        ASSERT_EQ(reference.at(key), value);
+        count++;
+    }
+    ASSERT_EQ(count, reference.size());
+
+    // erasing everything through iterators leaves tombstones, reinserting must reuse them instead of growing forever
+    const size_t capacity = map.capacity();
+    for (auto iter = map.begin(); iter != map.end();) {
+        iter = map.erase(iter);
+    }
+    ASSERT_TRUE(map.empty());
+    for (int round = 0; round < 16; round++) {
+        for (int i = 0; i < 1024; i++) {
+            map.emplace(round * 1024 + i, i);
+        }
+        for (int i = 0; i < 1024; i++) {
+            map.erase(round * 1024 + i);
+        }
+    }
+    ASSERT_LE(map.capacity(), capacity);
+}
+
+TEST(HashMapTest, CopyMoveTest)
+{
+    Common::FlatHashMap<int, Common::UniqueRef<int>> map;
+    for (int i = 0; i < 100; i++) {
+        map.emplace(i, new int(i));
+    }
+    Common::FlatHashMap<int, Common::UniqueRef<int>> moved = std::move(map);
+    ASSERT_TRUE(map.empty()); // NOLINT
+    ASSERT_EQ(moved.size(), 100);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(*moved.at(i), i);
+    }
+
+    Common::FlatHashMap<int, std::string> map1 = { { 1, "a" }, { 2, "b" } };
+    Common::FlatHashMap<int, std::string> copied = map1;
+    ASSERT_EQ(copied, map1);
+    copied[1] = "c";
+    ASSERT_EQ(map1.at(1), "a");
+    map1 = copied;
+    ASSERT_EQ(map1.at(1), "c");
+}
+
+TEST(HashMapTest, HeterogeneousLookupTest)
+{
+    Common::FlatHashMap<std::string, int, Common::StringHash, std::equal_to<>> map;
+    map.emplace("hello", 1);
+    map.emplace("world", 2);
+
+    const std::string_view key = "hello";
+    ASSERT_TRUE(map.contains(key));
+    ASSERT_EQ(map.at(key), 1);
+    ASSERT_EQ(map.find("world")->second, 2);
+    ASSERT_EQ(map.erase(std::string_view("world")), 1);
+    ASSERT_FALSE(map.contains("world"));
+}
+
+TEST(HashMapTest, ReserveTest)
+{
+    Common::FlatHashMap<int, int> map;
+    map.reserve(1000);
+    const size_t capacity = map.capacity();
+    ASSERT_GE(capacity, 1000);
+    for (int i = 0; i < 1000; i++) {
+        map.emplace(i, i);
+    }
+    ASSERT_EQ(map.capacity(), capacity);
+}
+
+struct MapBenchmarkResult {
+    double insertMs = 0;
+    double hitMs = 0;
+    double missMs = 0;
+    double eraseMs = 0;
+};
+
+template <typename M>
+static MapBenchmarkResult MeasureMap(const std::vector<size_t>& keys, const std::vector<size_t>& missKeys)
+{
+    const auto measure = [](auto&& func) -> double {
+        const auto begin = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    };
+
+    MapBenchmarkResult result;
+    M map;
+    result.insertMs = measure([&]() -> void {
+        for (const auto key : keys) {
+            map.emplace(key, key);
+        }
+    });
+
+    size_t hitNum = 0;
+    size_t missNum = 0;
+    result.hitMs = measure([&]() -> void {
+        for (const auto key : keys) {
+            hitNum += map.find(key)->second == key ? 1 : 0;
+        }
+    });
+    result.missMs = measure([&]() -> void {
+        for (const auto key : missKeys) {
+            missNum += map.find(key) == map.end() ? 1 : 0;
+        }
+    });
+    EXPECT_EQ(hitNum, keys.size());
+    EXPECT_EQ(missNum, missKeys.size());
+
+    result.eraseMs = measure([&]() -> void {
+        for (const auto key : keys) {
+            map.erase(key);
+        }
+    });
+    EXPECT_TRUE(map.empty());
+    return result;
+}
+
+TEST(HashMapTest, BenchmarkTest)
+{
+    // size_t keys like pipeline / layout cache keys, compares with the std container the caches used before
+    constexpr size_t keyNum = 200000;
+    std::mt19937_64 random(1); // NOLINT
+    std::vector<size_t> keys(keyNum);
+    std::vector<size_t> missKeys(keyNum);
+    for (size_t i = 0; i < keyNum; i++) {
+        keys[i] = random();
+        missKeys[i] = random();
+    }
+
+    const auto flatResult = MeasureMap<Common::FlatHashMap<size_t, size_t>>(keys, missKeys);
+    const auto stdResult = MeasureMap<std::unordered_map<size_t, size_t>>(keys, missKeys);
+
+    RecordProperty("flatInsertMs", std::to_string(flatResult.insertMs));
+    RecordProperty("flatHitMs", std::to_string(flatResult.hitMs));
+    RecordProperty("flatMissMs", std::to_string(flatResult.missMs));
+    RecordProperty("flatEraseMs", std::to_string(flatResult.eraseMs));
+    RecordProperty("stdInsertMs", std::to_string(stdResult.insertMs));
+    RecordProperty("stdHitMs", std::to_string(stdResult.hitMs));
+    RecordProperty("stdMissMs", std::to_string(stdResult.missMs));
+    RecordProperty("stdEraseMs", std::to_string(stdResult.eraseMs));
+}
@@ -2,6 +2,7 @@
 // Created by johnk on 2022/7/3.
 //
 
+#include <string>
 #include <string_view>
 
 #include <gtest/gtest.h>
@@ -18,4 +19,7 @@ TEST(HashTest, StrCrc32Test)
 {
     ASSERT_EQ(Common::HashUtils::StrCrc32("hello"), 0x3610a686);
     ASSERT_EQ(Common::HashUtils::StrCrc32("explosion game engine"), 0xdb39167f);
+    ASSERT_EQ(Common::HashUtils::RuntimeStrCrc32(std::string("hello")), 0x3610a686);
+    ASSERT_EQ(Common::HashUtils::RuntimeStrCrc32("explosion game engine"), Common::HashUtils::StrCrc32("explosion game engine"));
+    ASSERT_EQ(Common::HashUtils::RuntimeStrCrc32(""), Common::HashUtils::StrCrc32(""));
 }
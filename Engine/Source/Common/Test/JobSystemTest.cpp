@@ -0,0 +1,96 @@
+//
+// Created by johnk on 2024/3/2.
+//
+
+#include <gtest/gtest.h>
+
+#include <Common/JobSystem.h>
+
+TEST(JobSystemTest, ScheduleTest)
+{
+    Common::JobSystem jobSystem(Common::JobSystemDesc { 4 });
+    std::atomic<uint32_t> count = 0;
+    Common::JobCounter counter;
+    for (auto i = 0; i < 1000; i++) {
+        jobSystem.Schedule([&count]() -> void { count++; }, &counter);
+    }
+    jobSystem.Wait(counter);
+    ASSERT_TRUE(counter.Finished());
+    ASSERT_EQ(count, 1000);
+}
+
+TEST(JobSystemTest, DependencyTest)
+{
+    Common::JobSystem jobSystem(Common::JobSystemDesc { 4 });
+    std::atomic<uint32_t> count = 0;
+    std::atomic<uint32_t> observed = 0;
+    Common::JobCounter first;
+    Common::JobCounter second;
+    for (auto i = 0; i < 100; i++) {
+        jobSystem.Schedule([&count]() -> void {
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+            count++;
+        }, &first);
+    }
+    jobSystem.Schedule([&count, &observed]() -> void { observed = count.load(); }, &second, &first);
+    jobSystem.Wait(second);
+    ASSERT_EQ(observed, 100);
+}
+
+TEST(JobSystemTest, NestedWaitTest)
+{
+    // waiting inside a job must not deadlock, even with a single worker
+    Common::JobSystem jobSystem(Common::JobSystemDesc { 1 });
+    std::atomic<uint32_t> count = 0;
+    Common::JobCounter outer;
+    jobSystem.Schedule([&jobSystem, &count]() -> void {
+        Common::JobCounter inner;
+        for (auto i = 0; i < 10; i++) {
+            jobSystem.Schedule([&count]() -> void { count++; }, &inner);
+        }
+        jobSystem.Wait(inner);
+    }, &outer);
+    jobSystem.Wait(outer);
+    ASSERT_EQ(count, 10);
+}
+
+TEST(JobSystemTest, EmplaceTaskTest)
+{
+    Common::JobSystem jobSystem(Common::JobSystemDesc { 4 });
+    std::vector<std::future<uint32_t>> futures;
+    for (uint32_t i = 0; i < 20; i++) {
+        futures.emplace_back(jobSystem.EmplaceTask([](uint32_t value) -> uint32_t { return value * 2; }, i));
+    }
+    for (uint32_t i = 0; i < 20; i++) {
+        ASSERT_EQ(futures[i].get(), i * 2);
+    }
+}
+
+TEST(JobSystemTest, ParallelForTest)
+{
+    Common::JobSystem jobSystem(Common::JobSystemDesc { 4 });
+    std::vector<uint32_t> values(10000, 0);
+    jobSystem.ParallelFor(values.size(), 64, [&values](size_t begin, size_t end) -> void {
+        for (auto i = begin; i < end; i++) {
+            values[i] = static_cast<uint32_t>(i);
+        }
+    });
+    for (auto i = 0; i < values.size(); i++) {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST(JobSystemTest, ParallelReduceTest)
+{
+    Common::JobSystem jobSystem(Common::JobSystemDesc { 4 });
+    const auto sum = jobSystem.ParallelReduce(10000, 100, 0ull,
+        [](size_t begin, size_t end) -> uint64_t {
+            uint64_t result = 0;
+            for (auto i = begin; i < end; i++) {
+                result += i;
+            }
+            return result;
+        },
+        [](uint64_t lhs, uint64_t rhs) -> uint64_t { return lhs + rhs; });
+    ASSERT_EQ(sum, 10000ull * 9999 / 2);
+}
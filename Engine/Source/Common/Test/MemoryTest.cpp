@@ -2,6 +2,12 @@
 // Created by johnk on 2023/4/14.
 //
 
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <Common/Memory.h>
@@ -134,3 +140,349 @@ TEST(MemoryTest, WeakRefDeriveTest)
     ASSERT_EQ(live, false);
     ASSERT_EQ(weakRef.Expired(), true);
 }
+
+TEST(MemoryTest, LinearAllocatorTest)
+{
+    LinearAllocator allocator(256);
+    auto* first = static_cast<uint8_t*>(allocator.Allocate(1, 1));
+    auto* second = static_cast<uint64_t*>(allocator.Allocate(sizeof(uint64_t), alignof(uint64_t)));
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(second) % alignof(uint64_t), 0);
+    ASSERT_EQ(allocator.Allocate(512, 1), nullptr);
+
+    const auto marker = allocator.GetMarker();
+    ASSERT_NE(allocator.Allocate(64, 16), nullptr);
+    allocator.Rewind(marker);
+    ASSERT_EQ(allocator.GetUsedSize(), marker);
+
+    allocator.Reset();
+    ASSERT_EQ(allocator.GetUsedSize(), 0);
+    ASSERT_EQ(allocator.Allocate(1, 1), first);
+}
+
+TEST(MemoryTest, ArenaAllocatorTest)
+{
+    ArenaAllocator allocator(128);
+    for (auto i = 0; i < 16; i++) {
+        ASSERT_NE(allocator.Allocate(64, 8), nullptr);
+    }
+    ASSERT_EQ(allocator.GetBlockNum(), 8);
+    ASSERT_NE(allocator.Allocate(1024, 8), nullptr);
+    ASSERT_EQ(allocator.GetBlockNum(), 9);
+
+    allocator.Reset();
+    ASSERT_EQ(allocator.GetUsedSize(), 0);
+    for (auto i = 0; i < 16; i++) {
+        ASSERT_NE(allocator.Allocate(64, 8), nullptr);
+    }
+    ASSERT_EQ(allocator.GetBlockNum(), 9);
+
+    const auto marker = allocator.GetMarker();
+    const auto usedSize = allocator.GetUsedSize();
+    ASSERT_NE(allocator.Allocate(512, 8), nullptr);
+    allocator.Rewind(marker);
+    ASSERT_EQ(allocator.GetUsedSize(), usedSize);
+}
+
+TEST(MemoryTest, FrameAllocatorTest)
+{
+    FrameAllocator allocator(1024);
+    auto* lastFrameValue = static_cast<uint32_t*>(allocator.Allocate(sizeof(uint32_t), alignof(uint32_t)));
+    *lastFrameValue = 1;
+    allocator.NextFrame();
+    auto* currentFrameValue = static_cast<uint32_t*>(allocator.Allocate(sizeof(uint32_t), alignof(uint32_t)));
+    *currentFrameValue = 2;
+    ASSERT_NE(lastFrameValue, currentFrameValue);
+    ASSERT_EQ(*lastFrameValue, 1);
+    ASSERT_EQ(allocator.GetUsedSize(), sizeof(uint32_t) * 2);
+
+    allocator.NextFrame();
+    ASSERT_EQ(allocator.GetUsedSize(), sizeof(uint32_t));
+    ASSERT_EQ(allocator.Allocate(sizeof(uint32_t), alignof(uint32_t)), lastFrameValue);
+}
+
+TEST(MemoryTest, ScratchScopeTest)
+{
+    void* outer;
+    {
+        ScratchScope scope;
+        outer = scope.Allocate(64);
+        {
+            ScratchScope innerScope;
+            std::vector<uint32_t, ScratchStlAllocator<uint32_t>> values(innerScope);
+            for (uint32_t i = 0; i < 100; i++) {
+                values.emplace_back(i);
+            }
+            ASSERT_EQ(values[99], 99);
+        }
+        ASSERT_EQ(scope.GetArena().GetUsedSize(), 64);
+    }
+    ScratchScope scope;
+    ASSERT_EQ(scope.GetArena().GetUsedSize(), 0);
+    ASSERT_EQ(scope.Allocate(64), outer);
+}
+
+TEST(MemoryTest, AllocatorBenchmarkTest)
+{
+    // per frame temporaries of mixed small sizes, allocated and released once per frame, compares allocators with malloc and new
+    constexpr uint32_t frameNum = 100;
+    constexpr uint32_t allocationNum = 10000;
+    std::vector<size_t> sizes(allocationNum);
+    for (uint32_t i = 0; i < allocationNum; i++) {
+        sizes[i] = 16 + (i * 37) % 241;
+    }
+    std::vector<void*> pointers(allocationNum);
+
+    // every allocation is touched, so none of them can be optimized away
+    uint64_t checksum = 0;
+    const auto measure = [&](auto&& frameFunc) -> double {
+        const auto begin = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < frameNum; frame++) {
+            frameFunc();
+            for (const auto* pointer : pointers) {
+                checksum += *static_cast<const uint8_t*>(pointer);
+            }
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    };
+
+    const double mallocMs = measure([&]() -> void {
+        for (auto*& pointer : pointers) {
+            free(pointer);
+        }
+        for (uint32_t i = 0; i < allocationNum; i++) {
+            pointers[i] = malloc(sizes[i]);
+            *static_cast<uint8_t*>(pointers[i]) = 1;
+        }
+    });
+    for (auto*& pointer : pointers) {
+        free(pointer);
+        pointer = nullptr;
+    }
+
+    const double newMs = measure([&]() -> void {
+        for (auto*& pointer : pointers) {
+            delete[] static_cast<uint8_t*>(pointer);
+        }
+        for (uint32_t i = 0; i < allocationNum; i++) {
+            pointers[i] = new uint8_t[sizes[i]];
+            *static_cast<uint8_t*>(pointers[i]) = 1;
+        }
+    });
+    for (auto*& pointer : pointers) {
+        delete[] static_cast<uint8_t*>(pointer);
+        pointer = nullptr;
+    }
+
+    FrameAllocator frameAllocator;
+    const double frameMs = measure([&]() -> void {
+        frameAllocator.NextFrame();
+        for (uint32_t i = 0; i < allocationNum; i++) {
+            pointers[i] = frameAllocator.Allocate(sizes[i]);
+            *static_cast<uint8_t*>(pointers[i]) = 1;
+        }
+    });
+
+    ArenaAllocator arena;
+    const double arenaMs = measure([&]() -> void {
+        arena.Reset();
+        for (uint32_t i = 0; i < allocationNum; i++) {
+            pointers[i] = arena.Allocate(sizes[i]);
+            *static_cast<uint8_t*>(pointers[i]) = 1;
+        }
+    });
+
+    ASSERT_EQ(checksum, static_cast<uint64_t>(frameNum) * allocationNum * 4);
+    RecordProperty("mallocMs", std::to_string(mallocMs));
+    RecordProperty("newMs", std::to_string(newMs));
+    RecordProperty("frameAllocatorMs", std::to_string(frameMs));
+    RecordProperty("arenaAllocatorMs", std::to_string(arenaMs));
+}
+
+TEST(MemoryTest, StlAllocatorTest)
+{
+    ArenaAllocator arena;
+    std::vector<uint64_t, ArenaStlAllocator<uint64_t>> values(arena);
+    values.reserve(10);
+    for (uint64_t i = 0; i < 10; i++) {
+        values.emplace_back(i);
+    }
+    ASSERT_EQ(values[9], 9);
+    ASSERT_GE(arena.GetUsedSize(), sizeof(uint64_t) * 10);
+
+    ArenaStlAllocator<uint32_t> rebound = values.get_allocator();
+    ASSERT_EQ(rebound.GetAllocator(), &arena);
+}
+
+TEST(MemoryTest, ObjectPoolTest)
+{
+    bool live;
+    TestStruct* object = ObjectPool<TestStruct>::New(1, live);
+    ASSERT_EQ(live, true);
+    ASSERT_EQ(object->value, 1);
+    ObjectPool<TestStruct>::Delete(object);
+    ASSERT_EQ(live, false);
+
+    // freed block is reused by next allocation of same thread
+    TestStruct* reused = ObjectPool<TestStruct>::New(2, live);
+    ASSERT_EQ(reused, object);
+    ObjectPool<TestStruct>::Delete(reused);
+}
+
+TEST(MemoryTest, PooledRefTest)
+{
+    bool live;
+    {
+        PooledUniqueRef<TestStruct> ref = MakePooledUnique<TestStruct>(1, live);
+        ASSERT_EQ(live, true);
+        ASSERT_EQ(ref->value, 1);
+    }
+    ASSERT_EQ(live, false);
+
+    {
+        SharedRef<ChildTestStruct> ref = MakePooledShared<ChildTestStruct>(1, 2, live);
+        SharedRef<TestStruct> baseRef = ref.StaticCast<TestStruct>();
+        ref.Reset();
+        ASSERT_EQ(live, true);
+        ASSERT_EQ(baseRef->value, 1);
+    }
+    ASSERT_EQ(live, false);
+}
+
+TEST(MemoryTest, ObjectPoolMultiThreadTest)
+{
+    // objects are freed on another thread than the one allocated them, so blocks flow through global list
+    std::vector<std::vector<uint64_t*>> objects(4);
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 4; i++) {
+        threads.emplace_back([&objects, i]() -> void {
+            for (uint64_t j = 0; j < 10000; j++) {
+                objects[i].emplace_back(ObjectPool<uint64_t>::New(j));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+
+    for (auto i = 0; i < 4; i++) {
+        threads.emplace_back([&objects, i]() -> void {
+            auto& list = objects[(i + 1) % 4];
+            for (uint64_t j = 0; j < list.size(); j++) {
+                ASSERT_EQ(*list[j], j);
+                ObjectPool<uint64_t>::Delete(list[j]);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+struct IntrusiveTestStruct : public RefCounted<> {
+    uint32_t value;
+    bool& live;
+
+    IntrusiveTestStruct(uint32_t inValue, bool& inLive) : value(inValue), live(inLive)
+    {
+        live = true;
+    }
+
+    ~IntrusiveTestStruct() override
+    {
+        live = false;
+    }
+};
+
+struct ChildIntrusiveTestStruct : public IntrusiveTestStruct {
+    uint32_t cValue;
+
+    ChildIntrusiveTestStruct(uint32_t inValue, uint32_t inCValue, bool& inLive) : IntrusiveTestStruct(inValue, inLive), cValue(inCValue)
+    {
+    }
+};
+
+struct LocalIntrusiveTestStruct : public RefCounted<NonAtomicRefCountPolicy> {
+    uint32_t value = 0;
+};
+
+TEST(MemoryTest, IntrusiveRefTest)
+{
+    bool live;
+    {
+        IntrusiveRef<IntrusiveTestStruct> ref1 = MakeIntrusive<IntrusiveTestStruct>(1, live);
+        ASSERT_EQ(live, true);
+        ASSERT_EQ(ref1->value, 1);
+        ASSERT_EQ(ref1.RefCount(), 1);
+        {
+            IntrusiveRef<IntrusiveTestStruct> ref2 = ref1;
+            ASSERT_EQ(ref1.RefCount(), 2);
+            ref2 = ref1;
+            ASSERT_EQ(ref1.RefCount(), 2);
+        }
+        ASSERT_EQ(ref1.RefCount(), 1);
+
+        IntrusiveRef<IntrusiveTestStruct> ref3 = std::move(ref1);
+        ASSERT_EQ(ref1, nullptr);
+        ASSERT_EQ(ref3.RefCount(), 1);
+        ASSERT_EQ(live, true);
+    }
+    ASSERT_EQ(live, false);
+
+    {
+        IntrusiveRef<ChildIntrusiveTestStruct> ref1 = MakeIntrusive<ChildIntrusiveTestStruct>(1, 2, live);
+        IntrusiveRef<IntrusiveTestStruct> ref2 = ref1;
+        ASSERT_EQ(ref2.RefCount(), 2);
+        ref1.Reset();
+        ASSERT_EQ(live, true);
+        ASSERT_EQ(ref2.DynamicCast<ChildIntrusiveTestStruct>()->cValue, 2);
+    }
+    ASSERT_EQ(live, false);
+
+    {
+        IntrusiveRef<LocalIntrusiveTestStruct> ref1 = MakeIntrusive<LocalIntrusiveTestStruct>();
+        IntrusiveRef<LocalIntrusiveTestStruct> ref2 = ref1;
+        ref2->value = 1;
+        ASSERT_EQ(ref1->value, 1);
+        ASSERT_EQ(ref1.RefCount(), 2);
+    }
+}
+
+TEST(MemoryTest, IntrusiveWeakRefTest)
+{
+    bool live;
+    IntrusiveWeakRef<IntrusiveTestStruct> weakRef;
+    {
+        IntrusiveRef<IntrusiveTestStruct> ref = MakeIntrusive<IntrusiveTestStruct>(1, live);
+        weakRef = ref;
+        IntrusiveWeakRef<IntrusiveTestStruct> weakRef2 = weakRef;
+        ASSERT_FALSE(weakRef.Expired());
+        {
+            auto locked = weakRef2.Lock();
+            ASSERT_EQ(locked->value, 1);
+            ASSERT_EQ(ref.RefCount(), 2);
+        }
+        ASSERT_EQ(ref.RefCount(), 1);
+    }
+    ASSERT_EQ(live, false);
+    ASSERT_TRUE(weakRef.Expired());
+    ASSERT_EQ(weakRef.Lock(), nullptr);
+
+    // weak refs racing with the last strong ref must either revive the object or see it expired
+    for (auto i = 0; i < 100; i++) {
+        IntrusiveRef<IntrusiveTestStruct> ref = MakeIntrusive<IntrusiveTestStruct>(1, live);
+        IntrusiveWeakRef<IntrusiveTestStruct> racingRef = ref;
+        std::thread thread([&racingRef]() -> void {
+            for (auto j = 0; j < 100; j++) {
+                if (auto locked = racingRef.Lock(); locked != nullptr) {
+                    ASSERT_EQ(locked->value, 1);
+                }
+            }
+        });
+        ref.Reset();
+        thread.join();
+        ASSERT_EQ(live, false);
+    }
+}
@@ -3,6 +3,7 @@
 //
 
 #include <filesystem>
+#include <chrono>
 
 #include <gtest/gtest.h>
 
@@ -29,3 +30,322 @@ TEST(SerializationTest, FileStreamTest)
         ASSERT_EQ(value, 5);
     }
 }
+
+template <typename T>
+static T SerializeAndDeserialize(const T& value, size_t* outSize = nullptr)
+{
+    std::vector<uint8_t> bytes;
+    {
+        ByteSerializeStream stream(bytes);
+        Serializer<T>::Serialize(stream, value);
+    }
+    if (outSize != nullptr) {
+        *outSize = bytes.size();
+    }
+
+    T result;
+    ByteDeserializeStream stream(bytes);
+    EXPECT_TRUE(Serializer<T>::Deserialize(stream, result));
+    return result;
+}
+
+TEST(SerializationTest, BulkContainerTest)
+{
+    static_assert(BulkSerializable<float>);
+    static_assert(BulkSerializable<HFloat>);
+    static_assert(BulkSerializable<FVec3>);
+    static_assert(BulkSerializable<FMat4x4>);
+    static_assert(!BulkSerializable<std::string>);
+    static_assert(!BulkSerializable<std::vector<float>>);
+
+    size_t size = 0;
+    const std::vector<float> floats = { 1.0f, 2.0f, 3.0f };
+    ASSERT_EQ(SerializeAndDeserialize(floats, &size), floats);
+    // type id, size with its type id and the raw block
+    ASSERT_EQ(size, sizeof(uint32_t) * 2 + sizeof(uint64_t) + sizeof(float) * 3);
+
+    const std::vector<FVec3> positions = { FVec3(1, 2, 3), FVec3(4, 5, 6) };
+    ASSERT_EQ(SerializeAndDeserialize(positions), positions);
+
+    const std::vector<FMat4x4> matrices = { FMat4x4Consts::identity, FMat4x4(2.0f) };
+    ASSERT_EQ(SerializeAndDeserialize(matrices), matrices);
+
+    const std::vector<HFloat> halves = { HFloat(1.5f), HFloat(-2.0f) };
+    const auto halvesResult = SerializeAndDeserialize(halves);
+    ASSERT_EQ(halvesResult.size(), 2);
+    ASSERT_EQ(halvesResult[0].value, halves[0].value);
+    ASSERT_EQ(halvesResult[1].value, halves[1].value);
+
+    const std::vector<bool> bools = { true, false, true };
+    ASSERT_EQ(SerializeAndDeserialize(bools), bools);
+
+    const std::vector<std::string> strings = { "a", "bc" };
+    ASSERT_EQ(SerializeAndDeserialize(strings), strings);
+
+    const std::unordered_set<uint32_t> set = { 1, 5, 9 };
+    ASSERT_EQ(SerializeAndDeserialize(set), set);
+
+    const std::unordered_map<uint32_t, float> map = { { 1, 2.0f }, { 3, 4.0f } };
+    ASSERT_EQ(SerializeAndDeserialize(map), map);
+
+    const std::unordered_map<std::string, std::vector<uint8_t>> blobs = { { "a", { 1, 2 } }, { "b", {} } };
+    ASSERT_EQ(SerializeAndDeserialize(blobs), blobs);
+
+    // empty containers write no block at all
+    ASSERT_TRUE(SerializeAndDeserialize(std::vector<float>()).empty());
+    ASSERT_TRUE(SerializeAndDeserialize(std::unordered_set<uint32_t>()).empty());
+    ASSERT_TRUE((SerializeAndDeserialize(std::unordered_map<uint32_t, float>()).empty()));
+    ASSERT_EQ(SerializeAndDeserialize(std::vector<float>(), &size).size(), 0);
+    ASSERT_EQ(size, sizeof(uint32_t) * 2 + sizeof(uint64_t));
+}
+
+TEST(SerializationTest, LegacyLayoutTest)
+{
+    // layout written before bulk serialization, a type id and a value per element
+    std::vector<uint8_t> bytes;
+    {
+        ByteSerializeStream stream(bytes);
+        TypeIdSerializer<std::vector<float>>::Serialize(stream);
+        Serializer<uint64_t>::Serialize(stream, 2);
+        Serializer<float>::Serialize(stream, 1.0f);
+        Serializer<float>::Serialize(stream, 2.0f);
+
+        TypeIdSerializer<uint32_t>::Serialize(stream);
+        Serializer<uint64_t>::Serialize(stream, 1);
+        Serializer<uint32_t>::Serialize(stream, 7);
+
+        TypeIdSerializer<std::unordered_map<uint32_t, float>>::Serialize(stream);
+        Serializer<uint64_t>::Serialize(stream, 1);
+        Serializer<uint32_t>::Serialize(stream, 3);
+        Serializer<float>::Serialize(stream, 4.0f);
+    }
+
+    ByteDeserializeStream stream(bytes);
+    std::vector<float> floats;
+    ASSERT_TRUE(Serializer<std::vector<float>>::Deserialize(stream, floats));
+    ASSERT_EQ(floats, std::vector<float>({ 1.0f, 2.0f }));
+
+    std::unordered_set<uint32_t> set;
+    ASSERT_TRUE(Serializer<std::unordered_set<uint32_t>>::Deserialize(stream, set));
+    ASSERT_EQ(set, std::unordered_set<uint32_t>({ 7 }));
+
+    std::unordered_map<uint32_t, float> map;
+    ASSERT_TRUE((Serializer<std::unordered_map<uint32_t, float>>::Deserialize(stream, map)));
+    ASSERT_EQ(map, (std::unordered_map<uint32_t, float>({ { 3, 4.0f } })));
+}
+
+TEST(SerializationTest, BulkLayoutMismatchTest)
+{
+    // bulk layout for an element type which is not bulk serializable, e.g. after element type changed
+    std::vector<uint8_t> bytes;
+    {
+        ByteSerializeStream stream(bytes);
+        TypeIdSerializer<std::vector<std::string>>::SerializeBulk(stream);
+        Serializer<uint64_t>::Serialize(stream, 4);
+        const uint32_t garbage = 0xffffffff;
+        stream.Write(&garbage, sizeof(uint32_t));
+    }
+
+    ByteDeserializeStream stream(bytes);
+    std::vector<std::string> strings;
+    ASSERT_FALSE(Serializer<std::vector<std::string>>::Deserialize(stream, strings));
+    ASSERT_TRUE(strings.empty());
+}
+
+TEST(SerializationTest, BoundedStreamTest)
+{
+    std::vector<uint8_t> bytes;
+    {
+        ByteSerializeStream stream(bytes);
+        Serializer<std::string>::Serialize(stream, "hello");
+        Serializer<uint32_t>::Serialize(stream, 1);
+    }
+
+    ByteDeserializeStream stream(bytes);
+    {
+        // string is type id, size and 5 chars, the bound cuts off the last two chars
+        BoundedDeserializeStream boundedStream(stream, sizeof(uint32_t) * 2 + sizeof(uint64_t) + 3);
+        ASSERT_TRUE(boundedStream.Peek(bytes.size()).empty());
+        std::string value;
+        Serializer<std::string>::Deserialize(boundedStream, value);
+        ASSERT_TRUE(boundedStream.Overflowed());
+    }
+    {
+        // unread bytes are skipped when the bounded stream is destroyed
+        BoundedDeserializeStream boundedStream(stream, 2);
+        ASSERT_FALSE(boundedStream.Overflowed());
+    }
+
+    uint32_t tail = 0;
+    ASSERT_TRUE(Serializer<uint32_t>::Deserialize(stream, tail));
+    ASSERT_EQ(tail, 1);
+}
+
+TEST(SerializationTest, MeshPayloadTest)
+{
+    // mesh sized payload, positions of 1M vertices
+    std::vector<FVec3> positions(1000000);
+    for (auto i = 0; i < positions.size(); i++) {
+        positions[i] = FVec3(static_cast<float>(i), static_cast<float>(i) * 0.5f, -static_cast<float>(i));
+    }
+
+    std::vector<uint8_t> bytes;
+    const auto begin = std::chrono::steady_clock::now();
+    {
+        ByteSerializeStream stream(bytes);
+        Serializer<std::vector<FVec3>>::Serialize(stream, positions);
+    }
+    const auto serialized = std::chrono::steady_clock::now();
+    std::vector<FVec3> result;
+    {
+        ByteDeserializeStream stream(bytes);
+        ASSERT_TRUE(Serializer<std::vector<FVec3>>::Deserialize(stream, result));
+    }
+    const auto deserialized = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(result, positions);
+    ASSERT_EQ(bytes.size(), sizeof(uint32_t) * 2 + sizeof(uint64_t) + sizeof(FVec3) * positions.size());
+    RecordProperty("serializeMs", std::to_string(std::chrono::duration<double, std::milli>(serialized - begin).count()));
+    RecordProperty("deserializeMs", std::to_string(std::chrono::duration<double, std::milli>(deserialized - serialized).count()));
+}
+
+TEST(SerializationTest, BufferedAndMappedFileStreamTest)
+{
+    static std::filesystem::path fileName = "../Test/Generated/SerializationTest.BufferedAndMappedFileStreamTest.bin";
+    std::filesystem::create_directories(fileName.parent_path());
+
+    std::vector<float> floats(100);
+    for (auto i = 0; i < floats.size(); i++) {
+        floats[i] = static_cast<float>(i);
+    }
+    {
+        // small buffer makes both buffered writes and writes bypassing the buffer happen
+        BufferedFileSerializeStream stream(fileName.string(), 64);
+        Serializer<uint32_t>::Serialize(stream, 5);
+        Serializer<std::vector<float>>::Serialize(stream, floats);
+        Serializer<std::string>::Serialize(stream, "hello");
+    }
+
+    {
+        auto file = MakeShared<MappedFile>(fileName.string());
+        ASSERT_TRUE(file->IsValid());
+        ASSERT_EQ(file->GetSize(), std::filesystem::file_size(fileName));
+
+        MappedFileDeserializeStream stream(file);
+        uint32_t value;
+        ASSERT_TRUE(Serializer<uint32_t>::Deserialize(stream, value));
+        ASSERT_EQ(value, 5);
+
+        // peek does not consume, so the vector can still be deserialized after it
+        const auto peeked = stream.Peek(sizeof(uint32_t));
+        ASSERT_EQ(peeked.size(), sizeof(uint32_t));
+        ASSERT_EQ(peeked.data(), file->GetData() + sizeof(uint32_t) + sizeof(uint32_t));
+        std::vector<float> floatsResult;
+        ASSERT_TRUE(Serializer<std::vector<float>>::Deserialize(stream, floatsResult));
+        ASSERT_EQ(floatsResult, floats);
+
+        // skip type id and size of string
+        stream.Skip(sizeof(uint32_t) * 2 + sizeof(uint64_t));
+        const auto chars = stream.Peek(5);
+        ASSERT_EQ(std::string(reinterpret_cast<const char*>(chars.data()), chars.size()), "hello");
+    }
+
+    {
+        BinaryFileDeserializeStream stream(fileName.string());
+        ASSERT_TRUE(stream.Peek(sizeof(uint32_t)).empty());
+        stream.Skip(sizeof(uint32_t) * 2);
+        std::vector<float> floatsResult;
+        ASSERT_TRUE(Serializer<std::vector<float>>::Deserialize(stream, floatsResult));
+        ASSERT_EQ(floatsResult, floats);
+    }
+
+    ASSERT_FALSE(MappedFile("../Test/Generated/SerializationTest.NotExists.bin").IsValid());
+
+    // missing file is reported by the stream, and reading it fails without touching the null mapping
+    MappedFileDeserializeStream missingStream("../Test/Generated/SerializationTest.NotExists.bin");
+    ASSERT_FALSE(missingStream.IsValid());
+    ASSERT_TRUE(missingStream.Peek(sizeof(uint32_t)).empty());
+    uint32_t missingValue;
+    ASSERT_FALSE(Serializer<uint32_t>::Deserialize(missingStream, missingValue));
+}
+
+TEST(SerializationTest, ViewTest)
+{
+    static std::filesystem::path fileName = "../Test/Generated/SerializationTest.ViewTest.bin";
+    std::filesystem::create_directories(fileName.parent_path());
+
+    const std::vector<uint8_t> blob = { 1, 2, 3, 4, 5 };
+    const std::unordered_map<std::string, std::vector<uint8_t>> components = { { "a", { 6, 7 } }, { "b", {} } };
+    {
+        BufferedFileSerializeStream stream(fileName.string());
+        Serializer<std::vector<uint8_t>>::Serialize(stream, blob);
+        Serializer<std::string>::Serialize(stream, "hello");
+        Serializer<std::unordered_map<std::string, std::vector<uint8_t>>>::Serialize(stream, components);
+    }
+
+    SpanView<uint8_t> blobView;
+    StringView stringView;
+    std::unordered_map<std::string, SpanView<uint8_t>> componentViews;
+    {
+        MappedFileDeserializeStream stream(fileName.string());
+        stream.SetZeroCopy(true);
+        ASSERT_TRUE(Serializer<SpanView<uint8_t>>::Deserialize(stream, blobView));
+        ASSERT_TRUE(Serializer<StringView>::Deserialize(stream, stringView));
+        ASSERT_TRUE((Serializer<std::unordered_map<std::string, SpanView<uint8_t>>>::Deserialize(stream, componentViews)));
+
+        const auto* mapped = stream.GetFile()->GetData();
+        const auto* mappedEnd = mapped + stream.GetFile()->GetSize();
+        ASSERT_FALSE(blobView.IsOwning());
+        ASSERT_TRUE(blobView.data() >= mapped && blobView.data() < mappedEnd);
+        ASSERT_FALSE(stringView.IsOwning());
+        ASSERT_FALSE(componentViews.at("a").IsOwning());
+    }
+
+    // views keep the mapping alive after the stream is gone
+    ASSERT_EQ(blobView.ToVector(), blob);
+    ASSERT_EQ(stringView.View(), "hello");
+    ASSERT_EQ(componentViews.at("a").ToVector(), std::vector<uint8_t>({ 6, 7 }));
+    ASSERT_TRUE(componentViews.at("b").empty());
+
+    // copies of views share the mapping, copies of owning views own their copy
+    SpanView<uint8_t> copied = blobView;
+    ASSERT_EQ(copied.data(), blobView.data());
+    SpanView<uint8_t> owning(std::vector<uint8_t> { 8, 9 });
+    SpanView<uint8_t> owningCopied = owning;
+    ASSERT_TRUE(owningCopied.IsOwning());
+    ASSERT_NE(owningCopied.data(), owning.data());
+    ASSERT_EQ(owningCopied, owning);
+
+    {
+        // without zero copy mode views own their elements, and they serialize the same as std::vector
+        std::vector<uint8_t> bytes;
+        {
+            ByteSerializeStream stream(bytes);
+            Serializer<SpanView<uint8_t>>::Serialize(stream, blobView);
+            Serializer<StringView>::Serialize(stream, stringView);
+        }
+        ByteDeserializeStream stream(bytes);
+        SpanView<uint8_t> ownedBlob;
+        ASSERT_TRUE(Serializer<SpanView<uint8_t>>::Deserialize(stream, ownedBlob));
+        ASSERT_TRUE(ownedBlob.IsOwning());
+        ASSERT_EQ(ownedBlob, blobView);
+        std::string string;
+        ASSERT_TRUE(Serializer<std::string>::Deserialize(stream, string));
+        ASSERT_EQ(string, "hello");
+    }
+
+    {
+        // misaligned elements fall back to a copy
+        std::vector<uint8_t> bytes(1);
+        {
+            ByteSerializeStream stream(bytes, 1);
+            Serializer<std::vector<float>>::Serialize(stream, { 1.0f, 2.0f });
+        }
+        ByteDeserializeStream stream(bytes, 1);
+        stream.SetZeroCopy(true);
+        SpanView<float> floats;
+        ASSERT_TRUE(Serializer<SpanView<float>>::Deserialize(stream, floats));
+        ASSERT_TRUE(floats.IsOwning());
+        ASSERT_EQ(floats.ToVector(), std::vector<float>({ 1.0f, 2.0f }));
+    }
+}
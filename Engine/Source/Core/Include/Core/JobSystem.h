@@ -0,0 +1,21 @@
+//
+// Created by johnk on 2024/3/2.
+//
+
+#pragma once
+
+#include <Common/JobSystem.h>
+#include <Core/Api.h>
+
+namespace Core {
+    // process wide job system, Common is linked statically into every module, so the instance lives here to be shared by all modules
+    class CORE_API JobSystem {
+    public:
+        // must be called before the first Get(), the job system lives until process exit once created
+        static void Configure(const Common::JobSystemDesc& inDesc);
+        static Common::JobSystem& Get();
+
+    private:
+        static Common::JobSystemDesc& GetDesc();
+    };
+}
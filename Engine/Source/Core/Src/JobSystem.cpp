@@ -0,0 +1,33 @@
+//
+// Created by johnk on 2024/3/2.
+//
+
+#include <atomic>
+
+#include <Core/JobSystem.h>
+#include <Common/Debug.h>
+
+namespace Core::Internal {
+    static std::atomic<bool> jobSystemCreated = false;
+}
+
+namespace Core {
+    void JobSystem::Configure(const Common::JobSystemDesc& inDesc)
+    {
+        Assert(!Internal::jobSystemCreated.load());
+        GetDesc() = inDesc;
+    }
+
+    Common::JobSystem& JobSystem::Get()
+    {
+        Internal::jobSystemCreated.store(true);
+        static Common::JobSystem instance(GetDesc());
+        return instance;
+    }
+
+    Common::JobSystemDesc& JobSystem::GetDesc()
+    {
+        static Common::JobSystemDesc desc;
+        return desc;
+    }
+}
@@ -0,0 +1,26 @@
+//
+// Created by johnk on 2024/3/2.
+//
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include <Core/JobSystem.h>
+
+TEST(JobSystemTest, SharedInstanceTest)
+{
+    Core::JobSystem::Configure(Common::JobSystemDesc { 2 });
+    auto& jobSystem = Core::JobSystem::Get();
+    ASSERT_EQ(&jobSystem, &Core::JobSystem::Get());
+    ASSERT_EQ(jobSystem.GetThreadNum(), 2);
+    ASSERT_EQ(jobSystem.GetCurrentWorkerSlot(), 2);
+
+    std::atomic<uint32_t> count = 0;
+    Common::JobCounter counter;
+    for (auto i = 0; i < 16; i++) {
+        jobSystem.Schedule([&]() -> void { count++; }, &counter);
+    }
+    jobSystem.Wait(counter);
+    ASSERT_EQ(count.load(), 16);
+}
@@ -23,3 +23,5 @@ private: \
     static int _mirrorRegistry; \
 public: \
     static const Mirror::Class& GetClass(); \
+    static void _mirrorSerialize(Common::SerializeStream& stream, const className& value); \
+    static bool _mirrorDeserialize(Common::DeserializeStream& stream, className& value); \
@@ -5,6 +5,8 @@
 #pragma once
 
 #include <vector>
+#include <new>
+#include <cstddef>
 #include <array>
 #include <unordered_map>
 #include <optional>
@@ -14,6 +16,7 @@
 #include <typeinfo>
 #include <functional>
 #include <tuple>
+#include <concepts>
 
 #include <Common/Serialization.h>
 #include <Common/Hash.h>
@@ -32,6 +35,12 @@ namespace Mirror {
 
 namespace Mirror::Internal {
     MIRROR_API TypeId ComputeTypeId(std::string_view sigName);
+    // calling a thunk through another signature is undefined behaviour, so a mismatch terminates in every build config
+    MIRROR_API void CheckTypedAccess(bool matched);
+
+    // values up to this size are stored inside Any itself, larger or over aligned ones go to heap
+    static constexpr size_t anyInlineSize = 32;
+    static constexpr size_t anyInlineAlignment = alignof(std::max_align_t);
 
     struct AnyRtti {
         using DetorFunc = void(void*) noexcept;
@@ -55,6 +64,11 @@ namespace Mirror::Internal {
         CopyFunc* copy;
         MoveFunc* move;
         EqualFunc* equal;
+        size_t size;
+        size_t alignment;
+        bool inlined;
+        // trivially copyable values are copied and moved with memcpy and need no destruction
+        bool trivial;
     };
 
     template <class T>
@@ -62,8 +76,53 @@ namespace Mirror::Internal {
         &AnyRtti::DetorImpl<T>,
         &AnyRtti::CopyImpl<T>,
         &AnyRtti::MoveImpl<T>,
-        &AnyRtti::EqualImpl<T>
+        &AnyRtti::EqualImpl<T>,
+        sizeof(T),
+        alignof(T),
+        sizeof(T) <= anyInlineSize && alignof(T) <= anyInlineAlignment && std::is_nothrow_move_constructible_v<T>,
+        std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>
+    };
+
+    // type erased function pointer of a typed thunk, only cast back to the exact signature it was registered with
+    using TypedThunk = void(*)();
+
+    template <typename F>
+    struct SignatureTraits {};
+
+    template <typename Ret, typename... Args>
+    struct SignatureTraits<Ret(Args...)> {
+        using RetType = Ret;
+        using FunctionThunk = Ret(*)(Args...);
+        using MemberThunk = Ret(*)(void*, Args...);
+        using NewObjectThunk = Ret*(*)(Args...);
     };
+
+    template <typename F>
+    size_t GetSignatureId()
+    {
+        return typeid(F).hash_code();
+    }
+
+    // fully qualified class name taken from the signature of this function, e.g. "Runtime::Asset", class keys of msvc are stripped
+    // so the name is the same on every compiler, mirror tool checks it against the name it sees in generated code
+    template <typename T>
+    constexpr std::string_view GetQualifiedClassName()
+    {
+        const std::string_view signature = functionSignature;
+#if COMPILER_MSVC
+        const size_t begin = signature.find("GetQualifiedClassName<") + std::string_view("GetQualifiedClassName<").size();
+        std::string_view result = signature.substr(begin, signature.rfind(">(void)") - begin);
+        for (const std::string_view classKey : { "struct ", "class " }) {
+            if (result.starts_with(classKey)) {
+                result.remove_prefix(classKey.size());
+            }
+        }
+        return result;
+#else
+        const size_t begin = signature.find("T = ") + std::string_view("T = ").size();
+        return signature.substr(begin, signature.find_first_of(";]", begin) - begin);
+#endif
+    }
 }
 
 namespace Mirror {
@@ -103,7 +162,7 @@ namespace Mirror {
         Any(const Any& inAny);
         Any(Any&& inAny) noexcept;
 
-        template <typename T>
+        template <typename T> requires (!std::is_same_v<std::remove_cvref_t<T>, Any>)
         Any(T&& value); // NOLINT
 
         template <typename T>
@@ -115,7 +174,7 @@ namespace Mirror {
         Any& operator=(const Any& inAny);
         Any& operator=(Any&& inAny) noexcept;
 
-        template <typename T>
+        template <typename T> requires (!std::is_same_v<std::remove_cvref_t<T>, Any>)
         Any& operator=(T&& value);
 
         template <typename T>
@@ -144,15 +203,25 @@ namespace Mirror {
         bool operator==(const Any& rhs) const;
 
     private:
+        union Storage {
+            alignas(Internal::anyInlineAlignment) uint8_t inlineData[Internal::anyInlineSize];
+            void* heapData;
+        };
+
         template <typename T>
         void ConstructValue(T&& value);
 
         template <typename T>
         void ConstructRef(const std::reference_wrapper<T>& ref);
 
+        void* Allocate(const Internal::AnyRtti* inRtti);
+        void* DataPtr() const;
+        void CopyFrom(const Any& inAny);
+        void MoveFrom(Any& inAny) noexcept;
+
         const Mirror::TypeInfo* typeInfo = nullptr;
-        const Internal::AnyRtti* rtti;
-        std::vector<uint8_t> data;
+        const Internal::AnyRtti* rtti = nullptr;
+        Storage storage;
     };
 
     class MIRROR_API Type {
@@ -160,6 +229,8 @@ namespace Mirror {
         virtual ~Type();
 
         [[nodiscard]] const std::string& GetName() const;
+        // crc32 of name, identifies classes and member variables in serialized data
+        [[nodiscard]] uint32_t GetNameHash() const;
         [[nodiscard]] const std::string& GetMeta(const std::string& key) const;
         [[nodiscard]] std::string GetAllMeta() const;
         bool HasMeta(const std::string& key) const;
@@ -171,6 +242,7 @@ namespace Mirror {
         template <typename Derived> friend class MetaDataRegistry;
 
         std::string name;
+        uint32_t nameHash;
         std::unordered_map<std::string, std::string> metas;
     };
 
@@ -224,6 +296,10 @@ namespace Mirror {
         template <typename... Args>
         Any Invoke(Args&&... args) const;
 
+        // skips Any boxing, F must be exactly the registered signature, e.g. TypedInvoke<int(int, const std::string&)>(1, str)
+        template <typename F, typename... Args>
+        typename Internal::SignatureTraits<F>::RetType TypedInvoke(Args&&... args) const;
+
         uint8_t GetArgsNum() const;
         const TypeInfo* GetRetTypeInfo() const;
         const TypeInfo* GetArgTypeInfo(uint8_t argIndex) const;
@@ -234,7 +310,7 @@ namespace Mirror {
         friend class GlobalRegistry;
         template <typename C> friend class ClassRegistry;
 
-        using Invoker = std::function<Any(Any*, uint8_t)>;
+        using Invoker = Any(*)(Any*, uint8_t);
 
         struct ConstructParams {
             std::string name;
@@ -242,6 +318,8 @@ namespace Mirror {
             const TypeInfo* retTypeInfo;
             std::vector<const TypeInfo*> argTypeInfos;
             Invoker invoker;
+            size_t signatureId;
+            Internal::TypedThunk typedThunk;
         };
 
         explicit Function(ConstructParams&& params);
@@ -250,6 +328,8 @@ namespace Mirror {
         const TypeInfo* retTypeInfo;
         std::vector<const TypeInfo*> argTypeInfos;
         Invoker invoker;
+        size_t signatureId;
+        Internal::TypedThunk typedThunk;
     };
 
     class MIRROR_API Constructor : public Type {
@@ -264,6 +344,14 @@ namespace Mirror {
         template <typename... Args>
         Any NewObject(Args&&... args) const;
 
+        // skips Any boxing, F must be the class type called with exactly the registered args, e.g. TypedConstructOnStack<Foo(int)>(1)
+        template <typename F, typename... Args>
+        typename Internal::SignatureTraits<F>::RetType TypedConstructOnStack(Args&&... args) const;
+
+        // same as TypedConstructOnStack(), but returns a pointer to a new object
+        template <typename F, typename... Args>
+        std::add_pointer_t<typename Internal::SignatureTraits<F>::RetType> TypedNewObject(Args&&... args) const;
+
         uint8_t GetArgsNum() const;
         const TypeInfo* GetArgTypeInfo(uint8_t argIndex) const;
         const std::vector<const TypeInfo*>& GetArgTypeInfos() const;
@@ -274,7 +362,7 @@ namespace Mirror {
         friend class Registry;
         template <typename C> friend class ClassRegistry;
 
-        using Invoker = std::function<Any(Any*, uint8_t)>;
+        using Invoker = Any(*)(Any*, uint8_t);
 
         struct ConstructParams {
             std::string name;
@@ -282,6 +370,9 @@ namespace Mirror {
             std::vector<const TypeInfo*> argTypeInfos;
             Invoker stackConstructor;
             Invoker heapConstructor;
+            size_t signatureId;
+            Internal::TypedThunk typedStackConstructor;
+            Internal::TypedThunk typedHeapConstructor;
         };
 
         explicit Constructor(ConstructParams&& params);
@@ -290,6 +381,9 @@ namespace Mirror {
         std::vector<const TypeInfo*> argTypeInfos;
         Invoker stackConstructor;
         Invoker heapConstructor;
+        size_t signatureId;
+        Internal::TypedThunk typedStackConstructor;
+        Internal::TypedThunk typedHeapConstructor;
     };
 
     class MIRROR_API Destructor : public Type {
@@ -305,7 +399,7 @@ namespace Mirror {
         friend class Registry;
         template <typename C> friend class ClassRegistry;
 
-        using Invoker = std::function<void(Any*)>;
+        using Invoker = void(*)(Any*);
 
         struct ConstructParams {
             Invoker destructor;
@@ -323,20 +417,25 @@ namespace Mirror {
         template <typename C, typename T>
         void Set(C&& object, T value) const;
 
+        // skips Any boxing, C must be exactly the owner class and T exactly the member type
+        template <typename T, typename C>
+        std::conditional_t<std::is_const_v<C>, const T&, T&> TypedGet(C& object) const;
+
         uint32_t SizeOf() const;
         const TypeInfo* GetTypeInfo() const;
         void Set(Any* object, Any* value) const;
         Any Get(Any* object) const;
         void Serialize(Common::SerializeStream& stream, Any* object) const;
-        void Deserialize(Common::DeserializeStream& stream, Any* object) const;
+        // false if the stream does not hold a value of this member's type, the member is left unchanged then
+        bool Deserialize(Common::DeserializeStream& stream, Any* object) const;
 
     private:
         template <typename C> friend class ClassRegistry;
 
-        using Setter = std::function<void(Any*, Any*)>;
-        using Getter = std::function<Any(Any*)>;
+        using Setter = void(*)(Any*, Any*);
+        using Getter = Any(*)(Any*);
         using MemberVariableSerializer = std::function<void(Common::SerializeStream&, const MemberVariable&, Any*)>;
-        using MemberVariableDeserializer = std::function<void(Common::DeserializeStream&, const MemberVariable&, Any*)>;
+        using MemberVariableDeserializer = std::function<bool(Common::DeserializeStream&, const MemberVariable&, Any*)>;
 
         struct ConstructParams {
             std::string name;
@@ -346,6 +445,8 @@ namespace Mirror {
             Getter getter;
             MemberVariableSerializer serializer;
             MemberVariableDeserializer deserializer;
+            const TypeInfo* classTypeInfo;
+            Internal::TypedThunk typedGetter;
         };
 
         explicit MemberVariable(ConstructParams&& params);
@@ -356,6 +457,8 @@ namespace Mirror {
         Getter getter;
         MemberVariableSerializer serializer;
         MemberVariableDeserializer deserializer;
+        const TypeInfo* classTypeInfo;
+        Internal::TypedThunk typedGetter;
     };
 
     class MIRROR_API MemberFunction : public Type {
@@ -366,6 +469,10 @@ namespace Mirror {
         template <typename C, typename... Args>
         Any Invoke(C&& object, Args&&... args) const;
 
+        // skips Any boxing, C must be exactly the owner class and F exactly the registered signature without the object
+        template <typename F, typename C, typename... Args>
+        typename Internal::SignatureTraits<F>::RetType TypedInvoke(C& object, Args&&... args) const;
+
         uint8_t GetArgsNum() const;
         const TypeInfo* GetRetTypeInfo() const;
         const TypeInfo* GetArgTypeInfo(uint8_t argIndex) const;
@@ -375,7 +482,7 @@ namespace Mirror {
     private:
         template <typename C> friend class ClassRegistry;
 
-        using Invoker = std::function<Any(Any*, Any*, size_t)>;
+        using Invoker = Any(*)(Any*, Any*, size_t);
 
         struct ConstructParams {
             std::string name;
@@ -383,6 +490,9 @@ namespace Mirror {
             const TypeInfo* retTypeInfo;
             std::vector<const TypeInfo*> argTypeInfos;
             Invoker invoker;
+            const TypeInfo* classTypeInfo;
+            size_t signatureId;
+            Internal::TypedThunk typedThunk;
         };
 
         explicit MemberFunction(ConstructParams&& params);
@@ -391,6 +501,9 @@ namespace Mirror {
         const TypeInfo* retTypeInfo;
         std::vector<const TypeInfo*> argTypeInfos;
         Invoker invoker;
+        const TypeInfo* classTypeInfo;
+        size_t signatureId;
+        Internal::TypedThunk typedThunk;
     };
 
     class MIRROR_API GlobalScope : public Type {
@@ -524,6 +637,10 @@ namespace Mirror {
 
         explicit Class(ConstructParams&& params);
 
+        const MemberVariable* FindMemberVariable(uint32_t nameHash) const;
+        void DeserializeChunked(Common::DeserializeStream& stream, Mirror::Any* obj) const;
+        void DeserializeLegacy(Common::DeserializeStream& stream, Mirror::Any* obj, bool nameTypeIdRead) const;
+
         const TypeInfo* typeInfo;
         BaseClassGetter baseClassGetter;
         std::optional<Mirror::Any> defaultObject;
@@ -532,6 +649,7 @@ namespace Mirror {
         std::unordered_map<std::string, Variable> staticVariables;
         std::unordered_map<std::string, Function> staticFunctions;
         std::unordered_map<std::string, MemberVariable> memberVariables;
+        std::unordered_map<uint32_t, const MemberVariable*> memberVariableHashes;
         std::unordered_map<std::string, MemberFunction> memberFunctions;
     };
 
@@ -610,7 +728,7 @@ namespace Mirror::Internal {
     template <typename T>
     void AnyRtti::MoveImpl(void* const object, void* const other) noexcept
     {
-        new(object) T(std::move(*reinterpret_cast<const T*>(other)));
+        new(object) T(std::move(*reinterpret_cast<T*>(other)));
     }
 
     template <typename T>
@@ -645,7 +763,7 @@ namespace Mirror {
         return &typeInfo;
     }
 
-    template <typename T>
+    template <typename T> requires (!std::is_same_v<std::remove_cvref_t<T>, Any>)
     Any::Any(T&& value)
     {
         ConstructValue(std::forward<T>(value));
@@ -663,7 +781,7 @@ namespace Mirror {
         ConstructRef(std::move(ref));
     }
 
-    template <typename T>
+    template <typename T> requires (!std::is_same_v<std::remove_cvref_t<T>, Any>)
     Any& Any::operator=(T&& value)
     {
         Reset();
@@ -704,10 +822,9 @@ namespace Mirror {
     T Any::ForceAs() const
     {
         if (typeInfo->isLValueReference) {
-            return reinterpret_cast<std::add_const_t<std::reference_wrapper<std::remove_reference_t<T>>>*>(data.data())->get();
+            return reinterpret_cast<std::add_const_t<std::reference_wrapper<std::remove_reference_t<T>>>*>(DataPtr())->get();
         } else {
-            void* dataPtr = const_cast<uint8_t*>(data.data());
-            return *reinterpret_cast<std::remove_reference_t<T>*>(dataPtr);
+            return *reinterpret_cast<std::remove_reference_t<T>*>(DataPtr());
         }
     }
 
@@ -716,8 +833,7 @@ namespace Mirror {
     {
         Assert(!typeInfo->isLValueReference);
         if (Convertible<T>()) {
-            void* dataPtr = const_cast<uint8_t*>(data.data());
-            return reinterpret_cast<std::remove_reference_t<T>*>(dataPtr);
+            return reinterpret_cast<std::remove_reference_t<T>*>(DataPtr());
         } else {
             return nullptr;
         }
@@ -731,9 +847,7 @@ namespace Mirror {
 
         typeInfo = GetTypeInfo<RemoveRefType>();
         rtti = &Internal::anyRttiImpl<RemoveCVRefType>;
-
-        data.resize(sizeof(RemoveCVRefType));
-        new(data.data()) RemoveCVRefType(std::forward<T>(value));
+        new(Allocate(rtti)) RemoveCVRefType(std::forward<T>(value));
     }
 
     template <typename T>
@@ -744,9 +858,7 @@ namespace Mirror {
 
         typeInfo = GetTypeInfo<RefType>();
         rtti = &Internal::anyRttiImpl<RefWrapperType>;
-
-        data.resize(sizeof(RefWrapperType));
-        new(data.data()) RefWrapperType(ref);
+        new(Allocate(rtti)) RefWrapperType(ref);
     }
 
     template <typename T>
@@ -763,6 +875,14 @@ namespace Mirror {
         return InvokeWith(refs.data(), refs.size());
     }
 
+    template <typename F, typename... Args>
+    typename Internal::SignatureTraits<F>::RetType Function::TypedInvoke(Args&&... args) const
+    {
+        Internal::CheckTypedAccess(signatureId == Internal::GetSignatureId<F>());
+        auto thunk = reinterpret_cast<typename Internal::SignatureTraits<F>::FunctionThunk>(typedThunk);
+        return thunk(std::forward<Args>(args)...);
+    }
+
     template <typename... Args>
     Any Constructor::ConstructOnStack(Args&&... args) const
     {
@@ -777,6 +897,22 @@ namespace Mirror {
         return NewObjectWith(refs.data(), refs.size());
     }
 
+    template <typename F, typename... Args>
+    typename Internal::SignatureTraits<F>::RetType Constructor::TypedConstructOnStack(Args&&... args) const
+    {
+        Internal::CheckTypedAccess(signatureId == Internal::GetSignatureId<F>());
+        auto thunk = reinterpret_cast<typename Internal::SignatureTraits<F>::FunctionThunk>(typedStackConstructor);
+        return thunk(std::forward<Args>(args)...);
+    }
+
+    template <typename F, typename... Args>
+    std::add_pointer_t<typename Internal::SignatureTraits<F>::RetType> Constructor::TypedNewObject(Args&&... args) const
+    {
+        Internal::CheckTypedAccess(signatureId == Internal::GetSignatureId<F>());
+        auto thunk = reinterpret_cast<typename Internal::SignatureTraits<F>::NewObjectThunk>(typedHeapConstructor);
+        return thunk(std::forward<Args>(args)...);
+    }
+
     template <typename C>
     void Destructor::Invoke(C&& object) const
     {
@@ -800,6 +936,22 @@ namespace Mirror {
         return InvokeWith(&classRef, argRefs.data(), argRefs.size());
     }
 
+    template <typename F, typename C, typename... Args>
+    typename Internal::SignatureTraits<F>::RetType MemberFunction::TypedInvoke(C& object, Args&&... args) const
+    {
+        Internal::CheckTypedAccess(classTypeInfo->id == Mirror::GetTypeInfo<std::remove_const_t<C>>()->id && signatureId == Internal::GetSignatureId<F>());
+        auto thunk = reinterpret_cast<typename Internal::SignatureTraits<F>::MemberThunk>(typedThunk);
+        return thunk(const_cast<std::remove_const_t<C>*>(&object), std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename C>
+    std::conditional_t<std::is_const_v<C>, const T&, T&> MemberVariable::TypedGet(C& object) const
+    {
+        Internal::CheckTypedAccess(classTypeInfo->id == Mirror::GetTypeInfo<std::remove_const_t<C>>()->id && typeInfo->id == Mirror::GetTypeInfo<T>()->id);
+        auto thunk = reinterpret_cast<void*(*)(void*)>(typedGetter);
+        return *static_cast<T*>(thunk(const_cast<std::remove_const_t<C>*>(&object)));
+    }
+
     template <typename F>
     void GlobalScope::ForEachVariable(F&& func) const
     {
@@ -887,3 +1039,74 @@ namespace Mirror {
         return Get(iter->second);
     }
 }
+
+namespace Mirror {
+    // classes with EClassBody, mirror tool generates their serializers which write member variables directly instead of going through Class
+    template <typename T>
+    concept GeneratedSerializable = requires {
+        requires std::is_same_v<decltype(&T::_mirrorSerialize), void(*)(Common::SerializeStream&, const T&)>;
+        requires std::is_same_v<decltype(&T::_mirrorDeserialize), bool(*)(Common::DeserializeStream&, T&)>;
+    };
+}
+
+namespace Mirror::Internal {
+    // used by generated serializers, layout hash covers class name, base class and member names and types
+    inline void SerializeGeneratedLayout(Common::SerializeStream& stream, uint32_t layoutHash)
+    {
+        stream.Write(&layoutHash, sizeof(uint32_t));
+    }
+
+    inline bool DeserializeGeneratedLayout(Common::DeserializeStream& stream, uint32_t layoutHash)
+    {
+        uint32_t hash;
+        stream.Read(&hash, sizeof(uint32_t));
+        return hash == layoutHash;
+    }
+
+    // same as Class::Serialize, members without serializer fail only when they are really serialized
+    template <typename T>
+    void SerializeGeneratedMember(Common::SerializeStream& stream, const T& value)
+    {
+        if constexpr (Common::Serializer<T>::serializable) {
+            Common::Serializer<T>::Serialize(stream, value);
+        } else {
+            Unimplement();
+        }
+    }
+
+    template <typename T>
+    bool DeserializeGeneratedMember(Common::DeserializeStream& stream, T& value)
+    {
+        if constexpr (Common::Serializer<T>::serializable) {
+            return Common::Serializer<T>::Deserialize(stream, value);
+        } else {
+            Unimplement();
+            return false;
+        }
+    }
+}
+
+namespace Common {
+    // fixed layout without schema, data written by an older layout fails to deserialize, use Class::Serialize when schema evolution is needed
+    template <typename T>
+    requires Mirror::GeneratedSerializable<T>
+    struct Serializer<T> {
+        static constexpr bool serializable = true;
+        // computed from the fully qualified name, classes with the same name in different namespaces must not accept each other's data
+        static constexpr uint32_t typeId = Common::HashUtils::RuntimeStrCrc32(Mirror::Internal::GetQualifiedClassName<T>());
+
+        static void Serialize(SerializeStream& stream, const T& value)
+        {
+            TypeIdSerializer<T>::Serialize(stream);
+            T::_mirrorSerialize(stream, value);
+        }
+
+        static bool Deserialize(DeserializeStream& stream, T& value)
+        {
+            if (!TypeIdSerializer<T>::Deserialize(stream)) {
+                return false;
+            }
+            return T::_mirrorDeserialize(stream, value);
+        }
+    };
+}
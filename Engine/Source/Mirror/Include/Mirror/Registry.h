@@ -40,6 +40,9 @@ namespace Mirror::Internal {
 
     template <typename Class, typename ArgsTuple, size_t... I>
     auto InvokeConstructorNew(ArgsTuple& args, std::index_sequence<I...>);
+
+    template <typename Class, auto Ptr, typename Ret, typename ArgsTuple>
+    struct MemberFunctionThunk {};
 }
 
 namespace Mirror {
@@ -223,6 +226,32 @@ namespace Mirror::Internal {
     {
         return new Class(std::get<I>(args)...);
     }
+
+    template <typename Class, auto Ptr, typename Ret, typename... Args>
+    struct MemberFunctionThunk<Class, Ptr, Ret, std::tuple<Args...>> {
+        using Signature = Ret(Args...);
+
+        static Ret Invoke(void* object, Args... args)
+        {
+            return (static_cast<Class*>(object)->*Ptr)(std::forward<Args>(args)...);
+        }
+    };
+
+    template <typename Class, typename... Args>
+    TypedThunk GetTypedStackConstructor()
+    {
+        return reinterpret_cast<TypedThunk>(static_cast<Class(*)(Args...)>([](Args... args) -> Class {
+            return Class(std::forward<Args>(args)...);
+        }));
+    }
+
+    template <typename Class, typename... Args>
+    TypedThunk GetTypedHeapConstructor()
+    {
+        return reinterpret_cast<TypedThunk>(static_cast<Class*(*)(Args...)>([](Args... args) -> Class* {
+            return new Class(std::forward<Args>(args)...);
+        }));
+    }
 }
 
 namespace Mirror {
@@ -279,11 +308,14 @@ namespace Mirror {
             auto argsTuple = Internal::CastAnyArrayToArgsTuple<ArgsTupleType>(args, std::make_index_sequence<argsTupleSize> {});
             return Any(Internal::InvokeConstructorStack<C, ArgsTupleType>(argsTuple, std::make_index_sequence<argsTupleSize> {}));
         };
-        params.heapConstructor = [](Any* args, size_t argSize) -> Any {
+        params.heapConstructor = [](Any* args, uint8_t argSize) -> Any {
             Assert(argsTupleSize == argSize);
             auto argsTuple = Internal::CastAnyArrayToArgsTuple<ArgsTupleType>(args, std::make_index_sequence<argsTupleSize> {});
             return Any(Internal::InvokeConstructorNew<C, ArgsTupleType>(argsTuple, std::make_index_sequence<argsTupleSize> {}));
         };
+        params.signatureId = Internal::GetSignatureId<C(Args...)>();
+        params.typedStackConstructor = Internal::GetTypedStackConstructor<C, Args...>();
+        params.typedHeapConstructor = Internal::GetTypedHeapConstructor<C, Args...>();
 
         clazz.constructors.emplace(std::make_pair(inName, Mirror::Constructor(std::move(params))));
         return MetaDataRegistry<ClassRegistry<C>>::SetContext(&clazz.constructors.at(inName));
@@ -332,7 +364,7 @@ namespace Mirror {
         params.retTypeInfo = GetTypeInfo<RetType>();
         params.argsNum = argsTupleSize;
         params.argTypeInfos = Internal::GetArgTypeInfosByArgsTuple<ArgsTupleType>(std::make_index_sequence<argsTupleSize> {});
-        params.invoker = [](Any* args, size_t argSize) -> Any {
+        params.invoker = [](Any* args, uint8_t argSize) -> Any {
             Assert(argsTupleSize == argSize);
 
             auto argsTuple = Internal::CastAnyArrayToArgsTuple<ArgsTupleType>(args, std::make_index_sequence<argsTupleSize> {});
@@ -343,6 +375,9 @@ namespace Mirror {
                 return Any(Internal::InvokeFunction<Ptr, ArgsTupleType>(argsTuple, std::make_index_sequence<argsTupleSize> {}));
             }
         };
+        // a static function pointer already is the typed thunk
+        params.signatureId = Internal::GetSignatureId<std::remove_pointer_t<decltype(Ptr)>>();
+        params.typedThunk = reinterpret_cast<Internal::TypedThunk>(Ptr);
 
         clazz.staticFunctions.emplace(std::make_pair(inName, Function(std::move(params))));
         return MetaDataRegistry<ClassRegistry<C>>::SetContext(&clazz.staticFunctions.at(inName));
@@ -368,6 +403,10 @@ namespace Mirror {
         params.getter = [](Any* object) -> Any {
             return std::ref(object->As<ClassType&>().*Ptr);
         };
+        params.classTypeInfo = GetTypeInfo<std::remove_const_t<ClassType>>();
+        params.typedGetter = reinterpret_cast<Internal::TypedThunk>(static_cast<void*(*)(void*)>([](void* object) -> void* {
+            return const_cast<void*>(static_cast<const void*>(&(static_cast<ClassType*>(object)->*Ptr)));
+        }));
         params.serializer = [](Common::SerializeStream& stream, const Mirror::MemberVariable& variable, Any* object) -> void {
             if constexpr (Common::Serializer<ValueType>::serializable) {
                 ValueType& value = variable.Get(object).As<ValueType&>();
@@ -376,19 +415,25 @@ namespace Mirror {
                 Unimplement();
             }
         };
-        params.deserializer = [](Common::DeserializeStream& stream, const Mirror::MemberVariable& variable, Any* object) -> void {
+        params.deserializer = [](Common::DeserializeStream& stream, const Mirror::MemberVariable& variable, Any* object) -> bool {
             if constexpr (Common::Serializer<ValueType>::serializable) {
                 ValueType value;
-                Common::Serializer<ValueType>::Deserialize(stream, value);
+                if (!Common::Serializer<ValueType>::Deserialize(stream, value)) {
+                    return false;
+                }
                 Any valueRef = std::ref(value);
                 variable.Set(object, &valueRef);
+                return true;
             } else {
                 Unimplement();
+                return false;
             }
         };
 
-        clazz.memberVariables.emplace(std::make_pair(inName, Mirror::MemberVariable(std::move(params))));
-        return MetaDataRegistry<ClassRegistry<C>>::SetContext(&clazz.memberVariables.at(inName));
+        auto& memberVariable = clazz.memberVariables.emplace(std::make_pair(inName, Mirror::MemberVariable(std::move(params)))).first->second;
+        const bool hashInserted = clazz.memberVariableHashes.emplace(memberVariable.GetNameHash(), &memberVariable).second;
+        AssertWithReason(hashInserted, "name hash of member variable collides with another one of the class");
+        return MetaDataRegistry<ClassRegistry<C>>::SetContext(&memberVariable);
     }
 
     template <typename C>
@@ -420,6 +465,9 @@ namespace Mirror {
                 return Any(Internal::InvokeMemberFunction<ClassType, Ptr, ArgsTupleType>(object->As<ClassType&>(), argsTuple, std::make_index_sequence<argsTupleSize> {}));
             }
         };
+        params.classTypeInfo = GetTypeInfo<std::remove_const_t<ClassType>>();
+        params.signatureId = Internal::GetSignatureId<typename Internal::MemberFunctionThunk<ClassType, Ptr, RetType, ArgsTupleType>::Signature>();
+        params.typedThunk = reinterpret_cast<Internal::TypedThunk>(&Internal::MemberFunctionThunk<ClassType, Ptr, RetType, ArgsTupleType>::Invoke);
 
         clazz.memberFunctions.emplace(std::make_pair(inName, Mirror::MemberFunction(std::move(params))));
         return MetaDataRegistry<ClassRegistry<C>>::SetContext(&clazz.memberFunctions.at(inName));
@@ -481,7 +529,7 @@ namespace Mirror {
         params.retTypeInfo = GetTypeInfo<RetType>();
         params.argsNum = argsTupleSize;
         params.argTypeInfos = Internal::GetArgTypeInfosByArgsTuple<ArgsTupleType>(std::make_index_sequence<argsTupleSize> {});
-        params.invoker = [](Any* args, size_t argSize) -> Any {
+        params.invoker = [](Any* args, uint8_t argSize) -> Any {
             Assert(argsTupleSize == argSize);
 
             auto argsTuple = Internal::CastAnyArrayToArgsTuple<ArgsTupleType>(args, std::make_index_sequence<argsTupleSize> {});
@@ -492,6 +540,9 @@ namespace Mirror {
                 return Any(Internal::InvokeFunction<Ptr, ArgsTupleType>(argsTuple, std::make_index_sequence<argsTupleSize> {}));
             }
         };
+        // a static function pointer already is the typed thunk
+        params.signatureId = Internal::GetSignatureId<std::remove_pointer_t<decltype(Ptr)>>();
+        params.typedThunk = reinterpret_cast<Internal::TypedThunk>(Ptr);
 
         globalScope.functions.emplace(std::make_pair(inName, Mirror::Function(std::move(params))));
         return MetaDataRegistry<GlobalRegistry>::SetContext(&globalScope.functions.at(inName));
@@ -558,14 +609,17 @@ namespace Mirror {
             ctorParams.name = NamePresets::defaultConstructor;
             ctorParams.argsNum = 0;
             ctorParams.argTypeInfos = {};
-            ctorParams.stackConstructor = [](Any* args, size_t argSize) -> Any {
+            ctorParams.stackConstructor = [](Any* args, uint8_t argSize) -> Any {
                 Assert(argSize == 0);
                 return Any(C());
             };
-            ctorParams.heapConstructor = [](Any* args, size_t argSize) -> Any {
+            ctorParams.heapConstructor = [](Any* args, uint8_t argSize) -> Any {
                 Assert(argSize == 0);
                 return Any(new C());
             };
+            ctorParams.signatureId = Internal::GetSignatureId<C()>();
+            ctorParams.typedStackConstructor = Internal::GetTypedStackConstructor<C>();
+            ctorParams.typedHeapConstructor = Internal::GetTypedHeapConstructor<C>();
             params.defaultConstructor = Constructor(std::move(ctorParams));
         }
 
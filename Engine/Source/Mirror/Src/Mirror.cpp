@@ -4,6 +4,9 @@
 
 #include <utility>
 #include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <cstdlib>
 
 #include <Mirror/Mirror.h>
 #include <Mirror/Registry.h>
@@ -11,34 +14,38 @@
 #include <Common/String.h>
 
 namespace Mirror::Internal {
+    // "MCHK", first word of chunked class layout
+    static constexpr uint32_t chunkedClassMagic = 0x4b48434d;
+
     TypeId ComputeTypeId(std::string_view sigName)
     {
         return Common::HashUtils::CityHash(sigName.data(), sigName.size());
     }
+
+    void CheckTypedAccess(bool matched)
+    {
+        if (matched) {
+            return;
+        }
+        AssertWithReason(false, "typed access does not match the registered signature");
+        std::abort();
+    }
 }
 
 namespace Mirror {
     Any::~Any()
     {
-        if (rtti != nullptr) {
-            rtti->detor(data.data());
-        }
+        Reset();
     }
 
     Any::Any(const Any& inAny)
     {
-        typeInfo = inAny.typeInfo;
-        rtti = inAny.rtti;
-        data.resize(inAny.data.size());
-        rtti->copy(data.data(), inAny.data.data());
+        CopyFrom(inAny);
     }
 
     Any::Any(Any&& inAny) noexcept
     {
-        typeInfo = inAny.typeInfo;
-        rtti = inAny.rtti;
-        data.resize(inAny.data.size());
-        rtti->move(data.data(), inAny.data.data());
+        MoveFrom(inAny);
     }
 
     Any& Any::operator=(const Any& inAny)
@@ -47,18 +54,17 @@ namespace Mirror {
             return *this;
         }
         Reset();
-        typeInfo = inAny.typeInfo;
-        rtti = inAny.rtti;
-        rtti->copy(data.data(), inAny.data.data());
+        CopyFrom(inAny);
         return *this;
     }
 
     Any& Any::operator=(Mirror::Any&& inAny) noexcept
     {
+        if (&inAny == this) {
+            return *this;
+        }
         Reset();
-        typeInfo = inAny.typeInfo;
-        rtti = inAny.rtti;
-        rtti->move(data.data(), inAny.data.data());
+        MoveFrom(inAny);
         return *this;
     }
 
@@ -82,12 +88,12 @@ namespace Mirror {
 
     size_t Any::Size() const
     {
-        return data.size();
+        return rtti == nullptr ? 0 : rtti->size;
     }
 
     const void* Any::Data() const
     {
-        return data.data();
+        return DataPtr();
     }
 
     const Mirror::TypeInfo* Any::TypeInfo() const
@@ -97,8 +103,16 @@ namespace Mirror {
 
     void Any::Reset()
     {
-        if (rtti != nullptr) {
-            rtti->detor(data.data());
+        if (rtti == nullptr) {
+            return;
+        }
+        if (!rtti->trivial) {
+            rtti->detor(DataPtr());
+        }
+        if (!rtti->inlined && rtti->alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(storage.heapData, std::align_val_t(rtti->alignment));
+        } else if (!rtti->inlined) {
+            ::operator delete(storage.heapData);
         }
         typeInfo = nullptr;
         rtti = nullptr;
@@ -107,10 +121,67 @@ namespace Mirror {
     bool Any::operator==(const Any& rhs) const
     {
         return typeInfo == rhs.typeInfo
-            && rtti->equal(data.data(), rhs.Data());
+            && rtti->equal(DataPtr(), rhs.Data());
+    }
+
+    void* Any::Allocate(const Internal::AnyRtti* inRtti)
+    {
+        if (inRtti->inlined) {
+            return storage.inlineData;
+        }
+        storage.heapData = inRtti->alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__
+            ? ::operator new(inRtti->size, std::align_val_t(inRtti->alignment))
+            : ::operator new(inRtti->size);
+        return storage.heapData;
+    }
+
+    void* Any::DataPtr() const
+    {
+        if (rtti == nullptr) {
+            return nullptr;
+        }
+        return rtti->inlined ? const_cast<uint8_t*>(storage.inlineData) : storage.heapData;
+    }
+
+    void Any::CopyFrom(const Any& inAny)
+    {
+        if (inAny.rtti == nullptr) {
+            return;
+        }
+        void* dst = Allocate(inAny.rtti);
+        if (inAny.rtti->trivial) {
+            memcpy(dst, inAny.DataPtr(), inAny.rtti->size);
+        } else {
+            inAny.rtti->copy(dst, inAny.DataPtr());
+        }
+        typeInfo = inAny.typeInfo;
+        rtti = inAny.rtti;
+    }
+
+    void Any::MoveFrom(Any& inAny) noexcept
+    {
+        if (inAny.rtti == nullptr) {
+            return;
+        }
+        typeInfo = inAny.typeInfo;
+        rtti = inAny.rtti;
+        if (!rtti->inlined) {
+            // heap values change owner without touching the value, moved from any becomes empty
+            storage.heapData = inAny.storage.heapData;
+            inAny.typeInfo = nullptr;
+            inAny.rtti = nullptr;
+        } else if (rtti->trivial) {
+            memcpy(storage.inlineData, inAny.storage.inlineData, rtti->size);
+        } else {
+            rtti->move(storage.inlineData, inAny.storage.inlineData);
+        }
     }
 
-    Type::Type(std::string inName) : name(std::move(inName)) {}
+    Type::Type(std::string inName)
+        : name(std::move(inName))
+        , nameHash(Common::HashUtils::RuntimeStrCrc32(name))
+    {
+    }
 
     Type::~Type() = default;
 
@@ -119,6 +190,11 @@ namespace Mirror {
         return name;
     }
 
+    uint32_t Type::GetNameHash() const
+    {
+        return nameHash;
+    }
+
     const std::string& Type::GetMeta(const std::string& key) const
     {
         auto iter = metas.find(key);
@@ -189,7 +265,9 @@ namespace Mirror {
         , argsNum(params.argsNum)
         , retTypeInfo(params.retTypeInfo)
         , argTypeInfos(std::move(params.argTypeInfos))
-        , invoker(std::move(params.invoker))
+        , invoker(params.invoker)
+        , signatureId(params.signatureId)
+        , typedThunk(params.typedThunk)
     {
     }
 
@@ -224,8 +302,11 @@ namespace Mirror {
         : Type(std::move(params.name))
         , argsNum(params.argsNum)
         , argTypeInfos(std::move(params.argTypeInfos))
-        , stackConstructor(std::move(params.stackConstructor))
-        , heapConstructor(std::move(params.heapConstructor))
+        , stackConstructor(params.stackConstructor)
+        , heapConstructor(params.heapConstructor)
+        , signatureId(params.signatureId)
+        , typedStackConstructor(params.typedStackConstructor)
+        , typedHeapConstructor(params.typedHeapConstructor)
     {
     }
 
@@ -258,7 +339,7 @@ namespace Mirror {
 
     Destructor::Destructor(ConstructParams&& params)
         : Type(std::string(NamePresets::destructor))
-        , destructor(std::move(params.destructor))
+        , destructor(params.destructor)
     {
     }
 
@@ -273,10 +354,12 @@ namespace Mirror {
         : Type(std::move(params.name))
         , memorySize(params.memorySize)
         , typeInfo(params.typeInfo)
-        , setter(std::move(params.setter))
-        , getter(std::move(params.getter))
+        , setter(params.setter)
+        , getter(params.getter)
         , serializer(std::move(params.serializer))
         , deserializer(std::move(params.deserializer))
+        , classTypeInfo(params.classTypeInfo)
+        , typedGetter(params.typedGetter)
     {
     }
 
@@ -307,9 +390,9 @@ namespace Mirror {
         serializer(stream, *this, object);
     }
 
-    void MemberVariable::Deserialize(Common::DeserializeStream& stream, Any* object) const
+    bool MemberVariable::Deserialize(Common::DeserializeStream& stream, Any* object) const
     {
-        deserializer(stream, *this, object);
+        return deserializer(stream, *this, object);
     }
 
     MemberFunction::MemberFunction(ConstructParams&& params)
@@ -317,7 +400,10 @@ namespace Mirror {
         , argsNum(params.argsNum)
         , retTypeInfo(params.retTypeInfo)
         , argTypeInfos(std::move(params.argTypeInfos))
-        , invoker(std::move(params.invoker))
+        , invoker(params.invoker)
+        , classTypeInfo(params.classTypeInfo)
+        , signatureId(params.signatureId)
+        , typedThunk(params.typedThunk)
     {
     }
 
@@ -638,46 +724,126 @@ namespace Mirror {
         return iter->second;
     }
 
+    const MemberVariable* Class::FindMemberVariable(uint32_t nameHash) const
+    {
+        auto iter = memberVariableHashes.find(nameHash);
+        return iter == memberVariableHashes.end() ? nullptr : iter->second;
+    }
+
     void Class::Serialize(Common::SerializeStream& stream, Mirror::Any* obj) const
     {
-        const auto* baseClass = GetBaseClass();
-        if (baseClass != nullptr) {
-            baseClass->Serialize(stream, obj);
+        Assert(defaultObject.has_value());
+
+        std::vector<const Class*> classes;
+        for (const auto* clazz = this; clazz != nullptr; clazz = clazz->GetBaseClass()) {
+            classes.emplace_back(clazz);
         }
+        std::reverse(classes.begin(), classes.end());
+
+        // schema table goes first in one block, member payloads then follow in schema order
+        std::vector<uint32_t> schema = { Internal::chunkedClassMagic, static_cast<uint32_t>(classes.size()) };
+        for (const auto* clazz : classes) {
+            schema.emplace_back(clazz->GetNameHash());
+            schema.emplace_back(static_cast<uint32_t>(clazz->memberVariables.size()));
+            for (const auto& memberVariable : clazz->memberVariables) {
+                schema.emplace_back(memberVariable.second.GetNameHash());
+                schema.emplace_back(memberVariable.second.SizeOf());
+            }
+        }
+        stream.Write(schema.data(), schema.size() * sizeof(uint32_t));
+
+        // every payload is prefixed by its size, so readers can skip members they do not know, zero size means default value
+        std::vector<uint8_t> payload;
+        for (const auto* clazz : classes) {
+            for (const auto& memberVariable : clazz->memberVariables) {
+                payload.clear();
+                const bool sameWithDefaultObject = clazz->defaultObject.has_value() && memberVariable.second.Get(obj) == clazz->defaultObject.value();
+                if (!sameWithDefaultObject) {
+                    Common::ByteSerializeStream payloadStream(payload);
+                    memberVariable.second.Serialize(payloadStream, obj);
+                }
 
+                const auto payloadSize = static_cast<uint32_t>(payload.size());
+                stream.Write(&payloadSize, sizeof(uint32_t));
+                stream.Write(payload.data(), payload.size());
+            }
+        }
+    }
+
+    void Class::Deserailize(Common::DeserializeStream& stream, Mirror::Any* obj) const
+    {
         Assert(defaultObject.has_value());
 
-        std::string name = GetName();
-        uint64_t memberVariablesNum = memberVariables.size();
-        Common::Serializer<std::string>::Serialize(stream, name);
-        Common::Serializer<uint64_t>::Serialize(stream, memberVariablesNum);
+        uint32_t header;
+        stream.Read(&header, sizeof(uint32_t));
+        if (header == Internal::chunkedClassMagic) {
+            DeserializeChunked(stream, obj);
+        } else {
+            // files written before chunked layout start with the type id of the first class name
+            AssertWithReason(header == Common::Serializer<std::string>::typeId, "unknown class serialization layout");
+            DeserializeLegacy(stream, obj, true);
+        }
+    }
 
-        for (const auto& memberVariable : memberVariables) {
-            Common::Serializer<std::string>::Serialize(stream, memberVariable.first);
+    void Class::DeserializeChunked(Common::DeserializeStream& stream, Mirror::Any* obj) const
+    {
+        uint32_t classNum;
+        stream.Read(&classNum, sizeof(uint32_t));
 
-            const bool sameWithDefaultObject = memberVariable.second.Get(obj) == defaultObject.value();
-            Common::Serializer<bool>::Serialize(stream, sameWithDefaultObject);
+        // schema is resolved to member variables once, unknown classes, unknown members and members with changed size map to nullptr
+        std::vector<const MemberVariable*> slots;
+        std::vector<uint32_t> memberSchema;
+        for (uint32_t i = 0; i < classNum; i++) {
+            uint32_t classHeader[2];
+            stream.Read(classHeader, sizeof(classHeader));
 
-            if (sameWithDefaultObject) {
-                Common::Serializer<uint32_t>::Serialize(stream, 0);
-            } else {
-                Common::Serializer<uint32_t>::Serialize(stream, memberVariable.second.SizeOf());
-                memberVariable.second.Serialize(stream, obj);
+            const Class* clazz = this;
+            while (clazz != nullptr && clazz->GetNameHash() != classHeader[0]) {
+                clazz = clazz->GetBaseClass();
+            }
+
+            memberSchema.resize(classHeader[1] * 2);
+            stream.Read(memberSchema.data(), memberSchema.size() * sizeof(uint32_t));
+            for (uint32_t j = 0; j < classHeader[1]; j++) {
+                const auto* memberVariable = clazz == nullptr ? nullptr : clazz->FindMemberVariable(memberSchema[j * 2]);
+                if (memberVariable != nullptr && memberVariable->SizeOf() != memberSchema[j * 2 + 1]) {
+                    memberVariable = nullptr;
+                }
+                slots.emplace_back(memberVariable);
+            }
+        }
+
+        for (const auto* memberVariable : slots) {
+            uint32_t payloadSize;
+            stream.Read(&payloadSize, sizeof(uint32_t));
+            if (payloadSize == 0) {
+                continue;
+            }
+            // member reads never cross its payload, the next chunk always starts right after it even if deserializing fails
+            Common::BoundedDeserializeStream payloadStream(stream, payloadSize);
+            if (memberVariable != nullptr) {
+                memberVariable->Deserialize(payloadStream, obj);
             }
         }
     }
 
-    void Class::Deserailize(Common::DeserializeStream& stream, Mirror::Any* obj) const
+    void Class::DeserializeLegacy(Common::DeserializeStream& stream, Mirror::Any* obj, bool nameTypeIdRead) const
     {
         const auto* baseClass = GetBaseClass();
         if (baseClass != nullptr) {
-            baseClass->Deserailize(stream, obj);
+            baseClass->DeserializeLegacy(stream, obj, nameTypeIdRead);
+            nameTypeIdRead = false;
         }
 
-        Assert(defaultObject.has_value());
-
         std::string className;
-        Common::Serializer<std::string>::Deserialize(stream, className);
+        if (nameTypeIdRead) {
+            uint64_t classNameSize;
+            Common::Serializer<uint64_t>::Deserialize(stream, classNameSize);
+            className.resize(classNameSize);
+            stream.Read(className.data(), classNameSize);
+        } else {
+            Common::Serializer<std::string>::Deserialize(stream, className);
+        }
 
         uint64_t memberVariableSize;
         Common::Serializer<uint64_t>::Deserialize(stream, memberVariableSize);
@@ -6,6 +6,9 @@
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
+#include <atomic>
+#include <new>
+#include <cstdlib>
 
 #include <gtest/gtest.h>
 
@@ -28,6 +31,31 @@ struct AnyTestStruct2 : public AnyTestStruct0 {
     char charValue;
 };
 
+struct AnyTestStruct3 {
+    uint8_t bytes[128];
+};
+
+static std::atomic<uint32_t> allocationCount = 0;
+
+void* operator new(size_t size)
+{
+    allocationCount++;
+    if (void* result = std::malloc(size); result != nullptr) {
+        return result;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
 TEST(AnyTest, ValueAssignTest)
 {
     Mirror::Any a0 = 1;
@@ -329,3 +357,33 @@ TEST(AnyTest, EqualTest)
     Mirror::Any a1 = 1;
     ASSERT_TRUE(a0 == a1);
 }
+
+TEST(AnyTest, AllocationTest)
+{
+    int v0 = 1;
+    AnyTestStruct0 v1 = { 1, 2.0f };
+    AnyTestStruct3 v2 {};
+
+    // small values and references live in the inline buffer, so construct, copy and move never allocate
+    Mirror::Any a0;
+    const uint32_t begin = allocationCount;
+    for (auto i = 0; i < 1000; i++) {
+        Mirror::Any a1 = i;
+        Mirror::Any a2 = std::ref(v0);
+        Mirror::Any a3 = v1;
+        Mirror::Any a4 = a3;
+        Mirror::Any a5 = std::move(a4);
+        a0 = a5;
+    }
+    ASSERT_EQ(allocationCount - begin, 0);
+    ASSERT_EQ(a0.As<const AnyTestStruct0&>().intValue, 1);
+
+    // large values fall back to heap, moving them only transfers ownership
+    Mirror::Any warmUp = v2;
+    const uint32_t largeBegin = allocationCount;
+    Mirror::Any a6 = v2;
+    Mirror::Any a7 = std::move(a6);
+    ASSERT_EQ(allocationCount - largeBegin, 1);
+    ASSERT_EQ(a6.TypeInfo(), nullptr);
+    ASSERT_EQ(a7.Size(), sizeof(AnyTestStruct3));
+}
@@ -0,0 +1,177 @@
+//
+// Created by johnk on 2024/3/30.
+//
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Common/Serialization.h>
+#include <Mirror/Mirror.h>
+#include <GeneratedSerializationTest.h>
+
+static GeneratedSerializationTestStruct CreateGeneratedSerializationTestStruct(uint32_t seed)
+{
+    GeneratedSerializationTestStruct result;
+    result.v0 = static_cast<int32_t>(seed);
+    result.v1 = static_cast<float>(seed) * 0.5f;
+    result.v2 = static_cast<double>(seed) * 0.25;
+    result.v3 = std::to_string(seed);
+    result.v4 = { static_cast<int32_t>(seed), 1, 2 };
+    result.v5 = seed * 3ull;
+    result.v12 = -static_cast<int32_t>(seed);
+    result.v15 = "name" + std::to_string(seed);
+    result.v22 = { 3, 4 };
+    result.v29 = seed;
+    return result;
+}
+
+TEST(GeneratedSerializationTest, BasicTest)
+{
+    const auto obj = CreateGeneratedSerializationTestStruct(7);
+
+    std::vector<uint8_t> bytes;
+    {
+        Common::ByteSerializeStream stream(bytes);
+        Common::Serializer<GeneratedSerializationTestStruct>::Serialize(stream, obj);
+    }
+
+    GeneratedSerializationTestStruct restored;
+    Common::ByteDeserializeStream stream(bytes);
+    ASSERT_TRUE(Common::Serializer<GeneratedSerializationTestStruct>::Deserialize(stream, restored));
+    ASSERT_EQ(restored, obj);
+}
+
+TEST(GeneratedSerializationTest, DerivedClassTest)
+{
+    GeneratedSerializationTestDerivedStruct obj;
+    static_cast<GeneratedSerializationTestStruct&>(obj) = CreateGeneratedSerializationTestStruct(9);
+    obj.name = "derived";
+
+    std::vector<uint8_t> bytes;
+    {
+        Common::ByteSerializeStream stream(bytes);
+        Common::Serializer<GeneratedSerializationTestDerivedStruct>::Serialize(stream, obj);
+    }
+
+    GeneratedSerializationTestDerivedStruct restored;
+    Common::ByteDeserializeStream stream(bytes);
+    ASSERT_TRUE(Common::Serializer<GeneratedSerializationTestDerivedStruct>::Deserialize(stream, restored));
+    ASSERT_EQ(static_cast<const GeneratedSerializationTestStruct&>(restored), static_cast<const GeneratedSerializationTestStruct&>(obj));
+    ASSERT_EQ(restored.name, "derived");
+
+    // base class data is not accepted as derived class
+    GeneratedSerializationTestDerivedStruct mismatched;
+    std::vector<uint8_t> baseBytes;
+    {
+        Common::ByteSerializeStream baseStream(baseBytes);
+        Common::Serializer<GeneratedSerializationTestStruct>::Serialize(baseStream, obj);
+    }
+    Common::ByteDeserializeStream baseStream(baseBytes);
+    ASSERT_FALSE(Common::Serializer<GeneratedSerializationTestDerivedStruct>::Deserialize(baseStream, mismatched));
+}
+
+TEST(GeneratedSerializationTest, QualifiedNameTest)
+{
+    using SameName0 = GeneratedSerializationTestNs0::GeneratedSerializationTestSameName;
+    using SameName1 = GeneratedSerializationTestNs1::GeneratedSerializationTestSameName;
+    static_assert(Mirror::Internal::GetQualifiedClassName<SameName0>() == "GeneratedSerializationTestNs0::GeneratedSerializationTestSameName");
+    static_assert(Common::Serializer<SameName0>::typeId != Common::Serializer<SameName1>::typeId);
+
+    SameName0 obj;
+    obj.value = 1;
+    std::vector<uint8_t> bytes;
+    {
+        Common::ByteSerializeStream stream(bytes);
+        Common::Serializer<SameName0>::Serialize(stream, obj);
+    }
+
+    SameName1 other;
+    Common::ByteDeserializeStream stream(bytes);
+    ASSERT_FALSE(Common::Serializer<SameName1>::Deserialize(stream, other));
+    ASSERT_EQ(other.value, 0);
+}
+
+TEST(GeneratedSerializationTest, ReflectionFallbackTest)
+{
+    // reflection path still works for the same class, e.g. when only a Class is known at runtime
+    const auto& clazz = GeneratedSerializationTestStruct::GetClass();
+    auto obj = CreateGeneratedSerializationTestStruct(11);
+
+    std::vector<uint8_t> bytes;
+    {
+        Common::ByteSerializeStream stream(bytes);
+        Mirror::Any ref = std::ref(obj);
+        clazz.Serialize(stream, &ref);
+    }
+
+    GeneratedSerializationTestStruct restored;
+    Common::ByteDeserializeStream stream(bytes);
+    Mirror::Any ref = std::ref(restored);
+    clazz.Deserailize(stream, &ref);
+    ASSERT_EQ(restored, obj);
+}
+
+TEST(GeneratedSerializationTest, ThroughputTest)
+{
+    // 30 member variables per object, compares generated serializer with Class::Serialize
+    constexpr uint32_t objectNum = 10000;
+    const auto& clazz = GeneratedSerializationTestStruct::GetClass();
+
+    std::vector<GeneratedSerializationTestStruct> objs;
+    objs.reserve(objectNum);
+    for (uint32_t i = 0; i < objectNum; i++) {
+        objs.emplace_back(CreateGeneratedSerializationTestStruct(i));
+    }
+
+    const auto measure = [](auto&& func) -> double {
+        const auto begin = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    };
+
+    std::vector<uint8_t> generatedBytes;
+    const double generatedSaveMs = measure([&]() -> void {
+        Common::ByteSerializeStream stream(generatedBytes);
+        for (const auto& obj : objs) {
+            Common::Serializer<GeneratedSerializationTestStruct>::Serialize(stream, obj);
+        }
+    });
+
+    std::vector<uint8_t> reflectionBytes;
+    const double reflectionSaveMs = measure([&]() -> void {
+        Common::ByteSerializeStream stream(reflectionBytes);
+        for (auto& obj : objs) {
+            Mirror::Any ref = std::ref(obj);
+            clazz.Serialize(stream, &ref);
+        }
+    });
+
+    const double generatedLoadMs = measure([&]() -> void {
+        Common::ByteDeserializeStream stream(generatedBytes);
+        for (uint32_t i = 0; i < objectNum; i++) {
+            GeneratedSerializationTestStruct obj;
+            ASSERT_TRUE(Common::Serializer<GeneratedSerializationTestStruct>::Deserialize(stream, obj));
+            ASSERT_EQ(obj.v0, static_cast<int32_t>(i));
+        }
+    });
+
+    const double reflectionLoadMs = measure([&]() -> void {
+        Common::ByteDeserializeStream stream(reflectionBytes);
+        for (uint32_t i = 0; i < objectNum; i++) {
+            GeneratedSerializationTestStruct obj;
+            Mirror::Any ref = std::ref(obj);
+            clazz.Deserailize(stream, &ref);
+            ASSERT_EQ(obj.v0, static_cast<int32_t>(i));
+        }
+    });
+
+    RecordProperty("generatedSaveMs", std::to_string(generatedSaveMs));
+    RecordProperty("reflectionSaveMs", std::to_string(reflectionSaveMs));
+    RecordProperty("generatedLoadMs", std::to_string(generatedLoadMs));
+    RecordProperty("reflectionLoadMs", std::to_string(reflectionLoadMs));
+    RecordProperty("generatedBytes", std::to_string(generatedBytes.size()));
+    RecordProperty("reflectionBytes", std::to_string(reflectionBytes.size()));
+}
@@ -0,0 +1,134 @@
+//
+// Created by johnk on 2024/3/30.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <Mirror/Meta.h>
+#include <Mirror/Mirror.h>
+
+struct EClass() GeneratedSerializationTestStruct {
+    EClassBody(GeneratedSerializationTestStruct)
+
+    bool operator==(const GeneratedSerializationTestStruct& rhs) const = default;
+
+    EProperty()
+    int32_t v0 = 0;
+
+    EProperty()
+    float v1 = 0.0f;
+
+    EProperty()
+    double v2 = 0.0;
+
+    EProperty()
+    std::string v3;
+
+    EProperty()
+    std::vector<int32_t> v4;
+
+    EProperty()
+    uint64_t v5 = 0;
+
+    EProperty()
+    int32_t v6 = 0;
+
+    EProperty()
+    float v7 = 0.0f;
+
+    EProperty()
+    double v8 = 0.0;
+
+    EProperty()
+    std::string v9;
+
+    EProperty()
+    std::vector<int32_t> v10;
+
+    EProperty()
+    uint64_t v11 = 0;
+
+    EProperty()
+    int32_t v12 = 0;
+
+    EProperty()
+    float v13 = 0.0f;
+
+    EProperty()
+    double v14 = 0.0;
+
+    EProperty()
+    std::string v15;
+
+    EProperty()
+    std::vector<int32_t> v16;
+
+    EProperty()
+    uint64_t v17 = 0;
+
+    EProperty()
+    int32_t v18 = 0;
+
+    EProperty()
+    float v19 = 0.0f;
+
+    EProperty()
+    double v20 = 0.0;
+
+    EProperty()
+    std::string v21;
+
+    EProperty()
+    std::vector<int32_t> v22;
+
+    EProperty()
+    uint64_t v23 = 0;
+
+    EProperty()
+    int32_t v24 = 0;
+
+    EProperty()
+    float v25 = 0.0f;
+
+    EProperty()
+    double v26 = 0.0;
+
+    EProperty()
+    std::string v27;
+
+    EProperty()
+    std::vector<int32_t> v28;
+
+    EProperty()
+    uint64_t v29 = 0;
+};
+
+struct EClass() GeneratedSerializationTestDerivedStruct : GeneratedSerializationTestStruct {
+    EClassBody(GeneratedSerializationTestDerivedStruct)
+
+    EProperty()
+    std::string name;
+};
+
+// same class name in two namespaces, type ids of them must differ
+namespace GeneratedSerializationTestNs0 {
+    struct EClass() GeneratedSerializationTestSameName {
+        EClassBody(GeneratedSerializationTestSameName)
+
+        EProperty()
+        int32_t value = 0;
+    };
+}
+
+namespace GeneratedSerializationTestNs1 {
+    struct EClass() GeneratedSerializationTestSameName {
+        EClassBody(GeneratedSerializationTestSameName)
+
+        EProperty()
+        int32_t value = 0;
+    };
+}
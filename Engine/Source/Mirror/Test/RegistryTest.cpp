@@ -2,6 +2,9 @@
 // Created by johnk on 2022/9/29.
 //
 
+#include <chrono>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include <Mirror/Registry.h>
@@ -74,6 +77,27 @@ struct C3 : public C2 {
     int c;
 };
 
+int F3(int a, const int& b)
+{
+    return a * b;
+}
+
+struct C4 {
+    explicit C4(int inV0) : v0(inV0) {}
+
+    int Add(int value) const
+    {
+        return v0 + value;
+    }
+
+    void Set(int value)
+    {
+        v0 = value;
+    }
+
+    int v0;
+};
+
 TEST(RegistryTest, GlobalScopeTest)
 {
     Mirror::Registry::Get()
@@ -215,6 +239,130 @@ TEST(RegistryTest, ClassTest)
     }
 }
 
+TEST(RegistryTest, TypedInvokeTest)
+{
+    Mirror::Registry::Get()
+        .Global()
+            .Function<&F3>("F3");
+
+    Mirror::Registry::Get()
+        .Class<C4>("C4")
+            .Constructor<int>("Constructor0")
+            .MemberFunction<&C4::Add>("Add")
+            .MemberFunction<&C4::Set>("Set")
+            .MemberVariable<&C4::v0>("v0");
+
+    {
+        const auto& function = Mirror::GlobalScope::Get().GetFunction("F3");
+        const int b = 3;
+        ASSERT_EQ(function.TypedInvoke<int(int, const int&)>(2, b), 6);
+        ASSERT_EQ(function.Invoke(2, b).As<int>(), 6);
+    }
+
+    {
+        const auto& clazz = Mirror::Class::Get<C4>();
+        const auto& constructor = clazz.GetConstructor("Constructor0");
+        C4 object = constructor.TypedConstructOnStack<C4(int)>(1);
+        ASSERT_EQ(object.v0, 1);
+
+        const auto& add = clazz.GetMemberFunction("Add");
+        const auto& set = clazz.GetMemberFunction("Set");
+        ASSERT_EQ(add.TypedInvoke<int(int)>(object, 2), 3);
+        set.TypedInvoke<void(int)>(object, 5);
+        ASSERT_EQ(object.v0, 5);
+
+        const C4& constObject = object;
+        ASSERT_EQ(add.TypedInvoke<int(int)>(constObject, 1), 6);
+
+        const auto& v0 = clazz.GetMemberVariable("v0");
+        v0.TypedGet<int>(object) = 7;
+        ASSERT_EQ(v0.TypedGet<int>(constObject), 7);
+
+        C4* newObject = constructor.TypedNewObject<C4(int)>(8);
+        ASSERT_EQ(v0.TypedGet<int>(*newObject), 8);
+        delete newObject;
+    }
+
+    {
+        // signature mismatch must never call through the thunk, in any build config
+        const auto& function = Mirror::GlobalScope::Get().GetFunction("F3");
+        const auto& v0 = Mirror::Class::Get<C4>().GetMemberVariable("v0");
+        C4 object(1);
+        ASSERT_DEATH(function.TypedInvoke<int(int)>(2), "");
+        ASSERT_DEATH(v0.TypedGet<float>(object), "");
+    }
+}
+
+int F4(int a, int b)
+{
+    return a ^ b;
+}
+
+struct C5 {
+    int Add(int value)
+    {
+        v0 += value;
+        return v0;
+    }
+
+    int v0 = 0;
+};
+
+TEST(RegistryTest, TypedInvokeBenchmarkTest)
+{
+    // compares typed thunks with the boxed Any path, both call the same registered function
+    Mirror::Registry::Get()
+        .Global()
+            .Function<&F4>("F4");
+
+    Mirror::Registry::Get()
+        .Class<C5>("C5")
+            .MemberFunction<&C5::Add>("Add");
+
+    constexpr int callNum = 1000000;
+    const auto measure = [](auto&& func) -> double {
+        const auto begin = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    };
+
+    const auto& function = Mirror::GlobalScope::Get().GetFunction("F4");
+    int typedResult = 0;
+    const double typedFunctionMs = measure([&]() -> void {
+        for (int i = 0; i < callNum; i++) {
+            typedResult = function.TypedInvoke<int(int, int)>(typedResult, i);
+        }
+    });
+    int boxedResult = 0;
+    const double boxedFunctionMs = measure([&]() -> void {
+        for (int i = 0; i < callNum; i++) {
+            boxedResult = function.Invoke(boxedResult, i).As<int>();
+        }
+    });
+    ASSERT_EQ(typedResult, boxedResult);
+
+    const auto& add = Mirror::Class::Get<C5>().GetMemberFunction("Add");
+    C5 typedObject;
+    const double typedMemberFunctionMs = measure([&]() -> void {
+        for (int i = 0; i < callNum; i++) {
+            add.TypedInvoke<int(int)>(typedObject, 1);
+        }
+    });
+    C5 boxedObject;
+    const double boxedMemberFunctionMs = measure([&]() -> void {
+        for (int i = 0; i < callNum; i++) {
+            add.Invoke(boxedObject, 1);
+        }
+    });
+    ASSERT_EQ(typedObject.v0, callNum);
+    ASSERT_EQ(boxedObject.v0, callNum);
+
+    RecordProperty("typedFunctionMs", std::to_string(typedFunctionMs));
+    RecordProperty("boxedFunctionMs", std::to_string(boxedFunctionMs));
+    RecordProperty("typedMemberFunctionMs", std::to_string(typedMemberFunctionMs));
+    RecordProperty("boxedMemberFunctionMs", std::to_string(boxedMemberFunctionMs));
+}
+
 TEST(RegistryTest, EnumTest)
 {
     Mirror::Registry::Get()
@@ -6,6 +6,8 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <filesystem>
+#include <chrono>
+#include <cstring>
 
 #include <gtest/gtest.h>
 
@@ -29,6 +31,31 @@ struct SerializationTestStruct1 {
     std::vector<std::vector<bool>> d;
 };
 
+struct SerializationTestStruct2 {
+    std::unordered_map<std::string, Common::SpanView<uint8_t>> a;
+    Common::StringView b;
+};
+
+struct SerializationTestStruct3 : SerializationTestStruct0 {
+    std::vector<int> d;
+};
+
+// same class in two versions, a changed its type, b and c are kept, d is added, e changed its type but not its size
+struct SerializationTestEvolveV1 {
+    int a = 0;
+    std::string b;
+    std::vector<int> c;
+    int32_t e = 0;
+};
+
+struct SerializationTestEvolveV2 {
+    double a = 0.0;
+    std::string b;
+    std::vector<int> c;
+    float d = 0.0f;
+    float e = 0.0f;
+};
+
 struct MirrorInfoRegistry {
     MirrorInfoRegistry()
     {
@@ -50,6 +77,30 @@ struct MirrorInfoRegistry {
                 .MemberVariable<&SerializationTestStruct1::b>("b")
                 .MemberVariable<&SerializationTestStruct1::c>("c")
                 .MemberVariable<&SerializationTestStruct1::d>("d");
+
+        Mirror::Registry::Get()
+            .Class<SerializationTestStruct2>("SerializationTestStruct2")
+                .MemberVariable<&SerializationTestStruct2::a>("a")
+                .MemberVariable<&SerializationTestStruct2::b>("b");
+
+        Mirror::Registry::Get()
+            .Class<SerializationTestStruct3, SerializationTestStruct0>("SerializationTestStruct3")
+                .MemberVariable<&SerializationTestStruct3::d>("d");
+
+        Mirror::Registry::Get()
+            .Class<SerializationTestEvolveV1>("SerializationTestEvolveV1")
+                .MemberVariable<&SerializationTestEvolveV1::a>("a")
+                .MemberVariable<&SerializationTestEvolveV1::b>("b")
+                .MemberVariable<&SerializationTestEvolveV1::c>("c")
+                .MemberVariable<&SerializationTestEvolveV1::e>("e");
+
+        Mirror::Registry::Get()
+            .Class<SerializationTestEvolveV2>("SerializationTestEvolveV2")
+                .MemberVariable<&SerializationTestEvolveV2::a>("a")
+                .MemberVariable<&SerializationTestEvolveV2::b>("b")
+                .MemberVariable<&SerializationTestEvolveV2::c>("c")
+                .MemberVariable<&SerializationTestEvolveV2::d>("d")
+                .MemberVariable<&SerializationTestEvolveV2::e>("e");
     }
 };
 static MirrorInfoRegistry registry;
@@ -164,3 +215,181 @@ TEST(SerializationTest, ContainerFileSerializationTest)
         ASSERT_EQ(tRef.d[1][1], false);
     }
 }
+
+TEST(SerializationTest, ZeroCopyFileSerializationTest)
+{
+    static std::filesystem::path fileName = "../Test/Generated/SerializationTest.ZeroCopyFileSerializationTest.bin";
+    std::filesystem::create_directories(fileName.parent_path());
+    const auto& clazz = Mirror::Class::Get("SerializationTestStruct2");
+    {
+        Common::BufferedFileSerializeStream stream(fileName.string());
+
+        SerializationTestStruct2 obj;
+        obj.a = { { "1", Common::SpanView<uint8_t>(std::vector<uint8_t> { 2, 3 }) } };
+        obj.b = Common::StringView(std::string("4"));
+
+        Mirror::Any ref = std::ref(obj);
+        clazz.Serialize(stream, &ref);
+    }
+
+    SerializationTestStruct2 obj;
+    {
+        Common::MappedFileDeserializeStream stream(fileName.string());
+        stream.SetZeroCopy(true);
+
+        Mirror::Any ref = std::ref(obj);
+        clazz.Deserailize(stream, &ref);
+    }
+
+    // views hold the mapping after stream destroyed
+    ASSERT_EQ(obj.a.size(), 1);
+    ASSERT_FALSE(obj.a.at("1").IsOwning());
+    ASSERT_EQ(obj.a.at("1").ToVector(), std::vector<uint8_t>({ 2, 3 }));
+    ASSERT_FALSE(obj.b.IsOwning());
+    ASSERT_EQ(obj.b.View(), "4");
+}
+
+// layout written by Class::Serialize before the chunked layout
+static void SerializeLegacySerializationTestStruct0(Common::SerializeStream& stream, const SerializationTestStruct0& obj)
+{
+    Common::Serializer<std::string>::Serialize(stream, "SerializationTestStruct0");
+    Common::Serializer<uint64_t>::Serialize(stream, 3);
+
+    Common::Serializer<std::string>::Serialize(stream, "a");
+    Common::Serializer<bool>::Serialize(stream, false);
+    Common::Serializer<uint32_t>::Serialize(stream, sizeof(int));
+    Common::Serializer<int>::Serialize(stream, obj.a);
+
+    Common::Serializer<std::string>::Serialize(stream, "b");
+    Common::Serializer<bool>::Serialize(stream, false);
+    Common::Serializer<uint32_t>::Serialize(stream, sizeof(float));
+    Common::Serializer<float>::Serialize(stream, obj.b);
+
+    Common::Serializer<std::string>::Serialize(stream, "c");
+    Common::Serializer<bool>::Serialize(stream, false);
+    Common::Serializer<uint32_t>::Serialize(stream, sizeof(std::string));
+    Common::Serializer<std::string>::Serialize(stream, obj.c);
+}
+
+TEST(SerializationTest, LegacyClassLayoutTest)
+{
+    std::vector<uint8_t> bytes;
+    {
+        Common::ByteSerializeStream stream(bytes);
+        SerializeLegacySerializationTestStruct0(stream, { 1, 2.0f, "3" });
+    }
+
+    Common::ByteDeserializeStream stream(bytes);
+    SerializationTestStruct0 obj {};
+    Mirror::Any ref = std::ref(obj);
+    Mirror::Class::Get("SerializationTestStruct0").Deserailize(stream, &ref);
+    ASSERT_EQ(obj.a, 1);
+    ASSERT_EQ(obj.b, 2.0f);
+    ASSERT_EQ(obj.c, "3");
+}
+
+TEST(SerializationTest, DerivedClassSerializationTest)
+{
+    const auto& clazz = Mirror::Class::Get("SerializationTestStruct3");
+    std::vector<uint8_t> bytes;
+    {
+        SerializationTestStruct3 obj;
+        obj.a = 1;
+        obj.b = 2.0f;
+        obj.c = "3";
+        obj.d = { 4, 5 };
+
+        Common::ByteSerializeStream stream(bytes);
+        Mirror::Any ref = std::ref(obj);
+        clazz.Serialize(stream, &ref);
+        Common::Serializer<uint32_t>::Serialize(stream, 6);
+    }
+
+    Common::ByteDeserializeStream stream(bytes);
+    SerializationTestStruct3 obj {};
+    Mirror::Any ref = std::ref(obj);
+    clazz.Deserailize(stream, &ref);
+    ASSERT_EQ(obj.a, 1);
+    ASSERT_EQ(obj.b, 2.0f);
+    ASSERT_EQ(obj.c, "3");
+    ASSERT_EQ(obj.d, std::vector<int>({ 4, 5 }));
+
+    uint32_t tail = 0;
+    ASSERT_TRUE(Common::Serializer<uint32_t>::Deserialize(stream, tail));
+    ASSERT_EQ(tail, 6);
+}
+
+TEST(SerializationTest, SchemaEvolutionTest)
+{
+    std::vector<uint8_t> bytes;
+    {
+        SerializationTestEvolveV1 obj;
+        obj.a = 1;
+        obj.b = "2";
+        obj.c = { 3, 4 };
+        obj.e = 6;
+
+        Common::ByteSerializeStream stream(bytes);
+        Mirror::Any ref = std::ref(obj);
+        Mirror::Class::Get("SerializationTestEvolveV1").Serialize(stream, &ref);
+        Common::Serializer<uint32_t>::Serialize(stream, 5);
+    }
+
+    // pretend the data was written by the old version of SerializationTestEvolveV2, class hash follows magic and class num
+    const auto& clazz = Mirror::Class::Get("SerializationTestEvolveV2");
+    const uint32_t classHash = clazz.GetNameHash();
+    memcpy(bytes.data() + sizeof(uint32_t) * 2, &classHash, sizeof(uint32_t));
+
+    Common::ByteDeserializeStream stream(bytes);
+    SerializationTestEvolveV2 obj;
+    Mirror::Any ref = std::ref(obj);
+    clazz.Deserailize(stream, &ref);
+    ASSERT_EQ(obj.a, 0.0);
+    ASSERT_EQ(obj.b, "2");
+    ASSERT_EQ(obj.c, std::vector<int>({ 3, 4 }));
+    ASSERT_EQ(obj.d, 0.0f);
+    // the float deserializer rejects the int payload, which is then skipped as a whole
+    ASSERT_EQ(obj.e, 0.0f);
+
+    // payloads of unknown and rejected members are skipped exactly
+    uint32_t tail = 0;
+    ASSERT_TRUE(Common::Serializer<uint32_t>::Deserialize(stream, tail));
+    ASSERT_EQ(tail, 5);
+}
+
+TEST(SerializationTest, LargeLevelThroughputTest)
+{
+    // many objects in one stream, compares loading the chunked layout with the legacy one
+    constexpr uint32_t objectNum = 20000;
+    const auto& clazz = Mirror::Class::Get("SerializationTestStruct0");
+
+    std::vector<uint8_t> chunkedBytes;
+    std::vector<uint8_t> legacyBytes;
+    {
+        Common::ByteSerializeStream chunkedStream(chunkedBytes);
+        Common::ByteSerializeStream legacyStream(legacyBytes);
+        for (uint32_t i = 0; i < objectNum; i++) {
+            SerializationTestStruct0 obj { static_cast<int>(i), static_cast<float>(i), std::to_string(i) };
+            Mirror::Any ref = std::ref(obj);
+            clazz.Serialize(chunkedStream, &ref);
+            SerializeLegacySerializationTestStruct0(legacyStream, obj);
+        }
+    }
+
+    const auto load = [&](const std::vector<uint8_t>& bytes) -> double {
+        const auto begin = std::chrono::steady_clock::now();
+        Common::ByteDeserializeStream stream(bytes);
+        for (uint32_t i = 0; i < objectNum; i++) {
+            SerializationTestStruct0 obj {};
+            Mirror::Any ref = std::ref(obj);
+            clazz.Deserailize(stream, &ref);
+            EXPECT_EQ(obj.a, static_cast<int>(i));
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    };
+
+    RecordProperty("chunkedLoadMs", std::to_string(load(chunkedBytes)));
+    RecordProperty("legacyLoadMs", std::to_string(load(legacyBytes)));
+    RecordProperty("chunkedBytes", std::to_string(chunkedBytes.size()));
+    RecordProperty("legacyBytes", std::to_string(legacyBytes.size()));
+}
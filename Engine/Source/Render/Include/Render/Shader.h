@@ -5,6 +5,7 @@
 #pragma once
 
 #include <vector>
+#include <array>
 #include <unordered_map>
 #include <utility>
 #include <tuple>
@@ -13,6 +14,7 @@
 #include <Common/Utility.h>
 #include <Common/Debug.h>
 #include <Common/Hash.h>
+#include <Common/HashMap.h>
 #include <Common/File.h>
 #include <Common/Math/Vector.h>
 #include <RHI/Common.h>
@@ -60,7 +62,7 @@ namespace Render {
                 return 0;
             }
 
-            std::vector<size_t> values = {
+            const std::array<size_t, 2> values = {
                 typeKey,
                 variantKey
             };
@@ -161,7 +163,7 @@ namespace Render {
             });
         }
 
-        std::unordered_map<VariantKey, std::vector<std::string>> variantDefinitions;
+        Common::FlatHashMap<VariantKey, std::vector<std::string>> variantDefinitions;
     };
 
     template <typename T>
@@ -224,7 +226,7 @@ namespace Render {
         }
 
         RHI::Device& device;
-        std::unordered_map<VariantKey, Common::UniqueRef<RHI::ShaderModule>> shaderModules;
+        Common::FlatHashMap<VariantKey, Common::UniqueRef<RHI::ShaderModule>> shaderModules;
     };
 
     class GlobalShaderRegistry {
@@ -10,7 +10,7 @@
 #include <RHI/Common.h>
 #include <RHI/BindGroupLayout.h>
 #include <Render/Shader.h>
-#include <Common/Concurrent.h>
+#include <Core/JobSystem.h>
 
 namespace Render {
     enum class ShaderByteCodeType {
@@ -48,7 +48,5 @@ namespace Render {
 
     private:
         ShaderCompiler();
-
-        Common::ThreadPool threadPool;
     };
 }
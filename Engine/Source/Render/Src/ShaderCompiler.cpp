@@ -239,15 +239,13 @@ namespace Render {
         return instance;
     }
 
-    ShaderCompiler::ShaderCompiler() : threadPool("ShaderCompiler", 16)
-    {
-    }
+    ShaderCompiler::ShaderCompiler() = default;
 
     ShaderCompiler::~ShaderCompiler() = default;
 
     std::future<ShaderCompileOutput> ShaderCompiler::Compile(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions)
     {
-        return threadPool.EmplaceTask([](const ShaderCompileInput& input, const ShaderCompileOptions& options) -> ShaderCompileOutput {
+        return Core::JobSystem::Get().EmplaceTask([](const ShaderCompileInput& input, const ShaderCompileOptions& options) -> ShaderCompileOutput {
             ShaderCompileOutput output;
             CompileDxilOrSpriv(input, options, output);
             if (!output.success || options.byteCodeType != ShaderByteCodeType::mbc) {
@@ -6,12 +6,13 @@
 
 #include <type_traits>
 #include <unordered_map>
-#include <unordered_set>
 #include <functional>
 #include <variant>
 #include <optional>
 
 #include <Common/Memory.h>
+#include <Common/Container.h>
+#include <Common/HashMap.h>
 #include <Common/Debug.h>
 #include <RHI/RHI.h>
 #include <Rendering/ResourcePool.h>
@@ -214,13 +215,13 @@ namespace Rendering {
     };
 
     struct RGRasterPassDesc {
-        std::vector<RGColorAttachment> colorAttachments;
+        Common::SmallVector<RGColorAttachment, 8> colorAttachments;
         std::optional<RGDepthStencilAttachment> depthStencilAttachment;
     };
 
     struct RGCopyPassDesc {
-        std::vector<RGResourceRef> copySrcs;
-        std::vector<RGResourceRef> copyDsts;
+        Common::SmallVector<RGResourceRef, 4> copySrcs;
+        Common::SmallVector<RGResourceRef, 4> copyDsts;
     };
 
     struct RGBindItemDesc {
@@ -270,8 +271,8 @@ namespace Rendering {
     };
 
     struct RGResourcesStates {
-        std::unordered_map<RGBufferRef, RHI::BufferState> buffer;
-        std::unordered_map<RGTextureRef, RHI::TextureState> texture;
+        Common::FlatHashMap<RGBufferRef, RHI::BufferState> buffer;
+        Common::FlatHashMap<RGTextureRef, RHI::TextureState> texture;
     };
 
     class RGPass {
@@ -294,7 +295,7 @@ namespace Rendering {
 
         std::string name;
         RGPassType type;
-        std::unordered_set<RGResourceRef> reads;
+        Common::FlatHashSet<RGResourceRef> reads;
         RGResourcesStates transitionInfos;
     };
 
@@ -6,6 +6,7 @@
 
 #include <unordered_map>
 
+#include <Common/HashMap.h>
 #include <RHI/RHI.h>
 #include <Render/Shader.h>
 
@@ -176,7 +177,7 @@ namespace Rendering {
         explicit SamplerCache(RHI::Device& inDevice);
 
         RHI::Device& device;
-        std::unordered_map<size_t, Common::UniqueRef<Sampler>> samplers;
+        Common::FlatHashMap<size_t, Common::UniqueRef<Sampler>> samplers;
     };
 
     class PipelineCache {
@@ -193,8 +194,8 @@ namespace Rendering {
         explicit PipelineCache(RHI::Device& inDevice);
 
         RHI::Device& device;
-        std::unordered_map<size_t, Common::UniqueRef<ComputePipelineState>> computePipelines;
-        std::unordered_map<size_t, Common::UniqueRef<RasterPipelineState>> rasterPipelines;
+        Common::FlatHashMap<size_t, Common::UniqueRef<ComputePipelineState>> computePipelines;
+        Common::FlatHashMap<size_t, Common::UniqueRef<RasterPipelineState>> rasterPipelines;
     };
 
     class ResourceViewCache {
@@ -212,7 +213,7 @@ namespace Rendering {
         explicit ResourceViewCache(RHI::Device& inDevice);
 
         RHI::Device& device;
-        std::unordered_map<RHI::Buffer*, std::unordered_map<size_t, Common::UniqueRef<RHI::BufferView>>> bufferViews;
-        std::unordered_map<RHI::Texture*, std::unordered_map<size_t, Common::UniqueRef<RHI::TextureView>>> textureViews;
+        Common::FlatHashMap<RHI::Buffer*, Common::FlatHashMap<size_t, Common::UniqueRef<RHI::BufferView>>> bufferViews;
+        Common::FlatHashMap<RHI::Texture*, Common::FlatHashMap<size_t, Common::UniqueRef<RHI::TextureView>>> textureViews;
     };
 }
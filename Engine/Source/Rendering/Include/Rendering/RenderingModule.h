@@ -23,6 +23,7 @@ namespace Rendering {
         void ShutdownRenderingThread();
         void FlushAllRenderingCommands();
 
+        // can be called from any thread, including the rendering thread itself
         template <typename F, typename... Args>
         auto EnqueueRenderingCommand(F&& command, Args&&... args)
         {
@@ -30,7 +31,18 @@ namespace Rendering {
             return renderingThread->EmplaceTask(std::forward<F>(command), std::forward<Args>(args)...);
         }
 
+        // fast path without future, only the thread which started rendering thread may call it, returns fence of the command
+        template <typename F>
+        uint64_t SubmitRenderingCommand(F&& command)
+        {
+            Assert(renderingThread != nullptr);
+            return renderingThread->Submit(std::forward<F>(command));
+        }
+
+        bool IsRenderingCommandFinished(uint64_t fence) const;
+        void WaitRenderingCommand(uint64_t fence);
+
     private:
-        Common::UniqueRef<Common::WorkerThread> renderingThread;
+        Common::UniqueRef<Common::SPSCWorkerThread> renderingThread;
     };
 }
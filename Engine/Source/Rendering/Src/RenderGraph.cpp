@@ -49,11 +49,11 @@ namespace Rendering::Internal {
         return result;
     }
 
-    static std::vector<RHI::GraphicsPassColorAttachment> GetRasterPassColorAttachments(const RGRasterPassDesc& desc)
+    static Common::SmallVector<RHI::GraphicsPassColorAttachment, 8> GetRasterPassColorAttachments(const RGRasterPassDesc& desc)
     {
         static_assert(std::is_base_of_v<RHI::GraphicsPassColorAttachmentBase, RGColorAttachment>);
 
-        std::vector<RHI::GraphicsPassColorAttachment> result;
+        Common::SmallVector<RHI::GraphicsPassColorAttachment, 8> result;
         result.reserve(desc.colorAttachments.size());
 
         for (const auto& colorAttachment : desc.colorAttachments) {
@@ -643,7 +643,7 @@ namespace Rendering {
         RHI::CommandBuffer* cmdBuffer = cmdBuffers.mainCmdBuffer;
         Common::UniqueRef<RHI::CommandEncoder> cmdEncoder = cmdBuffer->Begin();
         {
-            std::vector<RHI::GraphicsPassColorAttachment> colorAttachments = Internal::GetRasterPassColorAttachments(passDesc);
+            auto colorAttachments = Internal::GetRasterPassColorAttachments(passDesc);
             std::optional<RHI::GraphicsPassDepthStencilAttachment> depthStencilAttachment = Internal::GetRasterPassDepthStencilAttachment(passDesc);
 
             RHI::GraphicsPassBeginInfo passBeginInfo;
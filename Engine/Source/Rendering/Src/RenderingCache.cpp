@@ -4,8 +4,11 @@
 
 #include <Rendering/RenderingCache.h>
 
+#include <array>
 #include <utility>
 
+#include <Common/Container.h>
+
 namespace Rendering {
     class PipelineLayoutCache {
     public:
@@ -30,7 +33,7 @@ namespace Rendering {
         explicit PipelineLayoutCache(RHI::Device& inDevice);
 
         RHI::Device& device;
-        std::unordered_map<size_t, Common::UniqueRef<PipelineLayout>> pipelineLayouts;
+        Common::FlatHashMap<size_t, Common::UniqueRef<PipelineLayout>> pipelineLayouts;
     };
 
     PipelineLayoutCache& PipelineLayoutCache::Get(RHI::Device& device)
@@ -60,7 +63,7 @@ namespace Rendering {
 namespace Rendering {
     size_t ComputePipelineShaderSet::Hash() const
     {
-        std::vector<size_t> values = {
+        const std::array<size_t, 1> values = {
             computeShader.Hash()
         };
         return Common::HashUtils::CityHash(values.data(), values.size() * sizeof(size_t));
@@ -68,7 +71,7 @@ namespace Rendering {
 
     size_t RasterPipelineShaderSet::Hash() const
     {
-        std::vector<size_t> values = {
+        const std::array<size_t, 5> values = {
             vertexShader.Hash(),
             pixelShader.Hash(),
             geometryShader.Hash(),
@@ -96,7 +99,7 @@ namespace Rendering {
     size_t RasterPipelineStateDesc::Hash() const
     {
         auto computeVertexAttributeHash = [](const RHI::VertexAttribute& attribute) -> size_t {
-            std::vector<size_t> values = {
+            const std::array<size_t, 4> values = {
                 Common::HashUtils::CityHash(&attribute.format, sizeof(attribute.format)),
                 Common::HashUtils::CityHash(&attribute.offset, sizeof(attribute.offset)),
                 Common::HashUtils::CityHash(attribute.semanticName, sizeof(attribute.semanticName)),
@@ -105,7 +108,7 @@ namespace Rendering {
             return Common::HashUtils::CityHash(values.data(), values.size() * sizeof(size_t));
         };
         auto computeVertexBufferLayoutHash = [computeVertexAttributeHash](const RHI::VertexBufferLayout& bufferLayout) -> size_t {
-            std::vector<size_t> values;
+            Common::SmallVector<size_t, 16> values;
             values.reserve(bufferLayout.attributeNum + 2);
             values.emplace_back(Common::HashUtils::CityHash(&bufferLayout.stride, sizeof(bufferLayout.stride)));
             values.emplace_back(Common::HashUtils::CityHash(&bufferLayout.stepMode, sizeof(bufferLayout.stepMode)));
@@ -115,7 +118,7 @@ namespace Rendering {
             return Common::HashUtils::CityHash(values.data(), values.size() * sizeof(size_t));
         };
         auto computeVertexStateHash = [computeVertexBufferLayoutHash](const VertexState& state) -> size_t {
-            std::vector<size_t> values;
+            Common::SmallVector<size_t, 8> values;
             values.reserve(state.bufferLayoutNum);
             for (auto i = 0; i < state.bufferLayoutNum; i++) {
                 values.emplace_back(computeVertexBufferLayoutHash(state.bufferLayouts[i]));
@@ -126,7 +129,7 @@ namespace Rendering {
             return Common::HashUtils::CityHash(state.colorTargets, state.colorTargetNum * sizeof(RHI::ColorTargetState));
         };
 
-        std::vector<size_t> values = {
+        const std::array<size_t, 6> values = {
             shaders.Hash(),
             computeVertexStateHash(vertexState),
             Common::HashUtils::CityHash(&primitiveState, sizeof(PrimitiveState)),
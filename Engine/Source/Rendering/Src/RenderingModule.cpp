@@ -22,7 +22,7 @@ namespace Rendering {
 
     void RenderingModule::StartupRenderingThread()
     {
-        renderingThread = Common::MakeUnique<Common::WorkerThread>("RenderingThread");
+        renderingThread = Common::MakeUnique<Common::SPSCWorkerThread>("RenderingThread");
     }
 
     void RenderingModule::ShutdownRenderingThread()
@@ -35,6 +35,18 @@ namespace Rendering {
         Assert(renderingThread != nullptr);
         renderingThread->Flush();
     }
+
+    bool RenderingModule::IsRenderingCommandFinished(uint64_t fence) const
+    {
+        Assert(renderingThread != nullptr);
+        return renderingThread->IsFencePassed(fence);
+    }
+
+    void RenderingModule::WaitRenderingCommand(uint64_t fence)
+    {
+        Assert(renderingThread != nullptr);
+        renderingThread->WaitFence(fence);
+    }
 }
 
 IMPLEMENT_MODULE(RENDERING_API, Rendering::RenderingModule);
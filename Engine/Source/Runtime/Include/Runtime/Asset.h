@@ -5,13 +5,14 @@
 #pragma once
 
 #include <string>
+#include <filesystem>
 #include <functional>
 #include <unordered_map>
 #include <utility>
 
 #include <Common/Memory.h>
 #include <Common/Serialization.h>
-#include <Common/Concurrent.h>
+#include <Core/JobSystem.h>
 #include <Core/Uri.h>
 #include <Mirror/Meta.h>
 #include <Mirror/Mirror.h>
@@ -324,7 +325,7 @@ namespace Runtime {
         template <typename A>
         void AsyncLoad(const Core::Uri& uri, const OnAssetLoaded<A>& onAssetLoaded)
         {
-            threadPool.EmplaceTask([this, uri, onAssetLoaded]() -> void {
+            Core::JobSystem::Get().Schedule([this, uri, onAssetLoaded]() -> void {
                 AssetRef<A> result = nullptr;
                 {
                     std::unique_lock<std::mutex> lock(mutex);
@@ -356,7 +357,7 @@ namespace Runtime {
         template <typename A>
         void AsyncLoadSoft(SoftAssetRef<A>& softAssetRef, const OnSoftAssetLoaded<A>& onSoftAssetLoaded)
         {
-            threadPool.EmplaceTask([this, softAssetRef, onSoftAssetLoaded]() -> void {
+            Core::JobSystem::Get().Schedule([this, softAssetRef, onSoftAssetLoaded]() -> void {
                 AsyncLoad(softAssetRef.Uri(), [&](AssetRef<A>& ref) -> void {
                     softAssetRef = ref;
                     onSoftAssetLoaded();
@@ -364,19 +365,37 @@ namespace Runtime {
             });
         }
 
+        // false if the new data could not replace the old file, it is kept in the temp file beside it then
         template <typename A>
-        void Save(const AssetRef<A>& assetRef)
+        bool Save(const AssetRef<A>& assetRef)
         {
             if (assetRef == nullptr) {
-                return;
+                return false;
             }
 
             Core::AssetUriParser parser(assetRef.Uri());
             auto pathString = parser.AbsoluteFilePath().string();
-            Common::BinaryFileSerializeStream stream(pathString);
+            // loaded assets may still view the mapping of the old file, so it is replaced instead of being truncated
+            auto tempPathString = pathString + ".tmp";
+            {
+                Common::BufferedFileSerializeStream stream(tempPathString);
+
+                Mirror::Any ref = std::ref(*assetRef.Get());
+                A::GetClass().Serialize(stream, &ref);
+            }
 
-            Mirror::Any ref = std::ref(*assetRef.Get());
-            A::GetClass().Serialize(stream, &ref);
+            // rename can still fail when the old file is locked, then fall back to overwriting it
+            std::error_code errorCode;
+            std::filesystem::rename(tempPathString, pathString, errorCode);
+            if (!errorCode) {
+                return true;
+            }
+            std::filesystem::copy_file(tempPathString, pathString, std::filesystem::copy_options::overwrite_existing, errorCode);
+            if (errorCode) {
+                return false;
+            }
+            std::filesystem::remove(tempPathString, errorCode);
+            return true;
         }
 
         template <typename A>
@@ -391,7 +410,12 @@ namespace Runtime {
         {
             Core::AssetUriParser parser(uri);
             auto pathString = parser.AbsoluteFilePath().string();
-            Common::BinaryFileDeserializeStream stream(pathString);
+            // views in the asset (e.g. Common::SpanView) reference the mapped file instead of copying, and keep it mapped
+            Common::MappedFileDeserializeStream stream(pathString);
+            if (!stream.IsValid()) {
+                return nullptr;
+            }
+            stream.SetZeroCopy(true);
 
             AssetRef<A> result = Common::SharedRef<A>(new A());
             Mirror::Any ref = std::ref(*result.Get());
@@ -406,7 +430,6 @@ namespace Runtime {
 
         std::mutex mutex;
         std::unordered_map<Core::Uri, WeakAssetRef<Asset>> weakAssetRefs;
-        Common::ThreadPool threadPool;
     };
 }
 
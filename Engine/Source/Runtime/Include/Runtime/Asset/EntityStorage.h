@@ -11,7 +11,8 @@ namespace Runtime {
     public:
         EClassBody(EntityStorage)
 
+        // component blobs view the mapped asset file after loading, so they are not copied
         EProperty()
-        std::unordered_map<std::string, std::vector<uint8>> components;
+        std::unordered_map<std::string, Common::SpanView<uint8_t>> components;
     };
 }
@@ -5,17 +5,24 @@
 #pragma once
 
 #include <tuple>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <span>
 
 #include <entt/entt.hpp>
-#include <taskflow/taskflow.hpp>
 
 #include <Common/Utility.h>
 #include <Common/Hash.h>
+#include <Common/HashMap.h>
 #include <Common/String.h>
 #include <Common/Memory.h>
+#include <Core/JobSystem.h>
 #include <Mirror/Meta.h>
 #include <Mirror/Mirror.h>
 #include <Runtime/Api.h>
+#include <Runtime/SystemExecutor.h>
+#include <Runtime/SystemProfiler.h>
 
 #define DeclareSingleCompLifecycleEvent(eventClass) \
     struct EClass() eventClass : public Runtime::Event { \
@@ -67,6 +74,12 @@
 #define DeclareSystemDependencies(...) \
     using Dependencies = std::tuple<__VA_ARGS__>; \
 
+#define DeclareSystemReads(...) \
+    using Reads = std::tuple<__VA_ARGS__>; \
+
+#define DeclareSystemWrites(...) \
+    using Writes = std::tuple<__VA_ARGS__>; \
+
 #define DeclareSetupSystemTypeGetter(systemClass) \
     EFunc() \
     static const Runtime::SystemType& GetSystemType() \
@@ -128,6 +141,11 @@ struct std::hash<Runtime::ClassSignature> {
     }
 };
 
+namespace Runtime {
+    class SystemCommands;
+    struct SystemAccess;
+}
+
 namespace Runtime::Internal {
     template <typename C>
     ClassSignature SignForStaticClass();
@@ -138,11 +156,39 @@ namespace Runtime::Internal {
     template <typename S>
     struct SystemHasDependencies<S, std::void_t<typename S::Dependencies>> : std::true_type {};
 
-    template <typename Dependencies, size_t... I>
-    std::vector<SystemSignature> BuildDependencyListForStaticSystemInternal(std::index_sequence<I...>);
+    template <typename ClassTuple, size_t... I>
+    std::vector<ClassSignature> BuildStaticClassSignatureList(std::index_sequence<I...>);
 
     template <typename S>
     std::vector<SystemSignature> BuildDependencyListForStaticSystem();
+
+    template <typename S>
+    SystemAccess BuildAccessForStaticSystem();
+
+    // stored in a sibling entt storage of C, ticks are ECSHost change ticks
+    template <typename C>
+    struct ComponentTicks {
+        uint64_t added;
+        uint64_t changed;
+    };
+
+    template <typename S, typename C = void>
+    struct SystemHasReads : std::false_type {};
+
+    template <typename S>
+    struct SystemHasReads<S, std::void_t<typename S::Reads>> : std::true_type {};
+
+    template <typename S, typename C = void>
+    struct SystemHasWrites : std::false_type {};
+
+    template <typename S>
+    struct SystemHasWrites<S, std::void_t<typename S::Writes>> : std::true_type {};
+
+    template <typename S, typename E, typename C = void>
+    struct SystemHasBatchReceiver : std::false_type {};
+
+    template <typename S, typename E>
+    struct SystemHasBatchReceiver<S, E, std::void_t<decltype(std::declval<S&>().OnReceiveBatch(std::declval<SystemCommands&>(), std::declval<std::span<const E>>()))>> : std::true_type {};
 }
 
 namespace Runtime {
@@ -198,6 +244,30 @@ namespace Runtime {
         max
     };
 
+    // systems declared reads or writes are ordered by scheduler to avoid data race, others are ordered by dependencies only
+    struct SystemAccess {
+        bool declared = false;
+        std::vector<ClassSignature> reads;
+        std::vector<ClassSignature> writes;
+    };
+
+    enum class StructuralChangeMode : uint8_t {
+        // create/destroy entity and emplace/remove component in systems apply to registry at once
+        immediate,
+        // systems record structural changes into per worker buffers, which are applied after setup/tick graph finished,
+        // created entity ids are taken from a range reserved before graph runs, entities are created in registry at sync point
+        deferred,
+        max
+    };
+
+    enum class EventDispatchMode : uint8_t {
+        // broadcast runs event systems at once
+        immediate,
+        // broadcast queues events per type, queues are dispatched as batches at the end of setup and each tick
+        deferred,
+        max
+    };
+
     struct ComponentType;
     struct StateType;
 
@@ -224,6 +294,16 @@ namespace Runtime {
         template <typename E>
         void BroadcastEvent(const E& event);
 
+        template <typename E>
+        void BroadcastEvents(std::span<const E> events);
+
+        void SetStructuralChangeMode(StructuralChangeMode inMode);
+        StructuralChangeMode GetStructuralChangeMode() const;
+        void SetEventDispatchMode(EventDispatchMode inMode);
+        EventDispatchMode GetEventDispatchMode() const;
+        void FlushEvents();
+        SystemProfiler& GetProfiler();
+
         template <typename P>
         void AddSystemPackage();
 
@@ -237,30 +317,107 @@ namespace Runtime {
         virtual void Shutdown();
         virtual bool Setuped();
 
-        ECSHost() = default;
+        ECSHost();
 
         using SetupProxyFunc = std::function<void(SystemCommands&)>;
         using TickProxyFunc = std::function<void(SystemCommands&, float timeMS)>;
+        // event ref is a std::span<const E>, immediate broadcast is a span with single element
         using OnReceiveProxyFunc = std::function<void(SystemCommands&, Mirror::Any*)>;
 
         struct RUNTIME_API SystemInstance {
             SystemRole type;
             Common::UniqueRef<System> object;
             std::variant<SetupProxyFunc, TickProxyFunc , OnReceiveProxyFunc> proxy;
+            SystemAccess access;
+            // order of adding, ties between systems which are free to run in any order are broken by it
+            uint64_t registrationIndex;
+            // change tick of the last run, filters of Added<C> / Changed<C> compare against it
+            std::atomic<uint64_t> lastRunTick;
 
             SystemInstance();
             ~SystemInstance();
             SystemInstance(SystemInstance&& other) noexcept;
         };
 
+        struct SystemGraph {
+            bool dirty = true;
+            // set before each run, tasks only record timing when profiling
+            bool profiling = false;
+            std::string name;
+            SystemTaskGraph taskGraph;
+            // indexed by task creation order
+            std::vector<SystemRunProfile> runProfiles;
+            std::vector<std::vector<size_t>> predecessors;
+        };
+
+        struct EventSystemGraph : public SystemGraph {
+            // cached graph can only serve one broadcast at a time, nested or concurrent broadcasts use a transient graph
+            std::atomic<bool> running = false;
+            Mirror::Any* eventRef = nullptr;
+        };
+
+        struct EventQueue {
+            virtual ~EventQueue();
+            // returns false if queue is empty
+            virtual bool Dispatch(ECSHost& host) = 0;
+
+            std::mutex mutex;
+        };
+
+        template <typename E>
+        struct TypedEventQueue : public EventQueue {
+            ~TypedEventQueue() override;
+            bool Dispatch(ECSHost& host) override;
+
+            std::vector<E> events;
+        };
+
+        template <typename E>
+        void EnqueueEvent(const E& event);
+
+        using StructuralCommand = std::function<void(SystemCommands&)>;
+
+        void ReserveEntities();
+        Entity TakeReservedEntity();
+        void CreateReservedEntities();
+        void RecordStructuralCommand(StructuralCommand&& command);
+        bool ApplyStructuralCommands();
+        bool DispatchEventQueues();
+        void Sync();
+
+        // createSystemFunc returns the body of a system task, which receives SystemCommands of the system
+        template <typename F>
+        void BuildSystemGraph(SystemGraph& graph, const std::string& name, const Common::FlatHashSet<SystemSignature>& systems, const std::unordered_map<SystemSignature, std::vector<SystemSignature>>& dependencies, F&& createSystemFunc);
+        void RunSystemGraph(SystemGraph& graph);
+        void BroadcastEventInternal(const EventSignature& eventSignature, Mirror::Any& eventRef);
+        std::vector<SystemSignature> SortSystems(const Common::FlatHashSet<SystemSignature>& systems, const std::unordered_map<SystemSignature, std::vector<SystemSignature>>& dependencies) const;
+
         bool setuped;
+        SystemExecutor& executor;
+        float tickTimeMS;
+        SystemGraph setupGraph;
+        SystemGraph tickGraph;
+        SystemProfiler profiler;
+        std::unordered_map<EventSignature, EventSystemGraph> eventGraphs;
+        EventDispatchMode eventDispatchMode;
+        std::mutex eventQueuesMutex;
+        std::unordered_map<EventSignature, Common::UniqueRef<EventQueue>> eventQueues;
+        std::atomic<uint32_t> parallelEachCounter;
+        std::atomic<uint64_t> changeTick;
+        StructuralChangeMode structuralChangeMode;
+        std::vector<std::vector<StructuralCommand>> structuralCommandBuffers;
+        std::mutex externalStructuralCommandMutex;
+        size_t reservedEntityBase;
+        std::atomic<size_t> reservedEntityCursor;
+        uint64_t nextSystemRegistrationIndex;
         entt::registry registry;
-        std::unordered_map<ComponentSignature, const ComponentType*> componentTypes;
-        std::unordered_map<ComponentSignature, const StateType*> stateTypes;
+        Common::FlatHashMap<ComponentSignature, const ComponentType*> componentTypes;
+        Common::FlatHashMap<ComponentSignature, const StateType*> stateTypes;
+        // graph tasks keep references to instances, so this one needs a node based map
         std::unordered_map<SystemSignature, SystemInstance> systemInstances;
-        std::unordered_set<SystemSignature> setupSystems;
-        std::unordered_set<SystemSignature> tickSystems;
-        std::unordered_map<EventSignature, std::unordered_set<SystemSignature>> eventSystems;
+        Common::FlatHashSet<SystemSignature> setupSystems;
+        Common::FlatHashSet<SystemSignature> tickSystems;
+        std::unordered_map<EventSignature, Common::FlatHashSet<SystemSignature>> eventSystems;
         std::unordered_map<SystemSignature, std::vector<SystemSignature>> setupSystemDependencies;
         std::unordered_map<SystemSignature, std::vector<SystemSignature>> tickSystemDependencies;
         std::unordered_map<EventSignature, std::unordered_map<SystemSignature, std::vector<SystemSignature>>> eventSystemDependencies;
@@ -274,8 +431,12 @@ namespace Runtime {
     class Query {
     public:
         using Iterable = typename entt::view<Args...>::iterable_view;
+        using FilterFunc = bool(const entt::registry&, Entity, uint64_t lastRunTick);
+
+        static constexpr size_t defaultGrainSize = 1024;
 
-        explicit Query(entt::view<Args...>&& inView);
+        Query(entt::view<Args...>&& inView, std::atomic<uint32_t>& inParallelEachCounter);
+        Query(entt::view<Args...>&& inView, std::atomic<uint32_t>& inParallelEachCounter, const entt::registry& inRegistry, uint64_t inLastRunTick, std::vector<FilterFunc*>&& inFilters);
         ~Query();
 
         template <typename F>
@@ -283,17 +444,57 @@ namespace Runtime {
 
         auto Each();
 
+        // func is called on job system workers, structural changes (create/destroy entity, emplace/remove component) abort
+        // the process until it returns, func can take (Entity, Components&...) or (Components&...)
+        template <typename F>
+        void ParallelEach(F&& func, size_t grainSize = defaultGrainSize);
+
+        // every chunk accumulates into its own copy of identity by func(T&, Entity, Components&...) or func(T&, Components&...),
+        // then chunk results are combined by reduce in chunk order, so result is stable for same storage layout and grain size
+        template <typename T, typename F, typename R>
+        T ParallelReduce(T identity, F&& func, R&& reduce, size_t grainSize = defaultGrainSize);
+
     private:
+        struct ParallelEachScope {
+            explicit ParallelEachScope(std::atomic<uint32_t>& inCounter);
+            ~ParallelEachScope();
+
+            std::atomic<uint32_t>& counter;
+        };
+
+        template <typename F, typename... Prefix>
+        void InvokeForEntity(F& func, Entity entity, Prefix&... prefix);
+
+        // packed entities of the leading storage, chunks of parallel iteration are index ranges of it
+        std::span<const Entity> GetLeadingEntities() const;
+        bool Match(Entity entity) const;
+        bool PassFilters(Entity entity) const;
+
         entt::view<Args...> view;
+        std::atomic<uint32_t>& parallelEachCounter;
+        const entt::registry* registry;
+        uint64_t lastRunTick;
+        std::vector<FilterFunc*> filters;
     };
 
     template <typename... C>
     struct Exclude {};
 
+    // query filters, an entity passes if C was added / changed (emplace, patch, set, updated) since last run of current system
+    template <typename C>
+    struct Added {
+        static bool Test(const entt::registry& registry, Entity entity, uint64_t lastRunTick);
+    };
+
+    template <typename C>
+    struct Changed {
+        static bool Test(const entt::registry& registry, Entity entity, uint64_t lastRunTick);
+    };
+
     class RUNTIME_API SystemCommands {
     public:
         NonCopyable(SystemCommands)
-        explicit SystemCommands(ECSHost& inHost);
+        explicit SystemCommands(ECSHost& inHost, const SystemAccess* inAccess = nullptr, bool inDeferStructuralChanges = false, uint64_t inLastRunTick = 0);
         ~SystemCommands();
 
         Entity Create(Entity hint = entityNull);
@@ -345,15 +546,39 @@ namespace Runtime {
         template <typename S>
         void RemoveState();
 
-        template <typename... C, typename... E>
-        Query<entt::exclude_t<E...>, C...> StartQuery(Exclude<E...> = {});
+        template <typename... C>
+        Query<entt::exclude_t<>, C...> StartQuery();
+
+        // filters are Added<T> or Changed<T>
+        template <typename... C, typename... E, typename... F>
+        Query<entt::exclude_t<E...>, C...> StartQuery(Exclude<E...>, F... filters);
+
+        // current tick is taken from host on construction, all changes made through this commands are stamped with it,
+        // filters report changes with tick strictly greater than last run tick, which is the current tick of the previous run
+        uint64_t GetCurrentTick() const;
+        uint64_t GetLastRunTick() const;
 
         template <typename E>
         void Broadcast(const E& event);
 
     private:
+        void CheckStructuralChangeAllowed() const;
+
+        template <typename C>
+        void MarkChanged(Entity entity);
+
+        template <typename C>
+        void CheckReadAccess() const;
+
+        template <typename C>
+        void CheckWriteAccess() const;
+
         ECSHost& host;
         entt::registry& registry;
+        const SystemAccess* access;
+        bool deferStructuralChanges;
+        uint64_t currentTick;
+        uint64_t lastRunTick;
     };
 
     struct ComponentType {
@@ -494,12 +719,12 @@ namespace Runtime::Internal {
         return signature;
     }
 
-    template <typename Dependencies, size_t... I>
-    std::vector<SystemSignature> BuildDependencyListForStaticSystemInternal(std::index_sequence<I...>)
+    template <typename ClassTuple, size_t... I>
+    std::vector<ClassSignature> BuildStaticClassSignatureList(std::index_sequence<I...>)
     {
-        std::vector<SystemSignature> result(std::tuple_size_v<Dependencies>);
+        std::vector<ClassSignature> result(std::tuple_size_v<ClassTuple>);
         (void) std::initializer_list<int> { ([&]() -> void {
-            result[I] = Internal::SignForStaticClass<std::tuple_element_t<I, Dependencies>>();
+            result[I] = Internal::SignForStaticClass<std::tuple_element_t<I, ClassTuple>>();
         }(), 0)... };
         return result;
     }
@@ -509,68 +734,85 @@ namespace Runtime::Internal {
     {
         if constexpr (SystemHasDependencies<S>::value) {
             using Dependencies = typename S::Dependencies;
-            return BuildDependencyListForStaticSystemInternal<Dependencies>(std::make_index_sequence<std::tuple_size_v<Dependencies>> {});
+            return BuildStaticClassSignatureList<Dependencies>(std::make_index_sequence<std::tuple_size_v<Dependencies>> {});
         } else {
             return std::vector<SystemSignature> {};
         }
     }
 
+    template <typename S>
+    SystemAccess BuildAccessForStaticSystem()
+    {
+        SystemAccess result;
+        if constexpr (SystemHasReads<S>::value) {
+            using Reads = typename S::Reads;
+            result.declared = true;
+            result.reads = BuildStaticClassSignatureList<Reads>(std::make_index_sequence<std::tuple_size_v<Reads>> {});
+        }
+        if constexpr (SystemHasWrites<S>::value) {
+            using Writes = typename S::Writes;
+            result.declared = true;
+            result.writes = BuildStaticClassSignatureList<Writes>(std::make_index_sequence<std::tuple_size_v<Writes>> {});
+        }
+        return result;
+    }
+
     template <typename SystemTuple, size_t... I>
     void AddSetupSystemPackage(ECSHost& host, std::index_sequence<I...>)
     {
-        std::initializer_list<int> { (0, [&]() -> void { host.AddSetupSystem<std::tuple_element_t<I, SystemTuple>>(); })... };
+        (void) std::initializer_list<int> { ([&]() -> void { host.AddSetupSystem<std::tuple_element_t<I, SystemTuple>>(); }(), 0)... };
     }
 
     template <typename SystemTuple, size_t... I>
     void AddTickSystemPackage(ECSHost& host, std::index_sequence<I...>)
     {
-        std::initializer_list<int> { (0, [&]() -> void { host.AddTickSystem<std::tuple_element_t<I, SystemTuple>>(); })... };
+        (void) std::initializer_list<int> { ([&]() -> void { host.AddTickSystem<std::tuple_element_t<I, SystemTuple>>(); }(), 0)... };
     }
 
     template <typename Event, typename SystemTuple, size_t... I>
     void AddEventSystemPackage(ECSHost& host, std::index_sequence<I...>)
     {
-        std::initializer_list<int> { (0, [&]() -> void { host.AddEventSystem<Event, std::tuple_element_t<I, SystemTuple>>(); })... };
+        (void) std::initializer_list<int> { ([&]() -> void { host.AddEventSystem<Event, std::tuple_element_t<I, SystemTuple>>(); }(), 0)... };
     }
 
     template <typename ESPTuple, size_t... I>
     void AddEventSystemPackageTuple(ECSHost& host, std::index_sequence<I...>)
     {
-        std::initializer_list<int> { (0, [&]() -> void {
+        (void) std::initializer_list<int> { ([&]() -> void {
             using ESP = std::tuple_element_t<I, ESPTuple>;
             using Event = typename ESP::Event;
             using SystemTuple = typename ESP::SystemTuple;
-            AddEventSystemPackage<Event, SystemTuple>(std::make_index_sequence<std::tuple_size_v<SystemTuple>> {});
-        })... };
+            AddEventSystemPackage<Event, SystemTuple>(host, std::make_index_sequence<std::tuple_size_v<SystemTuple>> {});
+        }(), 0)... };
     }
 
     template <typename SystemTuple, size_t... I>
     void RemoveSetupSystemPackage(ECSHost& host, std::index_sequence<I...>)
     {
-        std::initializer_list<int> { (0, [&]() -> void { host.RemoveSetupSystem<std::tuple_element_t<I, SystemTuple>>(); })... };
+        (void) std::initializer_list<int> { ([&]() -> void { host.RemoveSetupSystem<std::tuple_element_t<I, SystemTuple>>(); }(), 0)... };
     }
 
     template <typename SystemTuple, size_t... I>
     void RemoveTickSystemPackage(ECSHost& host, std::index_sequence<I...>)
     {
-        std::initializer_list<int> { (0, [&]() -> void { host.RemoveTickSystem<std::tuple_element_t<I, SystemTuple>>(); })... };
+        (void) std::initializer_list<int> { ([&]() -> void { host.RemoveTickSystem<std::tuple_element_t<I, SystemTuple>>(); }(), 0)... };
     }
 
     template <typename Event, typename SystemTuple, size_t... I>
     void RemoveEventSystemPackage(ECSHost& host, std::index_sequence<I...>)
     {
-        std::initializer_list<int> { (0, [&]() -> void { host.RemoveEventSystem<Event, std::tuple_element_t<I, SystemTuple>>(); })... };
+        (void) std::initializer_list<int> { ([&]() -> void { host.RemoveEventSystem<Event, std::tuple_element_t<I, SystemTuple>>(); }(), 0)... };
     }
 
     template <typename ESPTuple, size_t... I>
     void RemoveEventSystemPackageTuple(ECSHost& host, std::index_sequence<I...>)
     {
-        std::initializer_list<int> { (0, [&]() -> void {
+        (void) std::initializer_list<int> { ([&]() -> void {
             using ESP = std::tuple_element_t<I, ESPTuple>;
             using Event = typename ESP::Event;
             using SystemTuple = typename ESP::SystemTuple;
-            RemoveEventSystemPackage<Event, SystemTuple>(std::make_index_sequence<std::tuple_size_v<SystemTuple>> {});
-        })... };
+            RemoveEventSystemPackage<Event, SystemTuple>(host, std::make_index_sequence<std::tuple_size_v<SystemTuple>> {});
+        }(), 0)... };
     }
 
     template <typename C>
@@ -625,6 +867,8 @@ namespace Runtime {
         SystemInstance instance;
         instance.type = SystemRole::setup;
         instance.object = object;
+        instance.access = Internal::BuildAccessForStaticSystem<S>();
+        instance.registrationIndex = nextSystemRegistrationIndex++;
         instance.proxy = [object](SystemCommands& commands) -> void {
             object->Setup(commands);
         };
@@ -632,6 +876,7 @@ namespace Runtime {
         systemInstances.emplace(std::make_pair(signature, std::move(instance)));
         setupSystems.emplace(signature);
         setupSystemDependencies.emplace(std::make_pair(signature, Internal::BuildDependencyListForStaticSystem<S>()));
+        setupGraph.dirty = true;
     }
 
     template <typename S>
@@ -644,6 +889,8 @@ namespace Runtime {
         SystemInstance instance;
         instance.type = SystemRole::tick;
         instance.object = object;
+        instance.access = Internal::BuildAccessForStaticSystem<S>();
+        instance.registrationIndex = nextSystemRegistrationIndex++;
         instance.proxy = [object](SystemCommands& commands, float timeMS) -> void {
             object->Tick(commands, timeMS);
         };
@@ -651,6 +898,7 @@ namespace Runtime {
         systemInstances.emplace(std::make_pair(signature, std::move(instance)));
         tickSystems.emplace(signature);
         tickSystemDependencies.emplace(std::make_pair(signature, Internal::BuildDependencyListForStaticSystem<S>()));
+        tickGraph.dirty = true;
     }
 
     template <typename E, typename S>
@@ -658,8 +906,9 @@ namespace Runtime {
     {
         EventSignature eventSignature = Internal::SignForStaticClass<E>();
         if (!eventSystems.contains(eventSignature)) {
-            eventSystems.emplace(std::make_pair(eventSignature, std::unordered_set<SystemSignature> {}));
+            eventSystems.emplace(std::make_pair(eventSignature, Common::FlatHashSet<SystemSignature> {}));
             eventSystemDependencies.emplace(std::make_pair(eventSignature, std::unordered_map<SystemSignature, std::vector<SystemSignature>> {}));
+            eventGraphs.try_emplace(eventSignature);
         }
 
         auto& systems = eventSystems.at(eventSignature);
@@ -671,13 +920,23 @@ namespace Runtime {
         SystemInstance instance;
         instance.type = SystemRole::event;
         instance.object = object;
+        instance.access = Internal::BuildAccessForStaticSystem<S>();
+        instance.registrationIndex = nextSystemRegistrationIndex++;
         instance.proxy = [object](SystemCommands& commands, Mirror::Any* eventRef) -> void {
-            object->OnReceive(commands, eventRef->As<const E&>());
+            const auto& events = eventRef->As<const std::span<const E>&>();
+            if constexpr (Internal::SystemHasBatchReceiver<S, E>::value) {
+                object->OnReceiveBatch(commands, events);
+            } else {
+                for (const auto& event : events) {
+                    object->OnReceive(commands, event);
+                }
+            }
         };
 
         systemInstances.emplace(std::make_pair(systemSignature, std::move(instance)));
         systems.emplace(systemSignature);
         systemDependencies.emplace(std::make_pair(systemSignature, Internal::BuildDependencyListForStaticSystem<S>()));
+        eventGraphs.at(eventSignature).dirty = true;
     }
 
     template <typename S>
@@ -687,6 +946,7 @@ namespace Runtime {
         systemInstances.erase(signature);
         setupSystems.erase(signature);
         setupSystemDependencies.erase(signature);
+        setupGraph.dirty = true;
     }
 
     template <typename S>
@@ -696,6 +956,7 @@ namespace Runtime {
         systemInstances.erase(signature);
         tickSystems.erase(signature);
         tickSystemDependencies.erase(signature);
+        tickGraph.dirty = true;
     }
 
     template <typename E, typename S>
@@ -711,75 +972,109 @@ namespace Runtime {
         systemInstances.erase(systemSignature);
         systems.erase(systemSignature);
         systemDependencies.erase(systemSignature);
+        eventGraphs.at(eventSignature).dirty = true;
     }
 
     template <typename E>
     void ECSHost::BroadcastEvent(const E& event)
+    {
+        BroadcastEvents<E>(std::span<const E>(&event, 1));
+    }
+
+    template <typename E>
+    void ECSHost::BroadcastEvents(std::span<const E> events)
     {
         EventSignature eventSignature = Internal::SignForStaticClass<E>();
-        if (!eventSystems.contains(eventSignature)) {
+        if (events.empty() || !eventSystems.contains(eventSignature)) {
             return;
         }
 
-        const auto& systems = eventSystems.at(eventSignature);
-        const auto& systemDependencies = eventSystemDependencies.at(eventSignature);
-
-        tf::Taskflow taskflow;
-        std::unordered_map<SystemSignature, tf::Task> tasks;
-        tasks.reserve(systems.size());
-
-        SystemCommands systemCommands(*this);
-        Mirror::Any eventRef = std::ref(event);
-
-        for (const auto& system : systems) {
-            const auto& systemInstance = systemInstances.at(system);
-            Assert(systemInstance.type == SystemRole::event);
+        Mirror::Any eventRef = std::ref(events);
+        BroadcastEventInternal(eventSignature, eventRef);
+    }
 
-            tasks.emplace(std::make_pair(system, taskflow.emplace([&]() -> void {
-                std::get<OnReceiveProxyFunc>(systemInstance.proxy)(systemCommands, &eventRef);
-            })));
+    template <typename E>
+    void ECSHost::EnqueueEvent(const E& event)
+    {
+        EventSignature eventSignature = Internal::SignForStaticClass<E>();
+        if (!eventSystems.contains(eventSignature)) {
+            return;
         }
 
-        for (const auto& dependencies : systemDependencies) {
-            auto& task = tasks.at(dependencies.first);
-            for (const auto& depend : dependencies.second) {
-                task.succeed(tasks.at(depend));
+        EventQueue* queue;
+        {
+            std::unique_lock<std::mutex> lock(eventQueuesMutex);
+            auto iter = eventQueues.find(eventSignature);
+            if (iter == eventQueues.end()) {
+                iter = eventQueues.emplace(std::make_pair(eventSignature, Common::UniqueRef<EventQueue>(new TypedEventQueue<E>()))).first;
             }
+            queue = iter->second.Get();
         }
 
-        tf::Executor executor;
-        executor.run(taskflow);
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        static_cast<TypedEventQueue<E>*>(queue)->events.emplace_back(event);
+    }
+
+    template <typename E>
+    ECSHost::TypedEventQueue<E>::~TypedEventQueue() = default;
+
+    template <typename E>
+    bool ECSHost::TypedEventQueue<E>::Dispatch(ECSHost& host)
+    {
+        std::vector<E> pendingEvents;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            pendingEvents.swap(events);
+        }
+        if (pendingEvents.empty()) {
+            return false;
+        }
+        host.BroadcastEvents<E>(std::span<const E>(pendingEvents));
+        return true;
     }
 
     template <typename P>
     void ECSHost::AddSystemPackage()
     {
         using SetupSystemTuple = typename P::Setup::SystemTuple;
-        Internal::AddSetupSystemPackage<SetupSystemTuple>(std::make_index_sequence<std::tuple_size_v<SetupSystemTuple>> {});
+        Internal::AddSetupSystemPackage<SetupSystemTuple>(*this, std::make_index_sequence<std::tuple_size_v<SetupSystemTuple>> {});
 
         using TickSystemTuple = typename P::Tick::SystemTuple;
-        Internal::AddTickSystemPackage<TickSystemTuple>(std::make_index_sequence<std::tuple_size_v<TickSystemTuple>> {});
+        Internal::AddTickSystemPackage<TickSystemTuple>(*this, std::make_index_sequence<std::tuple_size_v<TickSystemTuple>> {});
 
         using ESPTuple = typename P::EventSystemPackageTuple;
-        Internal::AddEventSystemPackageTuple<ESPTuple>(std::make_index_sequence<std::tuple_size_v<ESPTuple>> {});
+        Internal::AddEventSystemPackageTuple<ESPTuple>(*this, std::make_index_sequence<std::tuple_size_v<ESPTuple>> {});
     }
 
     template <typename P>
     void ECSHost::RemoveSystemPackage()
     {
         using SetupSystemTuple = typename P::Setup::SystemTuple;
-        Internal::RemoveSetupSystemPackage<SetupSystemTuple>(std::make_index_sequence<std::tuple_size_v<SetupSystemTuple>> {});
+        Internal::RemoveSetupSystemPackage<SetupSystemTuple>(*this, std::make_index_sequence<std::tuple_size_v<SetupSystemTuple>> {});
 
         using TickSystemTuple = typename P::Tick::SystemTuple;
-        Internal::RemoveTickSystemPackage<TickSystemTuple>(std::make_index_sequence<std::tuple_size_v<TickSystemTuple>> {});
+        Internal::RemoveTickSystemPackage<TickSystemTuple>(*this, std::make_index_sequence<std::tuple_size_v<TickSystemTuple>> {});
 
         using ESPTuple = typename P::EventSystemPackageTuple;
-        Internal::RemoveEventSystemPackageTuple<ESPTuple>(std::make_index_sequence<std::tuple_size_v<ESPTuple>> {});
+        Internal::RemoveEventSystemPackageTuple<ESPTuple>(*this, std::make_index_sequence<std::tuple_size_v<ESPTuple>> {});
+    }
+
+    template <typename... Args>
+    Query<Args...>::Query(entt::view<Args...>&& inView, std::atomic<uint32_t>& inParallelEachCounter)
+        : view(std::move(inView))
+        , parallelEachCounter(inParallelEachCounter)
+        , registry(nullptr)
+        , lastRunTick(0)
+    {
     }
 
     template <typename... Args>
-    Query<Args...>::Query(entt::view<Args...>&& inView)
+    Query<Args...>::Query(entt::view<Args...>&& inView, std::atomic<uint32_t>& inParallelEachCounter, const entt::registry& inRegistry, uint64_t inLastRunTick, std::vector<FilterFunc*>&& inFilters)
         : view(std::move(inView))
+        , parallelEachCounter(inParallelEachCounter)
+        , registry(&inRegistry)
+        , lastRunTick(inLastRunTick)
+        , filters(std::move(inFilters))
     {
     }
 
@@ -790,15 +1085,138 @@ namespace Runtime {
     template <typename F>
     void Query<Args...>::Each(F&& func)
     {
-        view.each(std::forward<F>(func));
+        if (filters.empty()) {
+            view.each(std::forward<F>(func));
+            return;
+        }
+
+        view.each([&](Entity entity, auto&&... components) -> void {
+            if (!PassFilters(entity)) {
+                return;
+            }
+            if constexpr (std::is_invocable_v<F&, Entity, decltype(components)...>) {
+                func(entity, components...);
+            } else {
+                func(components...);
+            }
+        });
     }
 
     template <typename... Args>
     auto Query<Args...>::Each()
     {
+        AssertWithReason(filters.empty(), "iterable of query ignores filters, use Each(func) instead");
         return view.each();
     }
 
+    template <typename... Args>
+    template <typename F>
+    void Query<Args...>::ParallelEach(F&& func, size_t grainSize)
+    {
+        const std::span<const Entity> entities = GetLeadingEntities();
+
+        ParallelEachScope scope(parallelEachCounter);
+        Core::JobSystem::Get().ParallelFor(entities.size(), grainSize, [&](size_t begin, size_t end) -> void {
+            for (auto i = begin; i < end; i++) {
+                if (Match(entities[i])) {
+                    InvokeForEntity(func, entities[i]);
+                }
+            }
+        });
+    }
+
+    template <typename... Args>
+    template <typename T, typename F, typename R>
+    T Query<Args...>::ParallelReduce(T identity, F&& func, R&& reduce, size_t grainSize)
+    {
+        const std::span<const Entity> entities = GetLeadingEntities();
+
+        ParallelEachScope scope(parallelEachCounter);
+        return Core::JobSystem::Get().ParallelReduce(
+            entities.size(),
+            grainSize,
+            identity,
+            [&](size_t begin, size_t end) -> T {
+                T chunkResult = identity;
+                for (auto i = begin; i < end; i++) {
+                    if (Match(entities[i])) {
+                        InvokeForEntity(func, entities[i], chunkResult);
+                    }
+                }
+                return chunkResult;
+            },
+            std::forward<R>(reduce));
+    }
+
+    template <typename... Args>
+    Query<Args...>::ParallelEachScope::ParallelEachScope(std::atomic<uint32_t>& inCounter)
+        : counter(inCounter)
+    {
+        counter++;
+    }
+
+    template <typename... Args>
+    Query<Args...>::ParallelEachScope::~ParallelEachScope()
+    {
+        counter--;
+    }
+
+    template <typename... Args>
+    template <typename F, typename... Prefix>
+    void Query<Args...>::InvokeForEntity(F& func, Entity entity, Prefix&... prefix)
+    {
+        std::apply([&](auto&&... components) -> void {
+            if constexpr (std::is_invocable_v<F&, Prefix&..., Entity, decltype(components)...>) {
+                func(prefix..., entity, components...);
+            } else {
+                func(prefix..., components...);
+            }
+        }, view.get(entity));
+    }
+
+    template <typename... Args>
+    std::span<const Entity> Query<Args...>::GetLeadingEntities() const
+    {
+        // single component views expose their storage directly, multi component views through the smallest storage they iterate
+        if constexpr (requires { view.handle(); }) {
+            const auto& storage = view.handle();
+            return { storage.data(), storage.size() };
+        } else {
+            return { view.data(), view.size() };
+        }
+    }
+
+    template <typename... Args>
+    bool Query<Args...>::Match(Entity entity) const
+    {
+        return view.contains(entity) && PassFilters(entity);
+    }
+
+    template <typename... Args>
+    bool Query<Args...>::PassFilters(Entity entity) const
+    {
+        for (auto* filter : filters) {
+            if (!filter(*registry, entity, lastRunTick)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename C>
+    bool Added<C>::Test(const entt::registry& registry, Entity entity, uint64_t lastRunTick)
+    {
+        const auto* ticks = registry.try_get<Internal::ComponentTicks<C>>(entity);
+        return ticks != nullptr && ticks->added > lastRunTick;
+    }
+
+    template <typename C>
+    bool Changed<C>::Test(const entt::registry& registry, Entity entity, uint64_t lastRunTick)
+    {
+        const auto* ticks = registry.try_get<Internal::ComponentTicks<C>>(entity);
+        return ticks != nullptr && ticks->changed > lastRunTick;
+    }
+
     template <typename F>
     void SystemCommands::Each(F&& func)
     {
@@ -808,6 +1226,15 @@ namespace Runtime {
     template <typename C, typename... Args>
     void SystemCommands::Emplace(Entity entity, Args&&... args)
     {
+        CheckWriteAccess<C>();
+        if (deferStructuralChanges) {
+            host.RecordStructuralCommand([entity, component = C(std::forward<Args>(args)...)](SystemCommands& commands) mutable -> void {
+                commands.Emplace<C>(entity, std::move(component));
+            });
+            return;
+        }
+
+        CheckStructuralChangeAllowed();
         if (const ComponentSignature signature = Internal::SignForStaticClass<C>();
             !host.componentTypes.contains(signature)) {
             auto* systemType = CompTypeFinder::FromCompClassName(signature.name);
@@ -815,12 +1242,14 @@ namespace Runtime {
             host.componentTypes.emplace(std::make_pair(signature, systemType));
         }
         registry.emplace<C>(entity, std::forward<Args>(args)...);
+        registry.emplace_or_replace<Internal::ComponentTicks<C>>(entity, currentTick, currentTick);
         Broadcast(typename C::Added { {}, entity });
     }
 
     template <typename C>
     C* SystemCommands::Get(Entity entity)
     {
+        CheckReadAccess<C>();
         return registry.try_get<C>(entity);
     }
 
@@ -833,33 +1262,49 @@ namespace Runtime {
     template <typename C, typename F>
     void SystemCommands::Patch(Entity entity, F&& patchFunc)
     {
+        CheckWriteAccess<C>();
         registry.patch<C>(entity, patchFunc);
+        MarkChanged<C>(entity);
         Broadcast(typename C::Updated { {}, entity });
     }
 
     template <typename C, typename... Args>
     void SystemCommands::Set(Entity entity, Args&&... args)
     {
+        CheckWriteAccess<C>();
         registry.replace<C>(entity, std::forward<Args>(args)...);
+        MarkChanged<C>(entity);
         Broadcast(typename C::Updated { {}, entity });
     }
 
     template <typename C>
     void SystemCommands::Updated(Runtime::Entity entity)
     {
+        CheckWriteAccess<C>();
+        MarkChanged<C>(entity);
         Broadcast(typename C::Updated { {}, entity });
     }
 
     template <typename C>
     void SystemCommands::Remove(Runtime::Entity entity)
     {
-        registry.remove<C>(entity);
+        CheckWriteAccess<C>();
+        if (deferStructuralChanges) {
+            host.RecordStructuralCommand([entity](SystemCommands& commands) -> void {
+                commands.Remove<C>(entity);
+            });
+            return;
+        }
+
+        CheckStructuralChangeAllowed();
+        registry.remove<C, Internal::ComponentTicks<C>>(entity);
         Broadcast(typename C::Removed { {}, entity });
     }
 
     template <typename S, typename ...Args>
     void SystemCommands::EmplaceState(Args&& ...args)
     {
+        CheckWriteAccess<S>();
         StateSignature signature = Internal::SignForStaticClass<S>();
         auto iter = host.states.find(signature);
         Assert(iter == host.states.end());
@@ -870,6 +1315,7 @@ namespace Runtime {
     template <typename S>
     S* SystemCommands::GetState()
     {
+        CheckReadAccess<S>();
         StateSignature signature = Internal::SignForStaticClass<S>();
         auto iter = host.states.find(signature);
         if (iter == host.states.end()) {
@@ -888,6 +1334,7 @@ namespace Runtime {
     template <typename S, typename F>
     void SystemCommands::PatchState(F&& patchFunc)
     {
+        CheckWriteAccess<S>();
         StateSignature signature = Internal::SignForStaticClass<S>();
         auto iter = host.states.find(signature);
         Assert(iter != host.states.end());
@@ -898,6 +1345,7 @@ namespace Runtime {
     template <typename S, typename ...Args>
     void SystemCommands::SetState(Args&& ...args)
     {
+        CheckWriteAccess<S>();
         StateSignature signature = Internal::SignForStaticClass<S>();
         auto iter = host.states.find(signature);
         Assert(iter != host.states.end());
@@ -908,12 +1356,14 @@ namespace Runtime {
     template <typename S>
     void SystemCommands::UpdatedState()
     {
+        CheckWriteAccess<S>();
         Broadcast(typename S::Updated {});
     }
 
     template <typename S>
     void SystemCommands::RemoveState()
     {
+        CheckWriteAccess<S>();
         StateSignature signature = Internal::SignForStaticClass<S>();
         auto iter = host.states.find(signature);
         Assert(iter != host.states.end());
@@ -921,16 +1371,67 @@ namespace Runtime {
         Broadcast(typename S::Removed {});
     }
 
-    template <typename... C, typename... E>
-    Query<entt::exclude_t<E...>, C...> SystemCommands::StartQuery(Exclude<E...>)
+    template <typename... C>
+    Query<entt::exclude_t<>, C...> SystemCommands::StartQuery()
     {
-        return Query<entt::exclude_t<E...>, C...>(registry.view<C...>(entt::exclude_t<E...> {}));
+        return StartQuery<C...>(Exclude<> {});
+    }
+
+    template <typename... C, typename... E, typename... F>
+    Query<entt::exclude_t<E...>, C...> SystemCommands::StartQuery(Exclude<E...>, F... filters)
+    {
+        (void) std::initializer_list<int> { (CheckReadAccess<C>(), 0)... };
+        if constexpr (sizeof...(F) == 0) {
+            return Query<entt::exclude_t<E...>, C...>(registry.view<C...>(entt::exclude_t<E...> {}), host.parallelEachCounter);
+        } else {
+            using QueryType = Query<entt::exclude_t<E...>, C...>;
+            return QueryType(registry.view<C...>(entt::exclude_t<E...> {}), host.parallelEachCounter, registry, lastRunTick, std::vector<typename QueryType::FilterFunc*> { &F::Test... });
+        }
+    }
+
+    template <typename C>
+    void SystemCommands::MarkChanged(Entity entity)
+    {
+        if (auto* ticks = registry.try_get<Internal::ComponentTicks<C>>(entity); ticks != nullptr) {
+            ticks->changed = currentTick;
+        }
     }
 
     template <typename E>
     void SystemCommands::Broadcast(const E& event)
     {
-        host.BroadcastEvent<E>(event);
+        if (host.eventDispatchMode == EventDispatchMode::deferred) {
+            host.EnqueueEvent<E>(event);
+        } else {
+            host.BroadcastEvent<E>(event);
+        }
+    }
+
+    template <typename C>
+    void SystemCommands::CheckReadAccess() const
+    {
+#if BUILD_CONFIG_DEBUG
+        if (access == nullptr || !access->declared) {
+            return;
+        }
+        const ClassSignature signature = Internal::SignForStaticClass<std::remove_cv_t<C>>();
+        const bool declared = std::find(access->reads.begin(), access->reads.end(), signature) != access->reads.end()
+            || std::find(access->writes.begin(), access->writes.end(), signature) != access->writes.end();
+        AssertWithReason(declared, "system accessed " + signature.name + " without declaring it in DeclareSystemReads() or DeclareSystemWrites()");
+#endif
+    }
+
+    template <typename C>
+    void SystemCommands::CheckWriteAccess() const
+    {
+#if BUILD_CONFIG_DEBUG
+        if (access == nullptr || !access->declared) {
+            return;
+        }
+        const ClassSignature signature = Internal::SignForStaticClass<std::remove_cv_t<C>>();
+        const bool declared = std::find(access->writes.begin(), access->writes.end(), signature) != access->writes.end();
+        AssertWithReason(declared, "system modified " + signature.name + " without declaring it in DeclareSystemWrites()");
+#endif
     }
 
     template <typename C>
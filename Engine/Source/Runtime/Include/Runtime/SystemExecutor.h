@@ -0,0 +1,61 @@
+//
+// Created by johnk on 2023/10/16.
+//
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+#include <Common/Utility.h>
+#include <Core/JobSystem.h>
+#include <Runtime/Api.h>
+
+namespace Runtime {
+    // dependency graph of tasks, built once and run many times
+    class RUNTIME_API SystemTaskGraph {
+    public:
+        SystemTaskGraph();
+        ~SystemTaskGraph();
+
+        // returns index of the new task
+        size_t Emplace(std::function<void()> func);
+        // to runs only after from finished
+        void AddEdge(size_t from, size_t to);
+        void Clear();
+        bool Empty() const;
+
+    private:
+        friend class SystemExecutor;
+
+        struct Node {
+            std::function<void()> func;
+            std::vector<size_t> successors;
+            uint32_t predecessorNum = 0;
+        };
+
+        std::vector<Node> nodes;
+    };
+
+    // runs system graphs on the process wide job system, so systems share workers with all other engine jobs,
+    // worker number and core affinities are configured by Core::JobSystem::Configure()
+    class RUNTIME_API SystemExecutor {
+    public:
+        static SystemExecutor& Get();
+
+        NonCopyable(SystemExecutor)
+        ~SystemExecutor();
+
+        // blocks until graph finished, the calling thread executes jobs in the meantime, so it is safe to call in a system (e.g. broadcast event)
+        void Run(const SystemTaskGraph& graph);
+        size_t GetThreadNum() const;
+        // returns worker id in [0, GetThreadNum()) on workers of the job system, GetThreadNum() on any other thread
+        size_t GetCurrentWorkerSlot() const;
+
+    private:
+        SystemExecutor();
+
+        Common::JobSystem& jobSystem;
+    };
+}
@@ -0,0 +1,70 @@
+//
+// Created by johnk on 2023/10/16.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <Common/Utility.h>
+#include <Runtime/Api.h>
+
+namespace Runtime {
+    struct SystemRunProfile {
+        std::string name;
+        // worker slot of SystemExecutor, SystemExecutor::GetThreadNum() means a non-worker thread
+        size_t workerSlot = 0;
+        // all time points are nanoseconds since profiler created
+        uint64_t startNS = 0;
+        uint64_t endNS = 0;
+        // time between all dependencies (or the graph) finished and system started
+        uint64_t waitNS = 0;
+        bool onCriticalPath = false;
+    };
+
+    struct SystemGraphProfile {
+        // "Setup", "Tick" or "Event:<event class name>"
+        std::string name;
+        size_t workerSlot = 0;
+        uint64_t startNS = 0;
+        uint64_t endNS = 0;
+        // sum of system wall time along the critical path, the lower bound of graph time with unlimited workers
+        uint64_t criticalPathNS = 0;
+        std::vector<SystemRunProfile> systems;
+    };
+
+    class RUNTIME_API SystemProfiler {
+    public:
+        static constexpr size_t defaultMaxGraphProfiles = 1024;
+
+        SystemProfiler();
+        ~SystemProfiler();
+        NonCopyable(SystemProfiler)
+
+        void SetEnabled(bool inEnabled);
+        bool IsEnabled() const;
+        // oldest profiles are dropped once exceeded, 0 means unlimited
+        void SetMaxGraphProfiles(size_t inMaxGraphProfiles);
+        uint64_t Now() const;
+        // predecessors[i] are indices of systems which systems[i] depends on, wait time and critical path are derived from them
+        void Submit(SystemGraphProfile&& profile, const std::vector<std::vector<size_t>>& predecessors);
+        std::vector<SystemGraphProfile> GetGraphProfiles() const;
+        void Clear();
+        // chrome://tracing or perfetto json format
+        std::string DumpChromeTrace() const;
+        void DumpChromeTrace(const std::string& fileName) const;
+
+    private:
+        std::chrono::steady_clock::time_point epoch;
+        std::atomic<bool> enabled;
+        mutable std::mutex mutex;
+        size_t maxGraphProfiles;
+        std::deque<SystemGraphProfile> graphProfiles;
+    };
+}
@@ -13,7 +13,6 @@ namespace Runtime {
 
     AssetManager::AssetManager()
         : weakAssetRefs()
-        , threadPool("AssetThreadPool", 4)
     {
     }
 
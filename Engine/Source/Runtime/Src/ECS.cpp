@@ -2,7 +2,11 @@
 // Created by johnk on 2023/9/5.
 //
 
+#include <map>
+#include <cstdlib>
+
 #include <Runtime/ECS.h>
+#include <Common/Container.h>
 
 namespace Runtime {
     bool ClassSignature::operator==(const ClassSignature& rhs) const
@@ -10,9 +14,13 @@ namespace Runtime {
         return id == rhs.id;
     }
 
-    SystemCommands::SystemCommands(ECSHost& inHost)
-        : registry(inHost.registry)
-        , host(inHost)
+    SystemCommands::SystemCommands(ECSHost& inHost, const SystemAccess* inAccess, bool inDeferStructuralChanges, uint64_t inLastRunTick)
+        : host(inHost)
+        , registry(inHost.registry)
+        , access(inAccess)
+        , deferStructuralChanges(inDeferStructuralChanges)
+        , currentTick(++inHost.changeTick)
+        , lastRunTick(inLastRunTick)
     {
     }
 
@@ -20,11 +28,26 @@ namespace Runtime {
 
     Entity SystemCommands::Create(Entity hint)
     {
-        return registry.create(hint);
+        if (deferStructuralChanges) {
+            return host.TakeReservedEntity();
+        }
+        CheckStructuralChangeAllowed();
+        // ids handed out from the reserved range must exist before the registry allocates new ones
+        host.CreateReservedEntities();
+        const Entity entity = registry.create(hint);
+        host.ReserveEntities();
+        return entity;
     }
 
     void SystemCommands::Destroy(Entity inEntity)
     {
+        if (deferStructuralChanges) {
+            host.RecordStructuralCommand([inEntity](SystemCommands& commands) -> void {
+                commands.Destroy(inEntity);
+            });
+            return;
+        }
+        CheckStructuralChangeAllowed();
         registry.destroy(inEntity);
     }
 
@@ -33,9 +56,171 @@ namespace Runtime {
         return registry.valid(inEntity);
     }
 
+    uint64_t SystemCommands::GetCurrentTick() const
+    {
+        return currentTick;
+    }
+
+    uint64_t SystemCommands::GetLastRunTick() const
+    {
+        return lastRunTick;
+    }
+
+    void SystemCommands::CheckStructuralChangeAllowed() const
+    {
+        // parallel iteration walks storages without locks, a structural change would invalidate them, so this fails in all builds
+        if (host.parallelEachCounter.load() != 0) {
+            AssertWithReason(false, "structural changes are not allowed during Query::ParallelEach()");
+            std::abort();
+        }
+    }
+
+    ECSHost::ECSHost()
+        : setuped(false)
+        , executor(SystemExecutor::Get())
+        , tickTimeMS(0.0f)
+        , eventDispatchMode(EventDispatchMode::immediate)
+        , parallelEachCounter(0)
+        , changeTick(0)
+        , structuralChangeMode(StructuralChangeMode::immediate)
+        , structuralCommandBuffers(executor.GetThreadNum() + 1)
+        , reservedEntityBase(0)
+        , reservedEntityCursor(0)
+        , nextSystemRegistrationIndex(0)
+    {
+    }
+
+    void ECSHost::SetStructuralChangeMode(StructuralChangeMode inMode)
+    {
+        structuralChangeMode = inMode;
+    }
+
+    StructuralChangeMode ECSHost::GetStructuralChangeMode() const
+    {
+        return structuralChangeMode;
+    }
+
+    void ECSHost::ReserveEntities()
+    {
+        // only ids are reserved, registry is not touched until sync point, ids at or after registry size are never in use
+        Assert(reservedEntityCursor.load() == 0);
+        reservedEntityBase = registry.size();
+    }
+
+    Entity ECSHost::TakeReservedEntity()
+    {
+        const size_t index = reservedEntityBase + reservedEntityCursor.fetch_add(1);
+        return static_cast<Entity>(static_cast<entt::id_type>(index));
+    }
+
+    void ECSHost::CreateReservedEntities()
+    {
+        const size_t takenNum = reservedEntityCursor.exchange(0);
+        for (size_t i = 0; i < takenNum; i++) {
+            const auto reserved = static_cast<Entity>(static_cast<entt::id_type>(reservedEntityBase + i));
+            const Entity entity = registry.create(reserved);
+            Assert(entity == reserved);
+        }
+        ReserveEntities();
+    }
+
+    void ECSHost::RecordStructuralCommand(StructuralCommand&& command)
+    {
+        // every worker owns a buffer, so recording is lock free, threads outside executor share the last one
+        const size_t slot = executor.GetCurrentWorkerSlot();
+        if (slot < executor.GetThreadNum()) {
+            structuralCommandBuffers[slot].emplace_back(std::move(command));
+            return;
+        }
+        std::unique_lock<std::mutex> lock(externalStructuralCommandMutex);
+        structuralCommandBuffers[slot].emplace_back(std::move(command));
+    }
+
+    bool ECSHost::ApplyStructuralCommands()
+    {
+        // commands may refer to entities taken from reserved range, so create them first
+        CreateReservedEntities();
+
+        bool applied = false;
+        SystemCommands systemCommands(*this);
+        std::vector<StructuralCommand> commands;
+        for (size_t i = 0; i < structuralCommandBuffers.size(); i++) {
+            // applying may trigger event systems which record new commands, so take the buffer out first
+            commands.clear();
+            if (i == executor.GetThreadNum()) {
+                std::unique_lock<std::mutex> lock(externalStructuralCommandMutex);
+                commands.swap(structuralCommandBuffers[i]);
+            } else {
+                commands.swap(structuralCommandBuffers[i]);
+            }
+            for (auto& command : commands) {
+                command(systemCommands);
+            }
+            applied = applied || !commands.empty();
+        }
+        return applied;
+    }
+
+    void ECSHost::Sync()
+    {
+        bool pending = true;
+        while (pending) {
+            pending = ApplyStructuralCommands();
+            if (eventDispatchMode == EventDispatchMode::deferred) {
+                pending = DispatchEventQueues() || pending;
+            }
+        }
+    }
+
+    ECSHost::EventQueue::~EventQueue() = default;
+
+    void ECSHost::SetEventDispatchMode(EventDispatchMode inMode)
+    {
+        if (eventDispatchMode == EventDispatchMode::deferred && inMode != EventDispatchMode::deferred) {
+            FlushEvents();
+        }
+        eventDispatchMode = inMode;
+    }
+
+    EventDispatchMode ECSHost::GetEventDispatchMode() const
+    {
+        return eventDispatchMode;
+    }
+
+    SystemProfiler& ECSHost::GetProfiler()
+    {
+        return profiler;
+    }
+
+    void ECSHost::FlushEvents()
+    {
+        // event systems may queue new events while dispatching, so keep flushing until all queues drained
+        while (DispatchEventQueues()) {}
+    }
+
+    bool ECSHost::DispatchEventQueues()
+    {
+        std::vector<EventQueue*> queues;
+        {
+            std::unique_lock<std::mutex> lock(eventQueuesMutex);
+            queues.reserve(eventQueues.size());
+            for (const auto& [signature, queue] : eventQueues) {
+                queues.emplace_back(queue.Get());
+            }
+        }
+
+        bool dispatched = false;
+        for (auto* queue : queues) {
+            dispatched = queue->Dispatch(*this) || dispatched;
+        }
+        return dispatched;
+    }
+
     ECSHost::SystemInstance::SystemInstance()
         : type(SystemRole::max)
         , object(nullptr)
+        , registrationIndex(0)
+        , lastRunTick(0)
     {
     }
 
@@ -45,16 +230,31 @@ namespace Runtime {
         : type(other.type)
         , object(std::move(other.object))
         , proxy(std::move(other.proxy))
+        , access(std::move(other.access))
+        , registrationIndex(other.registrationIndex)
+        , lastRunTick(other.lastRunTick.load())
     {
     }
 
     void ECSHost::Reset()
     {
         setuped = false;
+        setupGraph.dirty = true;
+        setupGraph.taskGraph.Clear();
+        tickGraph.dirty = true;
+        tickGraph.taskGraph.Clear();
+        eventGraphs.clear();
+        eventQueues.clear();
+        for (auto& buffer : structuralCommandBuffers) {
+            buffer.clear();
+        }
+        reservedEntityBase = 0;
+        reservedEntityCursor.store(0);
         registry = entt::registry();
         componentTypes.clear();
         stateTypes.clear();
         systemInstances.clear();
+        nextSystemRegistrationIndex = 0;
         setupSystems.clear();
         tickSystems.clear();
         eventSystems.clear();
@@ -64,62 +264,231 @@ namespace Runtime {
         states.clear();
     }
 
-    void ECSHost::Setup()
+    template <typename F>
+    void ECSHost::BuildSystemGraph(SystemGraph& graph, const std::string& name, const Common::FlatHashSet<SystemSignature>& systems, const std::unordered_map<SystemSignature, std::vector<SystemSignature>>& dependencies, F&& createSystemFunc)
     {
-        setuped = true;
+        graph.name = name;
+        graph.taskGraph.Clear();
+        graph.runProfiles.clear();
+        graph.runProfiles.reserve(systems.size());
+        graph.predecessors.clear();
+        graph.predecessors.resize(systems.size());
 
-        tf::Taskflow taskflow;
-        std::unordered_map<SystemSignature, tf::Task> tasks;
-        tasks.reserve(setupSystems.size());
+        Common::FlatHashMap<SystemSignature, size_t> tasks;
+        tasks.reserve(systems.size());
+        for (const auto& system : systems) {
+            auto& systemInstance = systemInstances.at(system);
+            const size_t index = graph.runProfiles.size();
+            graph.runProfiles.emplace_back().name = system.name;
 
-        SystemCommands systemCommands(*this);
-        for (const auto& system : setupSystems) {
-            const auto& systemInstance = systemInstances.at(system);
-            Assert(systemInstance.type == SystemRole::setup);
+            graph.taskGraph.Emplace([this, &graph, &systemInstance, index, func = createSystemFunc(systemInstance)]() -> void {
+                const bool profiling = graph.profiling;
+                const uint64_t startNS = profiling ? profiler.Now() : 0;
+
+                SystemCommands systemCommands(*this, &systemInstance.access, structuralChangeMode == StructuralChangeMode::deferred, systemInstance.lastRunTick.load());
+                func(systemCommands);
+                // own writes are not reported again, systems ordered before or after this one by declared access take smaller or greater ticks
+                systemInstance.lastRunTick.store(systemCommands.GetCurrentTick());
 
-            tasks.emplace(std::make_pair(system, taskflow.emplace([&]() -> void {
-                std::get<SetupProxyFunc>(systemInstance.proxy)(systemCommands);
-            })));
+                if (profiling) {
+                    auto& runProfile = graph.runProfiles[index];
+                    runProfile.workerSlot = executor.GetCurrentWorkerSlot();
+                    runProfile.startNS = startNS;
+                    runProfile.endNS = profiler.Now();
+                }
+            });
+            tasks.emplace(std::make_pair(system, index));
         }
 
-        for (const auto& dependencies : setupSystemDependencies) {
-            auto& task = tasks.at(dependencies.first);
-            for (const auto& depend : dependencies.second) {
-                task.succeed(tasks.at(depend));
+        // one bit row per task, indexed by task creation order, so duplicated edges are rejected by a bit test
+        std::vector<Common::DynamicBitset> predecessors(systems.size(), Common::DynamicBitset(systems.size()));
+        auto addEdge = [&](const SystemSignature& from, const SystemSignature& to) -> void {
+            if (from == to) {
+                return;
+            }
+            const size_t toIndex = tasks.at(to);
+            const size_t fromIndex = tasks.at(from);
+            if (predecessors[toIndex].Test(fromIndex)) {
+                return;
+            }
+            predecessors[toIndex].Set(fromIndex);
+            graph.taskGraph.AddEdge(fromIndex, toIndex);
+            graph.predecessors[toIndex].emplace_back(fromIndex);
+        };
+
+        for (const auto& dependency : dependencies) {
+            for (const auto& depend : dependency.second) {
+                addEdge(depend, dependency.first);
             }
         }
 
-        tf::Executor executor;
-        executor.run(taskflow);
+        // walk systems in a stable order which respects explicit dependencies, a system waits for the last writer of everything
+        // it touches, and a writer also waits for all readers since the last write, so readers of same data still run in parallel
+        Common::FlatHashMap<ClassSignature, SystemSignature> lastWriters;
+        Common::FlatHashMap<ClassSignature, std::vector<SystemSignature>> lastReaders;
+        for (const auto& system : SortSystems(systems, dependencies)) {
+            const auto& access = systemInstances.at(system).access;
+            if (!access.declared) {
+                continue;
+            }
+
+            for (const auto& read : access.reads) {
+                if (auto iter = lastWriters.find(read); iter != lastWriters.end()) {
+                    addEdge(iter->second, system);
+                }
+                lastReaders[read].emplace_back(system);
+            }
+            for (const auto& write : access.writes) {
+                if (auto iter = lastWriters.find(write); iter != lastWriters.end()) {
+                    addEdge(iter->second, system);
+                }
+                if (auto iter = lastReaders.find(write); iter != lastReaders.end()) {
+                    for (const auto& reader : iter->second) {
+                        addEdge(reader, system);
+                    }
+                    iter->second.clear();
+                }
+                lastWriters[write] = system;
+            }
+        }
     }
 
-    void ECSHost::Tick(float timeMS)
+    std::vector<SystemSignature> ECSHost::SortSystems(const Common::FlatHashSet<SystemSignature>& systems, const std::unordered_map<SystemSignature, std::vector<SystemSignature>>& dependencies) const
     {
-        Assert(setuped);
+        Common::FlatHashMap<SystemSignature, size_t> inDegrees;
+        Common::FlatHashMap<SystemSignature, std::vector<SystemSignature>> successors;
+        inDegrees.reserve(systems.size());
+        for (const auto& system : systems) {
+            inDegrees.emplace(std::make_pair(system, 0));
+        }
+        for (const auto& dependency : dependencies) {
+            for (const auto& depend : dependency.second) {
+                inDegrees.at(dependency.first)++;
+                successors[depend].emplace_back(dependency.first);
+            }
+        }
+
+        // ready systems are picked in registration order, so the derived order follows the order systems are added in,
+        // and does not depend on hash map iteration
+        std::map<uint64_t, SystemSignature> readySystems;
+        for (const auto& [system, inDegree] : inDegrees) {
+            if (inDegree == 0) {
+                readySystems.emplace(std::make_pair(systemInstances.at(system).registrationIndex, system));
+            }
+        }
 
-        tf::Taskflow taskflow;
-        std::unordered_map<SystemSignature, tf::Task> tasks;
-        tasks.reserve(tickSystems.size());
+        std::vector<SystemSignature> result;
+        result.reserve(systems.size());
+        while (!readySystems.empty()) {
+            auto system = std::move(readySystems.begin()->second);
+            readySystems.erase(readySystems.begin());
 
-        SystemCommands systemCommands(*this);
-        for (const auto& system : tickSystems) {
-            const auto& systemInstance = systemInstances.at(system);
-            Assert(systemInstance.type == SystemRole::tick);
+            if (auto iter = successors.find(system); iter != successors.end()) {
+                for (const auto& successor : iter->second) {
+                    if (--inDegrees.at(successor) == 0) {
+                        readySystems.emplace(std::make_pair(systemInstances.at(successor).registrationIndex, successor));
+                    }
+                }
+            }
+            result.emplace_back(std::move(system));
+        }
+        AssertWithReason(result.size() == systems.size(), "system dependencies have cycle");
+        return result;
+    }
 
-            tasks.emplace(std::make_pair(system, taskflow.emplace([&]() -> void {
-                std::get<TickProxyFunc >(systemInstance.proxy)(systemCommands, timeMS);
-            })));
+    void ECSHost::RunSystemGraph(SystemGraph& graph)
+    {
+        graph.profiling = profiler.IsEnabled();
+        if (!graph.profiling) {
+            executor.Run(graph.taskGraph);
+            return;
         }
 
-        for (const auto& dependencies : tickSystemDependencies) {
-            auto& task = tasks.at(dependencies.first);
-            for (const auto& depend : dependencies.second) {
-                task.succeed(tasks.at(depend));
-            }
+        SystemGraphProfile profile;
+        profile.name = graph.name;
+        profile.workerSlot = executor.GetCurrentWorkerSlot();
+        profile.startNS = profiler.Now();
+        executor.Run(graph.taskGraph);
+        profile.endNS = profiler.Now();
+        profile.systems = graph.runProfiles;
+        profiler.Submit(std::move(profile), graph.predecessors);
+    }
+
+    void ECSHost::BroadcastEventInternal(const EventSignature& eventSignature, Mirror::Any& eventRef)
+    {
+        const auto& systems = eventSystems.at(eventSignature);
+        const auto& systemDependencies = eventSystemDependencies.at(eventSignature);
+
+        auto& graph = eventGraphs.at(eventSignature);
+        if (graph.running.exchange(true)) {
+            SystemGraph transientGraph;
+            BuildSystemGraph(transientGraph, "Event:" + eventSignature.name, systems, systemDependencies, [&eventRef](SystemInstance& systemInstance) {
+                Assert(systemInstance.type == SystemRole::event);
+                return [&systemInstance, &eventRef](SystemCommands& systemCommands) -> void {
+                    std::get<OnReceiveProxyFunc>(systemInstance.proxy)(systemCommands, &eventRef);
+                };
+            });
+            RunSystemGraph(transientGraph);
+            return;
+        }
+
+        if (graph.dirty) {
+            BuildSystemGraph(graph, "Event:" + eventSignature.name, systems, systemDependencies, [&graph](SystemInstance& systemInstance) {
+                Assert(systemInstance.type == SystemRole::event);
+                return [&systemInstance, &graph](SystemCommands& systemCommands) -> void {
+                    std::get<OnReceiveProxyFunc>(systemInstance.proxy)(systemCommands, graph.eventRef);
+                };
+            });
+            graph.dirty = false;
+        }
+
+        graph.eventRef = &eventRef;
+        RunSystemGraph(graph);
+        graph.eventRef = nullptr;
+        graph.running.store(false);
+    }
+
+    void ECSHost::Setup()
+    {
+        setuped = true;
+
+        if (setupGraph.dirty) {
+            BuildSystemGraph(setupGraph, "Setup", setupSystems, setupSystemDependencies, [](SystemInstance& systemInstance) {
+                Assert(systemInstance.type == SystemRole::setup);
+                return [&systemInstance](SystemCommands& systemCommands) -> void {
+                    std::get<SetupProxyFunc>(systemInstance.proxy)(systemCommands);
+                };
+            });
+            setupGraph.dirty = false;
         }
+        if (structuralChangeMode == StructuralChangeMode::deferred) {
+            // ids taken by broadcasts outside of graphs are created here, then a new range is reserved
+            CreateReservedEntities();
+        }
+        RunSystemGraph(setupGraph);
+        Sync();
+    }
 
-        tf::Executor executor;
-        executor.run(taskflow);
+    void ECSHost::Tick(float timeMS)
+    {
+        Assert(setuped);
+
+        if (tickGraph.dirty) {
+            BuildSystemGraph(tickGraph, "Tick", tickSystems, tickSystemDependencies, [this](SystemInstance& systemInstance) {
+                Assert(systemInstance.type == SystemRole::tick);
+                return [this, &systemInstance](SystemCommands& systemCommands) -> void {
+                    std::get<TickProxyFunc>(systemInstance.proxy)(systemCommands, tickTimeMS);
+                };
+            });
+            tickGraph.dirty = false;
+        }
+
+        tickTimeMS = timeMS;
+        if (structuralChangeMode == StructuralChangeMode::deferred) {
+            CreateReservedEntities();
+        }
+        RunSystemGraph(tickGraph);
+        Sync();
     }
 
     void ECSHost::Shutdown()
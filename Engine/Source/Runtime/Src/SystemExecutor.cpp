@@ -0,0 +1,94 @@
+//
+// Created by johnk on 2023/10/16.
+//
+
+#include <atomic>
+#include <memory>
+
+#include <Runtime/SystemExecutor.h>
+#include <Common/Debug.h>
+
+namespace Runtime {
+    SystemTaskGraph::SystemTaskGraph() = default;
+
+    SystemTaskGraph::~SystemTaskGraph() = default;
+
+    size_t SystemTaskGraph::Emplace(std::function<void()> func)
+    {
+        nodes.emplace_back().func = std::move(func);
+        return nodes.size() - 1;
+    }
+
+    void SystemTaskGraph::AddEdge(size_t from, size_t to)
+    {
+        Assert(from < nodes.size() && to < nodes.size() && from != to);
+        nodes[from].successors.emplace_back(to);
+        nodes[to].predecessorNum++;
+    }
+
+    void SystemTaskGraph::Clear()
+    {
+        nodes.clear();
+    }
+
+    bool SystemTaskGraph::Empty() const
+    {
+        return nodes.empty();
+    }
+
+    SystemExecutor& SystemExecutor::Get()
+    {
+        static SystemExecutor instance;
+        return instance;
+    }
+
+    SystemExecutor::SystemExecutor()
+        : jobSystem(Core::JobSystem::Get())
+    {
+    }
+
+    SystemExecutor::~SystemExecutor() = default;
+
+    void SystemExecutor::Run(const SystemTaskGraph& graph)
+    {
+        if (graph.Empty()) {
+            return;
+        }
+
+        // per run state, so the same graph can be run again right after, or concurrently by nested broadcasts of a transient graph
+        const auto& nodes = graph.nodes;
+        const auto pendingPredecessors = std::make_unique<std::atomic<uint32_t>[]>(nodes.size());
+        for (size_t i = 0; i < nodes.size(); i++) {
+            pendingPredecessors[i].store(nodes[i].predecessorNum);
+        }
+
+        // successors are scheduled before the job finishes, so counter can not reach zero while the graph still has work
+        Common::JobCounter counter;
+        std::function<void(size_t)> schedule = [&](size_t index) -> void {
+            jobSystem.Schedule([&, index]() -> void {
+                nodes[index].func();
+                for (const size_t successor : nodes[index].successors) {
+                    if (pendingPredecessors[successor].fetch_sub(1) == 1) {
+                        schedule(successor);
+                    }
+                }
+            }, &counter);
+        };
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i].predecessorNum == 0) {
+                schedule(i);
+            }
+        }
+        jobSystem.Wait(counter);
+    }
+
+    size_t SystemExecutor::GetThreadNum() const
+    {
+        return jobSystem.GetThreadNum();
+    }
+
+    size_t SystemExecutor::GetCurrentWorkerSlot() const
+    {
+        return jobSystem.GetCurrentWorkerSlot();
+    }
+}
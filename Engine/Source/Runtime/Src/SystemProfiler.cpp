@@ -0,0 +1,161 @@
+//
+// Created by johnk on 2023/10/16.
+//
+
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+
+#include <Runtime/SystemProfiler.h>
+#include <Common/Debug.h>
+
+namespace Runtime::Internal {
+    static void WriteJsonString(std::ostringstream& stream, const std::string& str)
+    {
+        stream << '"';
+        for (const char c : str) {
+            if (c == '"' || c == '\\') {
+                stream << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<uint32_t>(c) << std::dec;
+            } else {
+                stream << c;
+            }
+        }
+        stream << '"';
+    }
+
+    // trace format takes microseconds, write them as exact fixed point numbers from nanoseconds
+    static void WriteMicroseconds(std::ostringstream& stream, uint64_t ns)
+    {
+        stream << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000;
+    }
+
+    static void WriteTraceEvent(std::ostringstream& stream, const std::string& name, const char* category, size_t tid, uint64_t startNS, uint64_t endNS)
+    {
+        stream << R"({"name":)";
+        WriteJsonString(stream, name);
+        stream << R"(,"cat":")" << category << R"(","ph":"X","pid":0,"tid":)" << tid
+            << R"(,"ts":)";
+        WriteMicroseconds(stream, startNS);
+        stream << R"(,"dur":)";
+        WriteMicroseconds(stream, endNS - startNS);
+    }
+}
+
+namespace Runtime {
+    SystemProfiler::SystemProfiler()
+        : epoch(std::chrono::steady_clock::now())
+        , enabled(false)
+        , maxGraphProfiles(defaultMaxGraphProfiles)
+    {
+    }
+
+    SystemProfiler::~SystemProfiler() = default;
+
+    void SystemProfiler::SetEnabled(bool inEnabled)
+    {
+        enabled.store(inEnabled);
+    }
+
+    bool SystemProfiler::IsEnabled() const
+    {
+        return enabled.load();
+    }
+
+    void SystemProfiler::SetMaxGraphProfiles(size_t inMaxGraphProfiles)
+    {
+        std::unique_lock lock(mutex);
+        maxGraphProfiles = inMaxGraphProfiles;
+        while (maxGraphProfiles != 0 && graphProfiles.size() > maxGraphProfiles) {
+            graphProfiles.pop_front();
+        }
+    }
+
+    uint64_t SystemProfiler::Now() const
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    void SystemProfiler::Submit(SystemGraphProfile&& profile, const std::vector<std::vector<size_t>>& predecessors)
+    {
+        auto& systems = profile.systems;
+        Assert(systems.size() == predecessors.size());
+
+        static constexpr size_t invalidIndex = SIZE_MAX;
+        std::vector<size_t> criticalPredecessors(systems.size(), invalidIndex);
+        size_t lastFinished = invalidIndex;
+        for (size_t i = 0; i < systems.size(); i++) {
+            uint64_t readyNS = profile.startNS;
+            for (const size_t predecessor : predecessors[i]) {
+                if (systems[predecessor].endNS >= readyNS) {
+                    readyNS = systems[predecessor].endNS;
+                    criticalPredecessors[i] = predecessor;
+                }
+            }
+            systems[i].waitNS = systems[i].startNS > readyNS ? systems[i].startNS - readyNS : 0;
+
+            if (lastFinished == invalidIndex || systems[i].endNS > systems[lastFinished].endNS) {
+                lastFinished = i;
+            }
+        }
+
+        // the critical path ends at the system which finished last, and walks back through the predecessor which unblocked it
+        profile.criticalPathNS = 0;
+        for (size_t i = lastFinished; i != invalidIndex; i = criticalPredecessors[i]) {
+            systems[i].onCriticalPath = true;
+            profile.criticalPathNS += systems[i].endNS - systems[i].startNS;
+        }
+
+        std::unique_lock lock(mutex);
+        graphProfiles.emplace_back(std::move(profile));
+        if (maxGraphProfiles != 0 && graphProfiles.size() > maxGraphProfiles) {
+            graphProfiles.pop_front();
+        }
+    }
+
+    std::vector<SystemGraphProfile> SystemProfiler::GetGraphProfiles() const
+    {
+        std::unique_lock lock(mutex);
+        return { graphProfiles.begin(), graphProfiles.end() };
+    }
+
+    void SystemProfiler::Clear()
+    {
+        std::unique_lock lock(mutex);
+        graphProfiles.clear();
+    }
+
+    std::string SystemProfiler::DumpChromeTrace() const
+    {
+        std::ostringstream stream;
+        stream << R"({"displayTimeUnit":"ns","traceEvents":[)";
+
+        std::unique_lock lock(mutex);
+        bool first = true;
+        for (const auto& graph : graphProfiles) {
+            stream << (first ? "" : ",");
+            first = false;
+            Internal::WriteTraceEvent(stream, graph.name, "graph", graph.workerSlot, graph.startNS, graph.endNS);
+            stream << R"(,"args":{"criticalPathUS":)" << static_cast<double>(graph.criticalPathNS) / 1000.0 << "}}";
+
+            for (const auto& system : graph.systems) {
+                stream << ",";
+                Internal::WriteTraceEvent(stream, system.name, "system", system.workerSlot, system.startNS, system.endNS);
+                stream << R"(,"args":{"graph":)";
+                Internal::WriteJsonString(stream, graph.name);
+                stream << R"(,"waitUS":)" << static_cast<double>(system.waitNS) / 1000.0
+                    << R"(,"criticalPath":)" << (system.onCriticalPath ? "true" : "false") << "}}";
+            }
+        }
+        stream << "]}";
+        return stream.str();
+    }
+
+    void SystemProfiler::DumpChromeTrace(const std::string& fileName) const
+    {
+        std::ofstream file(fileName, std::ios::binary);
+        Assert(file.is_open());
+        file << DumpChromeTrace();
+    }
+}
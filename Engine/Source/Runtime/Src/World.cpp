@@ -2,8 +2,6 @@
 // Created by johnk on 2023/9/5.
 //
 
-#include <taskflow/taskflow.hpp>
-
 #include <Runtime/World.h>
 
 namespace Runtime {
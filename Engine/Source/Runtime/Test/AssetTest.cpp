@@ -45,7 +45,7 @@ TEST(AssetTest, SaveLoadTest)
     static Core::Uri uri("asset://Engine/Test/Generated/AssetTest.SaveLoadTest");
 
     AssetRef<TestAsset> asset = MakeShared<TestAsset>(uri, 1, "hello");
-    AssetManager::Get().Save(asset);
+    ASSERT_TRUE(AssetManager::Get().Save(asset));
 
     AssetRef<TestAsset> restore = AssetManager::Get().SyncLoad<TestAsset>(uri);
     ASSERT_EQ(restore.Uri(), uri);
@@ -58,7 +58,7 @@ TEST(AssetTest, AsyncLoadTest)
     static Core::Uri uri("asset://Engine/Test/Generated/AssetTest.SaveLoadTest");
 
     AssetRef<TestAsset> asset = MakeShared<TestAsset>(uri, 1, "hello");
-    AssetManager::Get().Save(asset);
+    ASSERT_TRUE(AssetManager::Get().Save(asset));
 
     AssetManager::Get().AsyncLoad<TestAsset>(uri, [&](AssetRef<TestAsset> restore) -> void {
         ASSERT_EQ(restore.Uri(), uri);
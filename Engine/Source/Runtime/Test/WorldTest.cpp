@@ -2,8 +2,28 @@
 // Created by johnk on 2023/9/20.
 //
 
+#include <chrono>
+
 #include <WorldTest.h>
 
+template <typename P>
+static double MeasureTickOverheadUS(uint32_t tickNum)
+{
+    World world;
+    world.AddSystemPackage<P>();
+    world.Setup();
+    // first tick builds the cached graph
+    world.Tick(0.01f);
+
+    const auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < tickNum; i++) {
+        world.Tick(0.01f);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    world.Shutdown();
+    return std::chrono::duration<double, std::micro>(end - begin).count() / tickNum;
+}
+
 TEST(WorldTest, BasicTest)
 {
     World world;
@@ -71,6 +91,29 @@ TEST(WorldTest, SystemScheduleTest)
     world.Shutdown();
 }
 
+TEST(WorldTest, SystemPackageTest)
+{
+    using Package = SystemPackage<
+        SetupSystemPackage<SystemScheduleTest_WorldSetupSystem>,
+        TickSystemPackage<SystemScheduleTest_System1, SystemScheduleTest_System2, SystemScheduleTest_System3>>;
+
+    World world;
+    world.AddSystemPackage<Package>();
+    world.Setup();
+    world.Tick(0.01f);
+
+    SystemCommands commands(world);
+
+    ASSERT_TRUE(commands.HasState<SystemScheduleTest_Context>());
+    const auto* context = commands.GetState<SystemScheduleTest_Context>();
+    ASSERT_TRUE(context->system1Executed);
+    ASSERT_TRUE(context->system2Executed);
+    ASSERT_TRUE(context->system3Executed);
+
+    world.Shutdown();
+    world.RemoveSystemPackage<Package>();
+}
+
 TEST(WorldTest, EventTest)
 {
     World world;
@@ -101,6 +144,241 @@ TEST(WorldTest, CustomEventTest)
     world.Shutdown();
 }
 
+TEST(WorldTest, DeferredEventTest)
+{
+    World world;
+    world.SetEventDispatchMode(EventDispatchMode::deferred);
+    world.AddSetupSystem<DeferredEventTest_WorldSetupSystem>();
+    world.AddEventSystem<DeferredEventTest_Component::Added, DeferredEventTest_OnComponentAddedSystem>();
+    world.Setup();
+
+    SystemCommands commands(world);
+
+    const auto* context = commands.GetState<DeferredEventTest_Context>();
+    ASSERT_EQ(context->receivedEventNum, 16);
+    ASSERT_EQ(context->receivedBatchNum, 1);
+
+    world.Shutdown();
+}
+
+TEST(WorldTest, SystemAccessTest)
+{
+    {
+        World world;
+        world.AddSetupSystem<SystemAccessTest_WorldSetupSystem>();
+        world.AddTickSystem<SystemAccessTest_System1>();
+        world.AddTickSystem<SystemAccessTest_System2>();
+        world.Setup();
+
+        SystemCommands commands(world);
+        for (auto i = 1; i <= 10; i++) {
+            world.Tick(0.01f);
+            // no explicit dependency, system1 writes context, system2 reads it, so they are serialized in registration order
+            ASSERT_EQ(commands.GetState<SystemAccessTest_Result>()->observedValue, i);
+        }
+        world.Shutdown();
+    }
+
+    {
+        World world;
+        world.AddSetupSystem<SystemAccessTest_WorldSetupSystem>();
+        world.AddTickSystem<SystemAccessTest_System2>();
+        world.AddTickSystem<SystemAccessTest_System1>();
+        world.Setup();
+
+        SystemCommands commands(world);
+        for (auto i = 1; i <= 10; i++) {
+            world.Tick(0.01f);
+            // reader is registered first, so it observes the value written by the previous tick
+            ASSERT_EQ(commands.GetState<SystemAccessTest_Result>()->observedValue, i - 1);
+        }
+        world.Shutdown();
+    }
+}
+
+TEST(WorldTest, ParallelQueryTest)
+{
+    World world;
+    world.Setup();
+
+    SystemCommands commands(world);
+    for (auto i = 0; i < 4096; i++) {
+        Entity entity = commands.Create();
+        commands.Emplace<BasicTest_Position>(entity, BasicTest_Position { {}, static_cast<float>(i), 0.0f, 0.0f });
+        commands.Emplace<BasicTest_Velocity>(entity, BasicTest_Velocity { {}, 1.0f, 1.0f, 1.0f });
+    }
+
+    auto query = commands.StartQuery<BasicTest_Position, BasicTest_Velocity>();
+    query.ParallelEach([](BasicTest_Position& position, BasicTest_Velocity& velocity) -> void {
+        position.x += velocity.x;
+    }, 64);
+
+    const float sum = query.ParallelReduce(
+        0.0f,
+        [](float& result, Entity entity, BasicTest_Position& position, BasicTest_Velocity& velocity) -> void {
+            result += position.x;
+        },
+        [](float lhs, float rhs) -> float {
+            return lhs + rhs;
+        },
+        64);
+    ASSERT_EQ(sum, 4096.0f * 4097.0f / 2.0f);
+
+    world.Shutdown();
+}
+
+TEST(WorldTest, DeferredStructuralChangeTest)
+{
+    World world;
+    world.SetStructuralChangeMode(StructuralChangeMode::deferred);
+    world.AddTickSystem<StructuralChangeTest_SpawnSystem1>();
+    world.AddTickSystem<StructuralChangeTest_SpawnSystem2>();
+    world.Setup();
+
+    SystemCommands commands(world);
+    for (auto i = 1; i <= 3; i++) {
+        world.Tick(0.01f);
+
+        uint32_t spawnedBySystem1 = 0;
+        uint32_t spawnedBySystem2 = 0;
+        commands.StartQuery<StructuralChangeTest_Marker>().Each([&](StructuralChangeTest_Marker& marker) -> void {
+            spawnedBySystem1 += marker.spawner == 1 ? 1 : 0;
+            spawnedBySystem2 += marker.spawner == 2 ? 1 : 0;
+        });
+        ASSERT_EQ(spawnedBySystem1, 100 * i);
+        ASSERT_EQ(spawnedBySystem2, 100 * i);
+
+        // reserved ids that are not taken never become entities
+        uint32_t entityNum = 0;
+        commands.Each([&](Entity) -> void {
+            entityNum++;
+        });
+        ASSERT_EQ(entityNum, 200 * i + (i - 1));
+
+        // entities created outside of graphs must not collide with ids reserved for the next tick
+        const Entity entity = commands.Create();
+        ASSERT_FALSE(commands.Has<StructuralChangeTest_Marker>(entity));
+    }
+
+    world.Shutdown();
+}
+
+TEST(WorldTest, ChangeDetectionTest)
+{
+    World world;
+    world.AddSetupSystem<ChangeDetectionTest_WorldSetupSystem>();
+    world.AddTickSystem<ChangeDetectionTest_CountSystem>();
+    world.Setup();
+
+    SystemCommands commands(world);
+    const auto* context = commands.GetState<ChangeDetectionTest_Context>();
+
+    world.Tick(0.01f);
+    ASSERT_EQ(context->addedCount, 10);
+    ASSERT_EQ(context->changedCount, 10);
+
+    world.Tick(0.01f);
+    ASSERT_EQ(context->addedCount, 0);
+    ASSERT_EQ(context->changedCount, 0);
+
+    std::vector<Entity> entities;
+    commands.StartQuery<ChangeDetectionTest_Component>().Each([&](Entity entity, ChangeDetectionTest_Component&) -> void {
+        entities.emplace_back(entity);
+    });
+    SystemCommands patchCommands(world);
+    patchCommands.Patch<ChangeDetectionTest_Component>(entities[0], [](ChangeDetectionTest_Component& component) -> void {
+        component.value = 100;
+    });
+    world.Tick(0.01f);
+    ASSERT_EQ(context->addedCount, 0);
+    ASSERT_EQ(context->changedCount, 1);
+
+    world.Shutdown();
+}
+
+TEST(WorldTest, ChangeDetectionOrderTest)
+{
+    World world;
+    world.AddSetupSystem<ChangeDetectionTest_WorldSetupSystem>();
+    world.AddTickSystem<ChangeDetectionTest_OrderedCountSystem>();
+    world.AddTickSystem<ChangeDetectionTest_OrderedPatchSystem>();
+    world.Setup();
+
+    SystemCommands commands(world);
+    const auto* result = commands.GetState<ChangeDetectionTest_OrderedResult>();
+
+    // first tick sees components added in setup, later ticks see patches made after count system ran in previous tick
+    for (auto i = 0; i < 3; i++) {
+        world.Tick(0.01f);
+        ASSERT_EQ(result->changedCount, 10);
+    }
+
+    world.Shutdown();
+}
+
+TEST(WorldTest, ChangeDetectionSelfPatchTest)
+{
+    World world;
+    world.AddSetupSystem<ChangeDetectionTest_WorldSetupSystem>();
+    world.AddTickSystem<ChangeDetectionTest_SelfPatchSystem>();
+    world.Setup();
+
+    SystemCommands commands(world);
+    const auto* result = commands.GetState<ChangeDetectionTest_OrderedResult>();
+
+    // first tick sees components added in setup and patches them, later ticks see nothing
+    world.Tick(0.01f);
+    ASSERT_EQ(result->changedCount, 10);
+    for (auto i = 0; i < 3; i++) {
+        world.Tick(0.01f);
+        ASSERT_EQ(result->changedCount, 0);
+    }
+
+    world.Shutdown();
+}
+
+TEST(WorldTest, SystemProfilerTest)
+{
+    World world;
+    world.GetProfiler().SetEnabled(true);
+    world.AddSetupSystem<SystemAccessTest_WorldSetupSystem>();
+    world.AddTickSystem<SystemAccessTest_System2>();
+    world.AddTickSystem<SystemAccessTest_System1>();
+    world.Setup();
+    world.Tick(0.01f);
+    world.Shutdown();
+
+    const auto profiles = world.GetProfiler().GetGraphProfiles();
+    ASSERT_EQ(profiles.size(), 2);
+    ASSERT_EQ(profiles[0].name, "Setup");
+    ASSERT_EQ(profiles[1].name, "Tick");
+
+    const auto& tickProfile = profiles[1];
+    ASSERT_EQ(tickProfile.systems.size(), 2);
+    for (const auto& system : tickProfile.systems) {
+        // system1 -> system2 is the only chain, so both are on critical path
+        ASSERT_TRUE(system.onCriticalPath);
+        ASSERT_GE(system.startNS, tickProfile.startNS);
+        ASSERT_LE(system.endNS, tickProfile.endNS);
+    }
+    ASSERT_LE(tickProfile.criticalPathNS, tickProfile.endNS - tickProfile.startNS);
+
+    const std::string trace = world.GetProfiler().DumpChromeTrace();
+    ASSERT_NE(trace.find("traceEvents"), std::string::npos);
+    ASSERT_NE(trace.find("SystemAccessTest_System1"), std::string::npos);
+    ASSERT_NE(trace.find("SystemAccessTest_System2"), std::string::npos);
+    // timestamps are fixed point microseconds, never scientific notation
+    ASSERT_EQ(trace.find("e+"), std::string::npos);
+}
+
+TEST(WorldTest, TickOverheadBenchmarkTest)
+{
+    constexpr uint32_t tickNum = 1000;
+    RecordProperty("tickUS_0Systems", std::to_string(MeasureTickOverheadUS<TickBenchmark_Package0>(tickNum)));
+    RecordProperty("tickUS_10Systems", std::to_string(MeasureTickOverheadUS<TickBenchmark_Package10>(tickNum)));
+    RecordProperty("tickUS_100Systems", std::to_string(MeasureTickOverheadUS<TickBenchmark_Package100>(tickNum)));
+}
+
 TEST(WorldTest, ModuleTest)
 {
     auto* module = ModuleManager::Get().FindOrLoadTyped<RuntimeModule>("Runtime");
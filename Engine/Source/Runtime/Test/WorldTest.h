@@ -360,3 +360,264 @@ struct EClass() CustomEventTest_CustomEventSystem : public System {
         ASSERT_EQ(event.value, 1);
     }
 };
+
+struct EClass() DeferredEventTest_Context : public State {
+    EStateBody(DeferredEventTest_Context)
+
+    uint32_t receivedEventNum;
+    uint32_t receivedBatchNum;
+};
+
+struct EClass() DeferredEventTest_Component : public Component {
+    EComponentBody(DeferredEventTest_Component)
+
+    int placeholder;
+};
+
+struct EClass() DeferredEventTest_WorldSetupSystem : public System {
+    ESetupSystemBody(DeferredEventTest_WorldSetupSystem)
+
+    void Setup(SystemCommands& commands)
+    {
+        commands.EmplaceState<DeferredEventTest_Context>(DeferredEventTest_Context { {}, 0, 0 });
+        for (auto i = 0; i < 16; i++) {
+            commands.Emplace<DeferredEventTest_Component>(commands.Create(), DeferredEventTest_Component { {}, i });
+        }
+    }
+};
+
+struct EClass() DeferredEventTest_OnComponentAddedSystem : public System {
+    EEventSystemBody(DeferredEventTest_OnComponentAddedSystem, DeferredEventTest_Component::Added)
+
+    void OnReceiveBatch(SystemCommands& commands, std::span<const DeferredEventTest_Component::Added> events)
+    {
+        auto* context = commands.GetState<DeferredEventTest_Context>();
+        context->receivedEventNum += events.size();
+        context->receivedBatchNum++;
+    }
+};
+
+struct EClass() SystemAccessTest_Context : public State {
+    EStateBody(SystemAccessTest_Context)
+
+    int32_t value;
+};
+
+struct EClass() SystemAccessTest_Result : public State {
+    EStateBody(SystemAccessTest_Result)
+
+    int32_t observedValue;
+};
+
+struct EClass() SystemAccessTest_WorldSetupSystem : public System {
+    ESetupSystemBody(SystemAccessTest_WorldSetupSystem)
+
+    void Setup(SystemCommands& commands)
+    {
+        commands.EmplaceState<SystemAccessTest_Context>(SystemAccessTest_Context { {}, 0 });
+        commands.EmplaceState<SystemAccessTest_Result>(SystemAccessTest_Result { {}, 0 });
+    }
+};
+
+struct EClass() SystemAccessTest_System1 : public System {
+    ETickSystemBody(SystemAccessTest_System1)
+    DeclareSystemWrites(SystemAccessTest_Context)
+
+    void Tick(SystemCommands& commands, float timeMS)
+    {
+        commands.PatchState<SystemAccessTest_Context>([](SystemAccessTest_Context& context) -> void {
+            context.value++;
+        });
+    }
+};
+
+struct EClass() SystemAccessTest_System2 : public System {
+    ETickSystemBody(SystemAccessTest_System2)
+    DeclareSystemReads(SystemAccessTest_Context)
+    DeclareSystemWrites(SystemAccessTest_Result)
+
+    void Tick(SystemCommands& commands, float timeMS)
+    {
+        const int32_t value = commands.GetState<SystemAccessTest_Context>()->value;
+        commands.PatchState<SystemAccessTest_Result>([value](SystemAccessTest_Result& result) -> void {
+            result.observedValue = value;
+        });
+    }
+};
+
+struct EClass() StructuralChangeTest_Marker : public Component {
+    EComponentBody(StructuralChangeTest_Marker)
+
+    int32_t spawner;
+};
+
+struct EClass() StructuralChangeTest_SpawnSystem1 : public System {
+    ETickSystemBody(StructuralChangeTest_SpawnSystem1)
+
+    void Tick(SystemCommands& commands, float timeMS)
+    {
+        for (auto i = 0; i < 100; i++) {
+            commands.Emplace<StructuralChangeTest_Marker>(commands.Create(), StructuralChangeTest_Marker { {}, 1 });
+        }
+    }
+};
+
+struct EClass() StructuralChangeTest_SpawnSystem2 : public System {
+    ETickSystemBody(StructuralChangeTest_SpawnSystem2)
+
+    void Tick(SystemCommands& commands, float timeMS)
+    {
+        for (auto i = 0; i < 100; i++) {
+            commands.Emplace<StructuralChangeTest_Marker>(commands.Create(), StructuralChangeTest_Marker { {}, 2 });
+        }
+    }
+};
+
+struct EClass() ChangeDetectionTest_Context : public State {
+    EStateBody(ChangeDetectionTest_Context)
+
+    uint32_t addedCount;
+    uint32_t changedCount;
+};
+
+struct EClass() ChangeDetectionTest_OrderedResult : public State {
+    EStateBody(ChangeDetectionTest_OrderedResult)
+
+    uint32_t changedCount;
+};
+
+struct EClass() ChangeDetectionTest_Component : public Component {
+    EComponentBody(ChangeDetectionTest_Component)
+
+    int32_t value;
+};
+
+struct EClass() ChangeDetectionTest_WorldSetupSystem : public System {
+    ESetupSystemBody(ChangeDetectionTest_WorldSetupSystem)
+
+    void Setup(SystemCommands& commands)
+    {
+        commands.EmplaceState<ChangeDetectionTest_Context>(ChangeDetectionTest_Context { {}, 0, 0 });
+        commands.EmplaceState<ChangeDetectionTest_OrderedResult>(ChangeDetectionTest_OrderedResult { {}, 0 });
+        for (auto i = 0; i < 10; i++) {
+            commands.Emplace<ChangeDetectionTest_Component>(commands.Create(), ChangeDetectionTest_Component { {}, i });
+        }
+    }
+};
+
+struct EClass() ChangeDetectionTest_CountSystem : public System {
+    ETickSystemBody(ChangeDetectionTest_CountSystem)
+
+    void Tick(SystemCommands& commands, float timeMS)
+    {
+        auto* context = commands.GetState<ChangeDetectionTest_Context>();
+        context->addedCount = 0;
+        context->changedCount = 0;
+        commands.StartQuery<ChangeDetectionTest_Component>(Exclude<> {}, Added<ChangeDetectionTest_Component> {}).Each([&](ChangeDetectionTest_Component&) -> void {
+            context->addedCount++;
+        });
+        commands.StartQuery<ChangeDetectionTest_Component>(Exclude<> {}, Changed<ChangeDetectionTest_Component> {}).Each([&](ChangeDetectionTest_Component&) -> void {
+            context->changedCount++;
+        });
+    }
+};
+
+// count system reads before patch system writes in the same tick, so it only sees patches in next tick
+struct EClass() ChangeDetectionTest_OrderedCountSystem : public System {
+    ETickSystemBody(ChangeDetectionTest_OrderedCountSystem)
+    DeclareSystemReads(ChangeDetectionTest_Component)
+    DeclareSystemWrites(ChangeDetectionTest_OrderedResult)
+
+    void Tick(SystemCommands& commands, float timeMS)
+    {
+        uint32_t changedCount = 0;
+        commands.StartQuery<ChangeDetectionTest_Component>(Exclude<> {}, Changed<ChangeDetectionTest_Component> {}).Each([&](ChangeDetectionTest_Component&) -> void {
+            changedCount++;
+        });
+        commands.PatchState<ChangeDetectionTest_OrderedResult>([changedCount](ChangeDetectionTest_OrderedResult& result) -> void {
+            result.changedCount = changedCount;
+        });
+    }
+};
+
+struct EClass() ChangeDetectionTest_OrderedPatchSystem : public System {
+    ETickSystemBody(ChangeDetectionTest_OrderedPatchSystem)
+    DeclareSystemWrites(ChangeDetectionTest_Component)
+
+    void Tick(SystemCommands& commands, float timeMS)
+    {
+        std::vector<Entity> entities;
+        commands.StartQuery<ChangeDetectionTest_Component>().Each([&](Entity entity, ChangeDetectionTest_Component&) -> void {
+            entities.emplace_back(entity);
+        });
+        for (const auto entity : entities) {
+            commands.Patch<ChangeDetectionTest_Component>(entity, [](ChangeDetectionTest_Component& component) -> void {
+                component.value++;
+            });
+        }
+    }
+};
+
+// patches the components it filters on, its own patches must not be reported to it again in next tick
+struct EClass() ChangeDetectionTest_SelfPatchSystem : public System {
+    ETickSystemBody(ChangeDetectionTest_SelfPatchSystem)
+    DeclareSystemWrites(ChangeDetectionTest_Component, ChangeDetectionTest_OrderedResult)
+
+    void Tick(SystemCommands& commands, float timeMS)
+    {
+        std::vector<Entity> entities;
+        commands.StartQuery<ChangeDetectionTest_Component>(Exclude<> {}, Changed<ChangeDetectionTest_Component> {}).Each([&](Entity entity, ChangeDetectionTest_Component&) -> void {
+            entities.emplace_back(entity);
+        });
+        for (const auto entity : entities) {
+            commands.Patch<ChangeDetectionTest_Component>(entity, [](ChangeDetectionTest_Component& component) -> void {
+                component.value++;
+            });
+        }
+        commands.PatchState<ChangeDetectionTest_OrderedResult>([&](ChangeDetectionTest_OrderedResult& result) -> void {
+            result.changedCount = static_cast<uint32_t>(entities.size());
+        });
+    }
+};
+
+// trivial tick systems for measuring fixed tick overhead of the executor, they declare no access so all of them run in parallel
+#define DeclareTickBenchmarkSystem(index) \
+    struct EClass() TickBenchmark_System##index : public System { \
+        ETickSystemBody(TickBenchmark_System##index) \
+        \
+        void Tick(SystemCommands& commands, float timeMS) {} \
+    }; \
+
+#define DeclareTickBenchmarkSystems(prefix) \
+    DeclareTickBenchmarkSystem(prefix##0) \
+    DeclareTickBenchmarkSystem(prefix##1) \
+    DeclareTickBenchmarkSystem(prefix##2) \
+    DeclareTickBenchmarkSystem(prefix##3) \
+    DeclareTickBenchmarkSystem(prefix##4) \
+    DeclareTickBenchmarkSystem(prefix##5) \
+    DeclareTickBenchmarkSystem(prefix##6) \
+    DeclareTickBenchmarkSystem(prefix##7) \
+    DeclareTickBenchmarkSystem(prefix##8) \
+    DeclareTickBenchmarkSystem(prefix##9) \
+
+#define TickBenchmarkSystems(prefix) \
+    TickBenchmark_System##prefix##0, TickBenchmark_System##prefix##1, TickBenchmark_System##prefix##2, TickBenchmark_System##prefix##3, \
+    TickBenchmark_System##prefix##4, TickBenchmark_System##prefix##5, TickBenchmark_System##prefix##6, TickBenchmark_System##prefix##7, \
+    TickBenchmark_System##prefix##8, TickBenchmark_System##prefix##9
+
+DeclareTickBenchmarkSystems(0)
+DeclareTickBenchmarkSystems(1)
+DeclareTickBenchmarkSystems(2)
+DeclareTickBenchmarkSystems(3)
+DeclareTickBenchmarkSystems(4)
+DeclareTickBenchmarkSystems(5)
+DeclareTickBenchmarkSystems(6)
+DeclareTickBenchmarkSystems(7)
+DeclareTickBenchmarkSystems(8)
+DeclareTickBenchmarkSystems(9)
+
+using TickBenchmark_Package0 = SystemPackage<>;
+using TickBenchmark_Package10 = SystemPackage<SetupSystemPackage<>, TickSystemPackage<TickBenchmarkSystems(0)>>;
+using TickBenchmark_Package100 = SystemPackage<SetupSystemPackage<>, TickSystemPackage<
+    TickBenchmarkSystems(0), TickBenchmarkSystems(1), TickBenchmarkSystems(2), TickBenchmarkSystems(3), TickBenchmarkSystems(4),
+    TickBenchmarkSystems(5), TickBenchmarkSystems(6), TickBenchmarkSystems(7), TickBenchmarkSystems(8), TickBenchmarkSystems(9)>>;
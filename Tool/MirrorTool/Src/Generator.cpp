@@ -40,6 +40,51 @@ namespace MirrorTool {
         return stream.str();
     }
 
+    static uint32_t GetClassLayoutHash(const ClassInfo& clazz)
+    {
+        std::stringstream stream;
+        stream << GetFullName(clazz) << ";" << clazz.baseClassName << ";";
+        for (const auto& variable : clazz.variables) {
+            stream << variable.type << " " << variable.name << ";";
+        }
+        return Common::HashUtils::RuntimeStrCrc32(stream.str());
+    }
+
+    static std::string GetClassSerializerCode(const ClassInfo& clazz)
+    {
+        const std::string fullName = GetFullName(clazz);
+        const std::string layoutHash = fmt::format("0x{:08x}", GetClassLayoutHash(clazz));
+
+        std::stringstream stream;
+        // type id of the generated serializer is computed from the class name the compiler reports, it must be the fully qualified one
+        stream << fmt::format(R"(static_assert(Mirror::Internal::GetQualifiedClassName<{}>() == "{}", "type id of {} must be computed from its fully qualified name");)", fullName, fullName, fullName) << std::endl;
+        stream << std::endl;
+        stream << fmt::format("void {}::_mirrorSerialize(Common::SerializeStream& stream, const {}& value)", fullName, fullName) << std::endl;
+        stream << "{" << std::endl;
+        stream << Tab<1>() << fmt::format("Mirror::Internal::SerializeGeneratedLayout(stream, {});", layoutHash) << std::endl;
+        if (!clazz.baseClassName.empty()) {
+            stream << Tab<1>() << fmt::format("Mirror::Internal::SerializeGeneratedMember<{}>(stream, value);", clazz.baseClassName) << std::endl;
+        }
+        for (const auto& variable : clazz.variables) {
+            stream << Tab<1>() << fmt::format("Mirror::Internal::SerializeGeneratedMember(stream, value.{});", variable.name) << std::endl;
+        }
+        stream << "}" << std::endl;
+        stream << std::endl;
+        stream << fmt::format("bool {}::_mirrorDeserialize(Common::DeserializeStream& stream, {}& value)", fullName, fullName) << std::endl;
+        stream << "{" << std::endl;
+        stream << Tab<1>() << fmt::format("return Mirror::Internal::DeserializeGeneratedLayout(stream, {})", layoutHash);
+        if (!clazz.baseClassName.empty()) {
+            stream << std::endl << Tab<2>() << fmt::format("&& Mirror::Internal::DeserializeGeneratedMember<{}>(stream, value)", clazz.baseClassName);
+        }
+        for (const auto& variable : clazz.variables) {
+            stream << std::endl << Tab<2>() << fmt::format("&& Mirror::Internal::DeserializeGeneratedMember(stream, value.{})", variable.name);
+        }
+        stream << ";" << std::endl;
+        stream << "}" << std::endl;
+        stream << std::endl;
+        return stream.str();
+    }
+
     static std::string GetClassCode(const ClassInfo& clazz)
     {
         const std::string fullName = GetFullName(clazz);
@@ -89,6 +134,7 @@ namespace MirrorTool {
         stream << Tab<1>() << "return clazz;" << std::endl;
         stream << "}" << std::endl;
         stream << std::endl;
+        stream << GetClassSerializerCode(clazz);
 
         for (const auto& internalClass : clazz.classes) {
             stream << GetClassCode(internalClass);
@@ -2,6 +2,9 @@
 // Created by johnk on 2022/12/12.
 //
 
+#include <fstream>
+#include <sstream>
+
 #include <gtest/gtest.h>
 
 #include <MirrorTool/Parser.h>
@@ -152,6 +155,14 @@ TEST(MirrorTest, GeneratorTest)
     Generator generator("../Test/Resource/MirrorToolInput.h", "../Test/Generated/MirrorToolTest.generated.cpp", { "../" }, std::get<MetaInfo>(parseResult.second));
     auto generateResult = generator.Generate();
     ASSERT_EQ(generateResult.first, true);
+
+    std::ifstream file("../Test/Generated/MirrorToolTest.generated.cpp");
+    std::stringstream content;
+    content << file.rdbuf();
+    ASSERT_NE(content.str().find("void C0::_mirrorSerialize(Common::SerializeStream& stream, const C0& value)"), std::string::npos);
+    ASSERT_NE(content.str().find("bool C0::_mirrorDeserialize(Common::DeserializeStream& stream, C0& value)"), std::string::npos);
+    ASSERT_NE(content.str().find("Mirror::Internal::SerializeGeneratedMember(stream, value.v1);"), std::string::npos);
+    ASSERT_NE(content.str().find(R"(static_assert(Mirror::Internal::GetQualifiedClassName<C0>() == "C0")"), std::string::npos);
 }
 
 int main(int argc, char* argv[])